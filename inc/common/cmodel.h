@@ -65,6 +65,16 @@ void        CM_TransformedBoxTrace(trace_t *trace, vec3_t start, vec3_t end,
                                    vec3_t origin, vec3_t angles);
 void        CM_ClipEntity(trace_t *dst, const trace_t *src, struct edict_s *ent);
 
+// running totals of trace work, sampled by the server profiler
+// and only counted while it is enabled
+typedef struct {
+    bool        enabled;
+    unsigned    nodes;      // nodes visited by hull checks
+    unsigned    brushes;    // brushes clipped or tested against
+} cmstats_t;
+
+extern cmstats_t    cm_stats;
+
 // call with topnode set to the headnode, returns with topnode
 // set to the first node that splits the box
 int         CM_BoxLeafs(cm_t *cm, vec3_t mins, vec3_t maxs, mleaf_t **list,
@@ -52,6 +52,7 @@ interface from being ambiguous.
 
 extern cvar_t   *cvar_vars;
 extern int      cvar_modified;
+extern unsigned cvar_serverinfo_changes;    // bumped on any serverinfo change
 
 void Cvar_Init(void);
 
@@ -0,0 +1,55 @@
+/*
+Copyright (C) 2003-2008 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef DEMO_H
+#define DEMO_H
+
+#include "common/zone.h"
+
+// fake demo packet used to reconstruct playback state at the given frame
+typedef struct {
+    int     framenum;
+    int64_t filepos;
+    size_t  msglen;
+    byte    data[1];
+} demosnap_t;
+
+// snapshots sorted by frame number
+typedef struct {
+    demosnap_t  **snaps;
+    int         numsnaps;
+    int         maxsnaps;
+} demosnaps_t;
+
+void Demo_AddSnapshot(demosnaps_t *list, demosnap_t *snap, memtag_t tag);
+demosnap_t *Demo_FindSnapshot(const demosnaps_t *list, int framenum);
+void Demo_FreeSnapshots(demosnaps_t *list);
+
+static inline demosnap_t *Demo_LastSnapshot(const demosnaps_t *list)
+{
+    return list->numsnaps ? list->snaps[list->numsnaps - 1] : NULL;
+}
+
+// sidecar index files store snapshots on disk next to the demo, so that
+// seeking doesn't require demo to be read sequentially first
+#define DEMO_INDEX_EXT  ".idx"
+
+int Demo_LoadIndex(const char *name, qhandle_t demo, demosnaps_t *list, memtag_t tag);
+int Demo_SaveIndex(const char *name, qhandle_t demo, const demosnaps_t *list);
+
+#endif // DEMO_H
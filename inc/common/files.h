@@ -69,11 +69,12 @@ typedef struct file_info_s {
 #define FS_SEARCH_DIRSONLY      0x00001000
 #define FS_SEARCH_MASK          0x00001f00
 
-// bits 8 - 11, flag
+// bits 8 - 12, flag
 #define FS_FLAG_GZIP            0x00000100
 #define FS_FLAG_EXCL            0x00000200
 #define FS_FLAG_TEXT            0x00000400
 #define FS_FLAG_DEFLATE         0x00000800
+#define FS_FLAG_ASYNC           0x00001000  // write from async work thread
 
 #define MAX_LOADFILE            0x4001000   // 64 MiB + some slop
 
@@ -98,6 +99,7 @@ void    FS_Init(void);
 void    FS_Shutdown(void);
 void    FS_Restart(bool total);
 
+int FS_RemoveFile(const char *path);
 #if USE_CLIENT
 int FS_RenameFile(const char *from, const char *to);
 #endif
@@ -139,6 +141,7 @@ int64_t FS_Tell(qhandle_t f);
 int FS_Seek(qhandle_t f, int64_t offset);
 
 int64_t FS_Length(qhandle_t f);
+int FS_GetFileInfo(qhandle_t f, file_info_t *info);
 
 bool FS_WildCmp(const char *filter, const char *string);
 bool FS_ExtCmp(const char *extension, const char *string);
@@ -36,6 +36,9 @@ typedef struct netchan_s {
     bool        fatal_error;
 
     netsrc_t    sock;
+#if USE_SWARM
+    qsocket_t   socket;             // overrides sock if not -1
+#endif
 
     int         dropped;            // between last packet and previous
     unsigned    total_dropped;      // for statistics
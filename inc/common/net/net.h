@@ -208,6 +208,14 @@ void        NET_GetPackets(netsrc_t sock, void (*packet_cb)(void));
 bool        NET_SendPacket(netsrc_t sock, const void *data,
                            size_t len, const netadr_t *to);
 
+#if USE_SWARM
+qsocket_t   NET_OpenSocket(void);
+void        NET_CloseSocket(qsocket_t sock);
+void        NET_GetSocketPackets(qsocket_t sock, void (*packet_cb)(void));
+bool        NET_SendSocketPacket(qsocket_t sock, const void *data,
+                                 size_t len, const netadr_t *to);
+#endif
+
 char        *NET_AdrToString(const netadr_t *a);
 bool        NET_StringToAdr(const char *s, netadr_t *a, int default_port);
 bool        NET_StringPairToAdr(const char *host, const char *port, netadr_t *a);
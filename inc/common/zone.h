@@ -54,6 +54,7 @@ char    *Z_TagCopyString(const char *in, memtag_t tag) q_malloc;
 void    Z_FreeTags(memtag_t tag);
 void    Z_LeakTest(memtag_t tag);
 void    Z_Stats_f(void);
+uint64_t Z_AllocCount(void);
 
 // may return pointer to static memory
 char    *Z_CvarCopyString(const char *in);
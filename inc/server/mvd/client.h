@@ -20,6 +20,8 @@ extern game_export_t    mvd_ge;
 
 extern list_t mvd_gtv_list;
 
+extern cvar_t *mvd_shared_frames;
+
 struct client_s;
 
 void MVD_Register(void);
@@ -71,6 +71,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #define os_ftell(f)         _ftelli64(f)
 #endif
 #define os_fileno(f)        _fileno(f)
+#define os_fsync(fd)        _commit(fd)
 #define os_access(p, m)     _access(p, m)
 #define Q_ISREG(m)          (((m) & _S_IFMT) == _S_IFREG)
 #define Q_ISDIR(m)          (((m) & _S_IFMT) == _S_IFDIR)
@@ -83,6 +84,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #define os_fseek(f, o, w)   fseeko(f, o, w)
 #define os_ftell(f)         ftello(f)
 #define os_fileno(f)        fileno(f)
+#define os_fsync(fd)        fsync(fd)
 #define os_access(p, m)     access(p, m)
 #define Q_ISREG(m)          S_ISREG(m)
 #define Q_ISDIR(m)          S_ISDIR(m)
@@ -135,6 +137,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #define q_unused            __attribute__((unused))
 
+#define q_return_address()  __builtin_return_address(0)
+
 #else /* __GNUC__ */
 
 #define q_printf(f, a)
@@ -150,6 +154,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #define q_gameabi
 
+#define q_return_address()  NULL
+
 #ifdef _WIN32
 #define q_exported          __declspec(dllexport)
 #else
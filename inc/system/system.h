@@ -35,6 +35,7 @@ void    Sys_FreeLibrary(void *handle);
 void    *Sys_GetProcAddress(void *handle, const char *sym);
 
 unsigned    Sys_Milliseconds(void);
+uint64_t    Sys_Microseconds(void);
 void    Sys_Sleep(int msec);
 
 void    Sys_Init(void);
@@ -60,6 +61,7 @@ void    Sys_Error(const char *error, ...) q_noreturn q_printf(1, 2);
 void    Sys_Quit(void) q_noreturn;
 
 void    Sys_ListFiles_r(listfiles_t *list, const char *path, int depth);
+int     Sys_ReplaceFile(const char *from, const char *to);
 
 void    Sys_DebugBreak(void);
 
@@ -67,7 +69,6 @@ void    Sys_DebugBreak(void);
 bool Sys_GetAntiCheatAPI(void);
 #endif
 
-#if USE_CLIENT
 typedef struct asyncwork_s {
     void (*work_cb)(void *);
     void (*done_cb)(void *);
@@ -76,7 +77,10 @@ typedef struct asyncwork_s {
 } asyncwork_t;
 
 void Sys_QueueAsyncWork(asyncwork_t *work);
-#endif
+void Sys_WaitAsyncWork(const int *count);
+
+void Sys_ParallelFor(int numthreads, int count, void (*func)(void *, int), void *arg);
+void Sys_AbortParallelFor(error_type_t code, const char *msg);
 
 extern cvar_t   *sys_basedir;
 extern cvar_t   *sys_libdir;
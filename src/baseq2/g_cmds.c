@@ -338,10 +338,10 @@ void Cmd_Noclip_f(edict_t *ent)
     }
 
     if (ent->movetype == MOVETYPE_NOCLIP) {
-        ent->movetype = MOVETYPE_WALK;
+        G_SetMoveType(ent, MOVETYPE_WALK);
         gi.cprintf(ent, PRINT_HIGH, "noclip OFF\n");
     } else {
-        ent->movetype = MOVETYPE_NOCLIP;
+        G_SetMoveType(ent, MOVETYPE_NOCLIP);
         gi.cprintf(ent, PRINT_HIGH, "noclip ON\n");
     }
 }
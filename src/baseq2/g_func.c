@@ -87,7 +87,7 @@ void Move_Final(edict_t *ent)
     VectorScale(ent->moveinfo.dir, ent->moveinfo.remaining_distance / FRAMETIME, ent->velocity);
 
     ent->think = Move_Done;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void Move_Begin(edict_t *ent)
@@ -101,7 +101,7 @@ void Move_Begin(edict_t *ent)
     VectorScale(ent->moveinfo.dir, ent->moveinfo.speed, ent->velocity);
     frames = floor((ent->moveinfo.remaining_distance / ent->moveinfo.speed) / FRAMETIME);
     ent->moveinfo.remaining_distance -= frames * ent->moveinfo.speed * FRAMETIME;
-    ent->nextthink = level.framenum + frames;
+    G_SetNextThink(ent, level.framenum + frames);
     ent->think = Move_Final;
 }
 
@@ -118,14 +118,14 @@ void Move_Calc(edict_t *ent, vec3_t dest, void(*func)(edict_t*))
         if (level.current_entity == ((ent->flags & FL_TEAMSLAVE) ? ent->teammaster : ent)) {
             Move_Begin(ent);
         } else {
-            ent->nextthink = level.framenum + 1;
+            G_SetNextThink(ent, level.framenum + 1);
             ent->think = Move_Begin;
         }
     } else {
         // accelerative
         ent->moveinfo.current_speed = 0;
         ent->think = Think_AccelMove;
-        ent->nextthink = level.framenum + 1;
+        G_SetNextThink(ent, level.framenum + 1);
     }
 }
 
@@ -157,7 +157,7 @@ void AngleMove_Final(edict_t *ent)
     VectorScale(move, 1.0f / FRAMETIME, ent->avelocity);
 
     ent->think = AngleMove_Done;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void AngleMove_Begin(edict_t *ent)
@@ -190,7 +190,7 @@ void AngleMove_Begin(edict_t *ent)
     VectorScale(destdelta, 1.0f / traveltime, ent->avelocity);
 
     // set nextthink to trigger a think when dest is reached
-    ent->nextthink = level.framenum + frames;
+    G_SetNextThink(ent, level.framenum + frames);
     ent->think = AngleMove_Final;
 }
 
@@ -201,7 +201,7 @@ void AngleMove_Calc(edict_t *ent, void(*func)(edict_t*))
     if (level.current_entity == ((ent->flags & FL_TEAMSLAVE) ? ent->teammaster : ent)) {
         AngleMove_Begin(ent);
     } else {
-        ent->nextthink = level.framenum + 1;
+        G_SetNextThink(ent, level.framenum + 1);
         ent->think = AngleMove_Begin;
     }
 }
@@ -325,7 +325,7 @@ void Think_AccelMove(edict_t *ent)
     }
 
     VectorScale(ent->moveinfo.dir, ent->moveinfo.current_speed * 10, ent->velocity);
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     ent->think = Think_AccelMove;
 }
 
@@ -342,7 +342,7 @@ void plat_hit_top(edict_t *ent)
     ent->moveinfo.state = STATE_TOP;
 
     ent->think = plat_go_down;
-    ent->nextthink = level.framenum + 3 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 3 * BASE_FRAMERATE);
 }
 
 void plat_hit_bottom(edict_t *ent)
@@ -417,7 +417,7 @@ void Touch_Plat_Center(edict_t *ent, edict_t *other, cplane_t *plane, csurface_t
     if (ent->moveinfo.state == STATE_BOTTOM)
         plat_go_up(ent);
     else if (ent->moveinfo.state == STATE_TOP)
-        ent->nextthink = level.framenum + 1 * BASE_FRAMERATE;   // the player is still on the plat, so delay going down
+        G_SetNextThink(ent, level.framenum + 1 * BASE_FRAMERATE);   // the player is still on the plat, so delay going down
 }
 
 void plat_spawn_inside_trigger(edict_t *ent)
@@ -430,7 +430,7 @@ void plat_spawn_inside_trigger(edict_t *ent)
 //
     trigger = G_Spawn();
     trigger->touch = Touch_Plat_Center;
-    trigger->movetype = MOVETYPE_NONE;
+    G_SetMoveType(trigger, MOVETYPE_NONE);
     trigger->solid = SOLID_TRIGGER;
     trigger->enemy = ent;
 
@@ -484,7 +484,7 @@ void SP_func_plat(edict_t *ent)
 {
     VectorClear(ent->s.angles);
     ent->solid = SOLID_BSP;
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
 
     gi.setmodel(ent, ent->model);
 
@@ -588,9 +588,9 @@ void SP_func_rotating(edict_t *ent)
 {
     ent->solid = SOLID_BSP;
     if (ent->spawnflags & 32)
-        ent->movetype = MOVETYPE_STOP;
+        G_SetMoveType(ent, MOVETYPE_STOP);
     else
-        ent->movetype = MOVETYPE_PUSH;
+        G_SetMoveType(ent, MOVETYPE_PUSH);
 
     // set the axis of rotation
     VectorClear(ent->movedir);
@@ -681,7 +681,7 @@ void button_wait(edict_t *self)
     G_UseTargets(self, self->activator);
     self->s.frame = 1;
     if (self->moveinfo.wait >= 0) {
-        self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
         self->think = button_return;
     }
 }
@@ -729,7 +729,7 @@ void SP_func_button(edict_t *ent)
     float   dist;
 
     G_SetMovedir(ent->s.angles, ent->movedir);
-    ent->movetype = MOVETYPE_STOP;
+    G_SetMoveType(ent, MOVETYPE_STOP);
     ent->solid = SOLID_BSP;
     gi.setmodel(ent, ent->model);
 
@@ -838,7 +838,7 @@ void door_hit_top(edict_t *self)
         return;
     if (self->moveinfo.wait >= 0) {
         self->think = door_go_down;
-        self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
     }
 }
 
@@ -880,7 +880,7 @@ void door_go_up(edict_t *self, edict_t *activator)
     if (self->moveinfo.state == STATE_TOP) {
         // reset top wait time
         if (self->moveinfo.wait >= 0)
-            self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+            G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
         return;
     }
 
@@ -1009,7 +1009,7 @@ void Think_SpawnDoorTrigger(edict_t *ent)
     VectorCopy(maxs, other->maxs);
     other->owner = ent;
     other->solid = SOLID_TRIGGER;
-    other->movetype = MOVETYPE_NONE;
+    G_SetMoveType(other, MOVETYPE_NONE);
     other->touch = Touch_DoorTrigger;
     gi.linkentity(other);
 
@@ -1086,7 +1086,7 @@ void SP_func_door(edict_t *ent)
     }
 
     G_SetMovedir(ent->s.angles, ent->movedir);
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
     ent->solid = SOLID_BSP;
     gi.setmodel(ent, ent->model);
 
@@ -1156,7 +1156,7 @@ void SP_func_door(edict_t *ent)
 
     gi.linkentity(ent);
 
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     if (ent->health || ent->targetname)
         ent->think = Think_CalcMoveSpeed;
     else
@@ -1219,7 +1219,7 @@ void SP_func_door_rotating(edict_t *ent)
     VectorMA(ent->s.angles, st.distance, ent->movedir, ent->pos2);
     ent->moveinfo.distance = st.distance;
 
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
     ent->solid = SOLID_BSP;
     gi.setmodel(ent, ent->model);
 
@@ -1282,7 +1282,7 @@ void SP_func_door_rotating(edict_t *ent)
 
     gi.linkentity(ent);
 
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     if (ent->health || ent->targetname)
         ent->think = Think_CalcMoveSpeed;
     else
@@ -1310,7 +1310,7 @@ void SP_func_water(edict_t *self)
     vec3_t  abs_movedir;
 
     G_SetMovedir(self->s.angles, self->movedir);
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
     self->solid = SOLID_BSP;
     gi.setmodel(self, self->model);
 
@@ -1425,13 +1425,13 @@ void train_wait(edict_t *self)
 
     if (self->moveinfo.wait) {
         if (self->moveinfo.wait > 0) {
-            self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+            G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
             self->think = train_next;
         } else if (self->spawnflags & TRAIN_TOGGLE) { // && wait < 0
             train_next(self);
             self->spawnflags &= ~TRAIN_START_ON;
             VectorClear(self->velocity);
-            self->nextthink = 0;
+            G_SetNextThink(self, 0);
         }
 
         if (!(self->flags & FL_TEAMSLAVE)) {
@@ -1535,7 +1535,7 @@ void func_train_find(edict_t *self)
         self->spawnflags |= TRAIN_START_ON;
 
     if (self->spawnflags & TRAIN_START_ON) {
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
         self->think = train_next;
         self->activator = self;
     }
@@ -1550,7 +1550,7 @@ void train_use(edict_t *self, edict_t *other, edict_t *activator)
             return;
         self->spawnflags &= ~TRAIN_START_ON;
         VectorClear(self->velocity);
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
     } else {
         if (self->target_ent)
             train_resume(self);
@@ -1561,7 +1561,7 @@ void train_use(edict_t *self, edict_t *other, edict_t *activator)
 
 void SP_func_train(edict_t *self)
 {
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
 
     VectorClear(self->s.angles);
     self->blocked = train_blocked;
@@ -1590,7 +1590,7 @@ void SP_func_train(edict_t *self)
     if (self->target) {
         // start trains on the second frame, to make sure their targets have had
         // a chance to spawn
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
         self->think = func_train_find;
     } else {
         gi.dprintf("func_train without a target at %s\n", vtos(self->absmin));
@@ -1648,7 +1648,7 @@ void trigger_elevator_init(edict_t *self)
 void SP_trigger_elevator(edict_t *self)
 {
     self->think = trigger_elevator_init;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 
@@ -1669,7 +1669,7 @@ These can used but not touched.
 void func_timer_think(edict_t *self)
 {
     G_UseTargets(self, self->activator);
-    self->nextthink = level.framenum + (self->wait + crandom() * self->random) * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + (self->wait + crandom() * self->random) * BASE_FRAMERATE);
 }
 
 void func_timer_use(edict_t *self, edict_t *other, edict_t *activator)
@@ -1678,13 +1678,13 @@ void func_timer_use(edict_t *self, edict_t *other, edict_t *activator)
 
     // if on, turn it off
     if (self->nextthink) {
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
         return;
     }
 
     // turn it on
     if (self->delay)
-        self->nextthink = level.framenum + self->delay * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + self->delay * BASE_FRAMERATE);
     else
         func_timer_think(self);
 }
@@ -1703,7 +1703,7 @@ void SP_func_timer(edict_t *self)
     }
 
     if (self->spawnflags & 1) {
-        self->nextthink = level.framenum + (1.0f + st.pausetime + self->delay + self->wait + crandom() * self->random) * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + (1.0f + st.pausetime + self->delay + self->wait + crandom() * self->random) * BASE_FRAMERATE);
         self->activator = self;
     }
 
@@ -1786,7 +1786,7 @@ void door_secret_use(edict_t *self, edict_t *other, edict_t *activator)
 
 void door_secret_move1(edict_t *self)
 {
-    self->nextthink = level.framenum + 1.0f * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1.0f * BASE_FRAMERATE);
     self->think = door_secret_move2;
 }
 
@@ -1799,7 +1799,7 @@ void door_secret_move3(edict_t *self)
 {
     if (self->wait == -1)
         return;
-    self->nextthink = level.framenum + self->wait * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + self->wait * BASE_FRAMERATE);
     self->think = door_secret_move4;
 }
 
@@ -1810,7 +1810,7 @@ void door_secret_move4(edict_t *self)
 
 void door_secret_move5(edict_t *self)
 {
-    self->nextthink = level.framenum + 1.0f * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1.0f * BASE_FRAMERATE);
     self->think = door_secret_move6;
 }
 
@@ -1863,7 +1863,7 @@ void SP_func_door_secret(edict_t *ent)
     ent->moveinfo.sound_middle = gi.soundindex("doors/dr1_mid.wav");
     ent->moveinfo.sound_end = gi.soundindex("doors/dr1_end.wav");
 
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
     ent->solid = SOLID_BSP;
     gi.setmodel(ent, ent->model);
 
@@ -143,7 +143,7 @@ void SetRespawn(edict_t *ent, float delay)
     ent->flags |= FL_RESPAWN;
     ent->svflags |= SVF_NOCLIENT;
     ent->solid = SOLID_NOT;
-    ent->nextthink = level.framenum + delay * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + delay * BASE_FRAMERATE);
     ent->think = DoRespawn;
     gi.linkentity(ent);
 }
@@ -518,7 +518,7 @@ void Drop_Ammo(edict_t *ent, gitem_t *item)
 void MegaHealth_think(edict_t *self)
 {
     if (self->owner->health > self->owner->max_health) {
-        self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
         self->owner->health -= 1;
         return;
     }
@@ -544,7 +544,7 @@ bool Pickup_Health(edict_t *ent, edict_t *other)
 
     if (ent->style & HEALTH_TIMED) {
         ent->think = MegaHealth_think;
-        ent->nextthink = level.framenum + 5 * BASE_FRAMERATE;
+        G_SetNextThink(ent, level.framenum + 5 * BASE_FRAMERATE);
         ent->owner = other;
         ent->flags |= FL_RESPAWN;
         ent->svflags |= SVF_NOCLIENT;
@@ -789,7 +789,7 @@ void drop_make_touchable(edict_t *ent)
 {
     ent->touch = Touch_Item;
     if (deathmatch->value) {
-        ent->nextthink = level.framenum + 29 * BASE_FRAMERATE;
+        G_SetNextThink(ent, level.framenum + 29 * BASE_FRAMERATE);
         ent->think = G_FreeEdict;
     }
 }
@@ -811,7 +811,7 @@ edict_t *Drop_Item(edict_t *ent, gitem_t *item)
     VectorSet(dropped->maxs, 15, 15, 15);
     gi.setmodel(dropped, dropped->item->world_model);
     dropped->solid = SOLID_TRIGGER;
-    dropped->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(dropped, MOVETYPE_TOSS);
     dropped->touch = drop_temp_touch;
     dropped->owner = ent;
 
@@ -833,7 +833,7 @@ edict_t *Drop_Item(edict_t *ent, gitem_t *item)
     dropped->velocity[2] = 300;
 
     dropped->think = drop_make_touchable;
-    dropped->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+    G_SetNextThink(dropped, level.framenum + 1 * BASE_FRAMERATE);
 
     gi.linkentity(dropped);
 
@@ -879,7 +879,7 @@ void droptofloor(edict_t *ent)
     else
         gi.setmodel(ent, ent->item->world_model);
     ent->solid = SOLID_TRIGGER;
-    ent->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(ent, MOVETYPE_TOSS);
     ent->touch = Touch_Item;
 
     v = tv(0, 0, -128);
@@ -902,7 +902,7 @@ void droptofloor(edict_t *ent)
         ent->svflags |= SVF_NOCLIENT;
         ent->solid = SOLID_NOT;
         if (ent == ent->teammaster) {
-            ent->nextthink = level.framenum + 1;
+            G_SetNextThink(ent, level.framenum + 1);
             ent->think = DoRespawn;
         }
     }
@@ -1049,7 +1049,7 @@ void SpawnItem(edict_t *ent, gitem_t *item)
     }
 
     ent->item = item;
-    ent->nextthink = level.framenum + 2;    // items start after other solids
+    G_SetNextThink(ent, level.framenum + 2);    // items start after other solids
     ent->think = droptofloor;
     ent->s.effects = item->world_model_flags;
     ent->s.renderfx = RF_GLOW;
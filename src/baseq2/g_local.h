@@ -787,6 +787,13 @@ void M_ChangeYaw(edict_t *ent);
 // g_phys.c
 //
 void G_RunEntity(edict_t *ent);
+void G_SetNextThink(edict_t *ent, int framenum);
+void G_SetMoveType(edict_t *ent, int movetype);
+void G_ActivateEntity(edict_t *ent);
+void G_ResetThinkSchedule(void);
+void G_BeginThinkFrame(void);
+int G_NextRunnable(int entnum);
+void G_EndEntityFrame(edict_t *ent);
 
 //
 // g_main.c
@@ -484,10 +484,13 @@ void G_RunFrame(void)
     // treat each object in turn
     // even the world gets a chance to think
     //
-    ent = &g_edicts[0];
-    for (i = 0 ; i < globals.num_edicts ; i++, ent++) {
-        if (!ent->inuse)
+    G_BeginThinkFrame();
+    for (i = G_NextRunnable(-1) ; i != -1 ; i = G_NextRunnable(i)) {
+        ent = &g_edicts[i];
+        if (!ent->inuse) {
+            G_EndEntityFrame(ent);
             continue;
+        }
 
         level.current_entity = ent;
 
@@ -507,6 +510,7 @@ void G_RunFrame(void)
         }
 
         G_RunEntity(ent);
+        G_EndEntityFrame(ent);
     }
 
     // see if it is time to end a deathmatch
@@ -90,11 +90,11 @@ gibs
 void gib_think(edict_t *self)
 {
     self->s.frame++;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     if (self->s.frame == 10) {
         self->think = G_FreeEdict;
-        self->nextthink = level.framenum + (8 + random() * 10) * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + (8 + random() * 10) * BASE_FRAMERATE);
     }
 }
 
@@ -117,7 +117,7 @@ void gib_touch(edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf)
         if (self->s.modelindex == sm_meat_index) {
             self->s.frame++;
             self->think = gib_think;
-            self->nextthink = level.framenum + 1;
+            G_SetNextThink(self, level.framenum + 1);
         }
     }
 }
@@ -151,11 +151,11 @@ void ThrowGib(edict_t *self, char *gibname, int damage, int type)
     gib->die = gib_die;
 
     if (type == GIB_ORGANIC) {
-        gib->movetype = MOVETYPE_TOSS;
+        G_SetMoveType(gib, MOVETYPE_TOSS);
         gib->touch = gib_touch;
         vscale = 0.5f;
     } else {
-        gib->movetype = MOVETYPE_BOUNCE;
+        G_SetMoveType(gib, MOVETYPE_BOUNCE);
         vscale = 1.0f;
     }
 
@@ -167,7 +167,7 @@ void ThrowGib(edict_t *self, char *gibname, int damage, int type)
     gib->avelocity[2] = random() * 600;
 
     gib->think = G_FreeEdict;
-    gib->nextthink = level.framenum + (10 + random() * 10) * BASE_FRAMERATE;
+    G_SetNextThink(gib, level.framenum + (10 + random() * 10) * BASE_FRAMERATE);
 
     gi.linkentity(gib);
 }
@@ -194,11 +194,11 @@ void ThrowHead(edict_t *self, char *gibname, int damage, int type)
     self->die = gib_die;
 
     if (type == GIB_ORGANIC) {
-        self->movetype = MOVETYPE_TOSS;
+        G_SetMoveType(self, MOVETYPE_TOSS);
         self->touch = gib_touch;
         vscale = 0.5f;
     } else {
-        self->movetype = MOVETYPE_BOUNCE;
+        G_SetMoveType(self, MOVETYPE_BOUNCE);
         vscale = 1.0f;
     }
 
@@ -209,7 +209,7 @@ void ThrowHead(edict_t *self, char *gibname, int damage, int type)
     self->avelocity[YAW] = crandom() * 600;
 
     self->think = G_FreeEdict;
-    self->nextthink = level.framenum + (10 + random() * 10) * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + (10 + random() * 10) * BASE_FRAMERATE);
 
     gi.linkentity(self);
 }
@@ -240,7 +240,7 @@ void ThrowClientHead(edict_t *self, int damage)
     self->s.sound = 0;
     self->flags |= FL_NO_KNOCKBACK;
 
-    self->movetype = MOVETYPE_BOUNCE;
+    G_SetMoveType(self, MOVETYPE_BOUNCE);
     VelocityForDamage(damage, vd);
     VectorAdd(self->velocity, vd, self->velocity);
 
@@ -249,7 +249,7 @@ void ThrowClientHead(edict_t *self, int damage)
         self->client->anim_end = self->s.frame;
     } else {
         self->think = NULL;
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
     }
 
     gi.linkentity(self);
@@ -278,13 +278,13 @@ void ThrowDebris(edict_t *self, char *modelname, float speed, vec3_t origin)
     v[1] = 100 * crandom();
     v[2] = 100 + 100 * crandom();
     VectorMA(self->velocity, speed, v, chunk->velocity);
-    chunk->movetype = MOVETYPE_BOUNCE;
+    G_SetMoveType(chunk, MOVETYPE_BOUNCE);
     chunk->solid = SOLID_NOT;
     chunk->avelocity[0] = random() * 600;
     chunk->avelocity[1] = random() * 600;
     chunk->avelocity[2] = random() * 600;
     chunk->think = G_FreeEdict;
-    chunk->nextthink = level.framenum + (5 + random() * 5) * BASE_FRAMERATE;
+    G_SetNextThink(chunk, level.framenum + (5 + random() * 5) * BASE_FRAMERATE);
     chunk->s.frame = 0;
     chunk->flags = 0;
     chunk->classname = "debris";
@@ -462,21 +462,21 @@ Just for the debugging level.  Don't use
 void TH_viewthing(edict_t *ent)
 {
     ent->s.frame = (ent->s.frame + 1) % 7;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void SP_viewthing(edict_t *ent)
 {
     gi.dprintf("viewthing spawned\n");
 
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     ent->s.renderfx = RF_FRAMELERP;
     VectorSet(ent->mins, -16, -16, -24);
     VectorSet(ent->maxs, 16, 16, 32);
     ent->s.modelindex = gi.modelindex("models/objects/banner/tris.md2");
     gi.linkentity(ent);
-    ent->nextthink = level.framenum + 0.5f * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 0.5f * BASE_FRAMERATE);
     ent->think = TH_viewthing;
     return;
 }
@@ -572,7 +572,7 @@ void func_wall_use(edict_t *self, edict_t *other, edict_t *activator)
 
 void SP_func_wall(edict_t *self)
 {
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
     gi.setmodel(self, self->model);
 
     if (self->spawnflags & 8)
@@ -630,7 +630,7 @@ void func_object_touch(edict_t *self, edict_t *other, cplane_t *plane, csurface_
 
 void func_object_release(edict_t *self)
 {
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->touch = func_object_touch;
 }
 
@@ -659,12 +659,12 @@ void SP_func_object(edict_t *self)
 
     if (self->spawnflags == 0) {
         self->solid = SOLID_BSP;
-        self->movetype = MOVETYPE_PUSH;
+        G_SetMoveType(self, MOVETYPE_PUSH);
         self->think = func_object_release;
-        self->nextthink = level.framenum + 2;
+        G_SetNextThink(self, level.framenum + 2);
     } else {
         self->solid = SOLID_NOT;
-        self->movetype = MOVETYPE_PUSH;
+        G_SetMoveType(self, MOVETYPE_PUSH);
         self->use = func_object_use;
         self->svflags |= SVF_NOCLIENT;
     }
@@ -776,7 +776,7 @@ void SP_func_explosive(edict_t *self)
         return;
     }
 
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
 
     gi.modelindex("models/objects/debris1/tris.md2");
     gi.modelindex("models/objects/debris2/tris.md2");
@@ -910,7 +910,7 @@ void barrel_explode(edict_t *self)
 void barrel_delay(edict_t *self, edict_t *inflictor, edict_t *attacker, int damage, vec3_t point)
 {
     self->takedamage = DAMAGE_NO;
-    self->nextthink = level.framenum + 2;
+    G_SetNextThink(self, level.framenum + 2);
     self->think = barrel_explode;
     self->activator = attacker;
 }
@@ -928,7 +928,7 @@ void SP_misc_explobox(edict_t *self)
     gi.modelindex("models/objects/debris3/tris.md2");
 
     self->solid = SOLID_BBOX;
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
 
     self->model = "models/objects/barrels/tris.md2";
     self->s.modelindex = gi.modelindex(self->model);
@@ -949,7 +949,7 @@ void SP_misc_explobox(edict_t *self)
     self->touch = barrel_touch;
 
     self->think = M_droptofloor;
-    self->nextthink = level.framenum + 2;
+    G_SetNextThink(self, level.framenum + 2);
 
     gi.linkentity(self);
 }
@@ -976,16 +976,16 @@ void misc_blackhole_use(edict_t *ent, edict_t *other, edict_t *activator)
 void misc_blackhole_think(edict_t *self)
 {
     if (++self->s.frame < 19)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 0;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
 void SP_misc_blackhole(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_NOT;
     VectorSet(ent->mins, -64, -64, 0);
     VectorSet(ent->maxs, 64, 64, 8);
@@ -993,7 +993,7 @@ void SP_misc_blackhole(edict_t *ent)
     ent->s.renderfx = RF_TRANSLUCENT;
     ent->use = misc_blackhole_use;
     ent->think = misc_blackhole_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -1003,23 +1003,23 @@ void SP_misc_blackhole(edict_t *ent)
 void misc_eastertank_think(edict_t *self)
 {
     if (++self->s.frame < 293)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 254;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
 void SP_misc_eastertank(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     VectorSet(ent->mins, -32, -32, -16);
     VectorSet(ent->maxs, 32, 32, 32);
     ent->s.modelindex = gi.modelindex("models/monsters/tank/tris.md2");
     ent->s.frame = 254;
     ent->think = misc_eastertank_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -1030,23 +1030,23 @@ void SP_misc_eastertank(edict_t *ent)
 void misc_easterchick_think(edict_t *self)
 {
     if (++self->s.frame < 247)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 208;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
 void SP_misc_easterchick(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     VectorSet(ent->mins, -32, -32, 0);
     VectorSet(ent->maxs, 32, 32, 32);
     ent->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
     ent->s.frame = 208;
     ent->think = misc_easterchick_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -1057,23 +1057,23 @@ void SP_misc_easterchick(edict_t *ent)
 void misc_easterchick2_think(edict_t *self)
 {
     if (++self->s.frame < 287)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 248;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
 void SP_misc_easterchick2(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     VectorSet(ent->mins, -32, -32, 0);
     VectorSet(ent->maxs, 32, 32, 32);
     ent->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
     ent->s.frame = 248;
     ent->think = misc_easterchick2_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -1086,9 +1086,9 @@ There should be a item_commander_head that has this as it's target.
 void commander_body_think(edict_t *self)
 {
     if (++self->s.frame < 24)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
 
     if (self->s.frame == 22)
         gi.sound(self, CHAN_BODY, gi.soundindex("tank/thud.wav"), 1, ATTN_NORM, 0);
@@ -1097,19 +1097,19 @@ void commander_body_think(edict_t *self)
 void commander_body_use(edict_t *self, edict_t *other, edict_t *activator)
 {
     self->think = commander_body_think;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     gi.sound(self, CHAN_BODY, gi.soundindex("tank/pain.wav"), 1, ATTN_NORM, 0);
 }
 
 void commander_body_drop(edict_t *self)
 {
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->s.origin[2] += 2;
 }
 
 void SP_monster_commander_body(edict_t *self)
 {
-    self->movetype = MOVETYPE_NONE;
+    G_SetMoveType(self, MOVETYPE_NONE);
     self->solid = SOLID_BBOX;
     self->model = "models/monsters/commandr/tris.md2";
     self->s.modelindex = gi.modelindex(self->model);
@@ -1125,7 +1125,7 @@ void SP_monster_commander_body(edict_t *self)
     gi.soundindex("tank/pain.wav");
 
     self->think = commander_body_drop;
-    self->nextthink = level.framenum + 5;
+    G_SetNextThink(self, level.framenum + 5);
 }
 
 
@@ -1136,19 +1136,19 @@ The banner is 128 tall.
 void misc_banner_think(edict_t *ent)
 {
     ent->s.frame = (ent->s.frame + 1) % 16;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void SP_misc_banner(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_NOT;
     ent->s.modelindex = gi.modelindex("models/objects/banner/tris.md2");
     ent->s.frame = Q_rand() % 16;
     gi.linkentity(ent);
 
     ent->think = misc_banner_think;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 /*QUAKED misc_deadsoldier (1 .5 0) (-16 -16 0) (16 16 16) ON_BACK ON_STOMACH BACK_DECAP FETAL_POS SIT_DECAP IMPALED
@@ -1175,7 +1175,7 @@ void SP_misc_deadsoldier(edict_t *ent)
         return;
     }
 
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     ent->s.modelindex = gi.modelindex("models/deadbods/dude/tris.md2");
 
@@ -1233,14 +1233,14 @@ void SP_misc_viper(edict_t *ent)
     if (!ent->speed)
         ent->speed = 300;
 
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
     ent->solid = SOLID_NOT;
     ent->s.modelindex = gi.modelindex("models/ships/viper/tris.md2");
     VectorSet(ent->mins, -16, -16, 0);
     VectorSet(ent->maxs, 16, 16, 32);
 
     ent->think = func_train_find;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     ent->use = misc_viper_use;
     ent->svflags |= SVF_NOCLIENT;
     ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed = ent->speed;
@@ -1254,7 +1254,7 @@ This is a large stationary viper as seen in Paul's intro
 */
 void SP_misc_bigviper(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     VectorSet(ent->mins, -176, -120, -24);
     VectorSet(ent->maxs, 176, 120, 72);
@@ -1302,7 +1302,7 @@ void misc_viper_bomb_use(edict_t *self, edict_t *other, edict_t *activator)
     self->svflags &= ~SVF_NOCLIENT;
     self->s.effects |= EF_ROCKET;
     self->use = NULL;
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->prethink = misc_viper_bomb_prethink;
     self->touch = misc_viper_bomb_touch;
     self->activator = activator;
@@ -1316,7 +1316,7 @@ void misc_viper_bomb_use(edict_t *self, edict_t *other, edict_t *activator)
 
 void SP_misc_viper_bomb(edict_t *self)
 {
-    self->movetype = MOVETYPE_NONE;
+    G_SetMoveType(self, MOVETYPE_NONE);
     self->solid = SOLID_NOT;
     VectorSet(self->mins, -8, -8, -8);
     VectorSet(self->maxs, 8, 8, 8);
@@ -1362,14 +1362,14 @@ void SP_misc_strogg_ship(edict_t *ent)
     if (!ent->speed)
         ent->speed = 300;
 
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
     ent->solid = SOLID_NOT;
     ent->s.modelindex = gi.modelindex("models/ships/strogg1/tris.md2");
     VectorSet(ent->mins, -16, -16, 0);
     VectorSet(ent->maxs, 16, 16, 32);
 
     ent->think = func_train_find;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     ent->use = misc_strogg_ship_use;
     ent->svflags |= SVF_NOCLIENT;
     ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed = ent->speed;
@@ -1384,19 +1384,19 @@ void misc_satellite_dish_think(edict_t *self)
 {
     self->s.frame++;
     if (self->s.frame < 38)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
 }
 
 void misc_satellite_dish_use(edict_t *self, edict_t *other, edict_t *activator)
 {
     self->s.frame = 0;
     self->think = misc_satellite_dish_think;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 void SP_misc_satellite_dish(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     VectorSet(ent->mins, -64, -64, 0);
     VectorSet(ent->maxs, 64, 64, 128);
@@ -1410,7 +1410,7 @@ void SP_misc_satellite_dish(edict_t *ent)
 */
 void SP_light_mine1(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     ent->s.modelindex = gi.modelindex("models/objects/minelite/light1/tris.md2");
     gi.linkentity(ent);
@@ -1421,7 +1421,7 @@ void SP_light_mine1(edict_t *ent)
 */
 void SP_light_mine2(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_BBOX;
     ent->s.modelindex = gi.modelindex("models/objects/minelite/light2/tris.md2");
     gi.linkentity(ent);
@@ -1438,14 +1438,14 @@ void SP_misc_gib_arm(edict_t *ent)
     ent->s.effects |= EF_GIB;
     ent->takedamage = DAMAGE_YES;
     ent->die = gib_die;
-    ent->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(ent, MOVETYPE_TOSS);
     ent->svflags |= SVF_MONSTER;
     ent->deadflag = DEAD_DEAD;
     ent->avelocity[0] = random() * 200;
     ent->avelocity[1] = random() * 200;
     ent->avelocity[2] = random() * 200;
     ent->think = G_FreeEdict;
-    ent->nextthink = level.framenum + 30 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 30 * BASE_FRAMERATE);
     gi.linkentity(ent);
 }
 
@@ -1459,14 +1459,14 @@ void SP_misc_gib_leg(edict_t *ent)
     ent->s.effects |= EF_GIB;
     ent->takedamage = DAMAGE_YES;
     ent->die = gib_die;
-    ent->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(ent, MOVETYPE_TOSS);
     ent->svflags |= SVF_MONSTER;
     ent->deadflag = DEAD_DEAD;
     ent->avelocity[0] = random() * 200;
     ent->avelocity[1] = random() * 200;
     ent->avelocity[2] = random() * 200;
     ent->think = G_FreeEdict;
-    ent->nextthink = level.framenum + 30 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 30 * BASE_FRAMERATE);
     gi.linkentity(ent);
 }
 
@@ -1480,14 +1480,14 @@ void SP_misc_gib_head(edict_t *ent)
     ent->s.effects |= EF_GIB;
     ent->takedamage = DAMAGE_YES;
     ent->die = gib_die;
-    ent->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(ent, MOVETYPE_TOSS);
     ent->svflags |= SVF_MONSTER;
     ent->deadflag = DEAD_DEAD;
     ent->avelocity[0] = random() * 200;
     ent->avelocity[1] = random() * 200;
     ent->avelocity[2] = random() * 200;
     ent->think = G_FreeEdict;
-    ent->nextthink = level.framenum + 30 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 30 * BASE_FRAMERATE);
     gi.linkentity(ent);
 }
 
@@ -1500,7 +1500,7 @@ used with target_string (must be on same "team")
 
 void SP_target_character(edict_t *self)
 {
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
     gi.setmodel(self, self->model);
     self->solid = SOLID_BSP;
     self->s.frame = 12;
@@ -1654,7 +1654,7 @@ void func_clock_think(edict_t *self)
             return;
     }
 
-    self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
 }
 
 void func_clock_use(edict_t *self, edict_t *other, edict_t *activator)
@@ -1693,7 +1693,7 @@ void SP_func_clock(edict_t *self)
     if (self->spawnflags & 4)
         self->use = func_clock_use;
     else
-        self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
 }
 
 //=================================================================================
@@ -115,7 +115,7 @@ void M_FliesOn(edict_t *self)
     self->s.effects |= EF_FLIES;
     self->s.sound = gi.soundindex("infantry/inflies1.wav");
     self->think = M_FliesOff;
-    self->nextthink = level.framenum + 60 * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 60 * BASE_FRAMERATE);
 }
 
 void M_FlyCheck(edict_t *self)
@@ -127,7 +127,7 @@ void M_FlyCheck(edict_t *self)
         return;
 
     self->think = M_FliesOn;
-    self->nextthink = level.framenum + (5 + 10 * random()) * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + (5 + 10 * random()) * BASE_FRAMERATE);
 }
 
 void AttackFinished(edict_t *self, float time)
@@ -335,7 +335,7 @@ void M_MoveFrame(edict_t *self)
     int     index;
 
     move = self->monsterinfo.currentmove;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     if ((self->monsterinfo.nextframe) && (self->monsterinfo.nextframe >= move->firstframe) && (self->monsterinfo.nextframe <= move->lastframe)) {
         self->s.frame = self->monsterinfo.nextframe;
@@ -425,7 +425,7 @@ void monster_triggered_spawn(edict_t *self)
     KillBox(self);
 
     self->solid = SOLID_BBOX;
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->svflags &= ~SVF_NOCLIENT;
     self->air_finished_framenum = level.framenum + 12 * BASE_FRAMERATE;
     gi.linkentity(self);
@@ -443,7 +443,7 @@ void monster_triggered_spawn_use(edict_t *self, edict_t *other, edict_t *activat
 {
     // we have a one frame delay here so we don't telefrag the guy who activated us
     self->think = monster_triggered_spawn;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     if (activator->client)
         self->enemy = activator;
     self->use = monster_use;
@@ -452,9 +452,9 @@ void monster_triggered_spawn_use(edict_t *self, edict_t *other, edict_t *activat
 void monster_triggered_start(edict_t *self)
 {
     self->solid = SOLID_NOT;
-    self->movetype = MOVETYPE_NONE;
+    G_SetMoveType(self, MOVETYPE_NONE);
     self->svflags |= SVF_NOCLIENT;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     self->use = monster_triggered_spawn_use;
 }
 
@@ -505,7 +505,7 @@ bool monster_start(edict_t *self)
     if (!(self->monsterinfo.aiflags & AI_GOOD_GUY))
         level.total_monsters++;
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->svflags |= SVF_MONSTER;
     self->s.renderfx |= RF_FRAMELERP;
     self->takedamage = DAMAGE_AIM;
@@ -603,7 +603,7 @@ void monster_start_go(edict_t *self)
     }
 
     self->think = monster_think;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 
@@ -930,3 +930,275 @@ void G_RunEntity(edict_t *ent)
         gi.error("SV_Physics: bad movetype %i", (int)ent->movetype);
     }
 }
+
+/*
+===============================================================================
+
+THINK SCHEDULER
+
+Entities that never move (MOVETYPE_NONE), have no prethink function and no
+ground entity only need to be visited when their nextthink has arrived. They
+are kept in a min-heap keyed by nextthink instead of being checked every frame.
+All other in-use entities are kept in a dense bitmap and are run every frame.
+
+Both sets are walked together in entity number order, so entities are run in
+exactly the same order as before. Code that changes nextthink or movetype
+must go through G_SetNextThink and G_SetMoveType to keep schedule up to date.
+
+===============================================================================
+*/
+
+#define THINK_HEAP_SIZE     (MAX_EDICTS * 2)
+#define THINK_BITS_WORDS    (MAX_EDICTS / 32)
+
+typedef struct {
+    int     framenum;
+    int     entnum;
+} thinkevent_t;
+
+static thinkevent_t think_heap[THINK_HEAP_SIZE];
+static int          think_heap_count;
+static int          think_heap_time[MAX_EDICTS];   // framenum of live heap entry, 0 if none
+static uint32_t     think_active[THINK_BITS_WORDS]; // run every frame
+static uint32_t     think_due[THINK_BITS_WORDS];    // nextthink has arrived
+static bool         think_valid;
+
+#define ThinkBitSet(b, n)   ((b)[(n) >> 5] |= 1U << ((n) & 31))
+#define ThinkBitClear(b, n) ((b)[(n) >> 5] &= ~(1U << ((n) & 31)))
+
+static bool think_event_less(const thinkevent_t *a, const thinkevent_t *b)
+{
+    if (a->framenum != b->framenum)
+        return a->framenum < b->framenum;
+    return a->entnum < b->entnum;
+}
+
+static void think_heap_push(int framenum, int entnum)
+{
+    thinkevent_t ev = { framenum, entnum };
+    int i, parent;
+
+    for (i = think_heap_count++; i > 0; i = parent) {
+        parent = (i - 1) / 2;
+        if (!think_event_less(&ev, &think_heap[parent]))
+            break;
+        think_heap[i] = think_heap[parent];
+    }
+
+    think_heap[i] = ev;
+}
+
+static thinkevent_t think_heap_pop(void)
+{
+    thinkevent_t top = think_heap[0];
+    thinkevent_t last = think_heap[--think_heap_count];
+    int i, child;
+
+    for (i = 0; (child = i * 2 + 1) < think_heap_count; i = child) {
+        if (child + 1 < think_heap_count && think_event_less(&think_heap[child + 1], &think_heap[child]))
+            child++;
+        if (!think_event_less(&think_heap[child], &last))
+            break;
+        think_heap[i] = think_heap[child];
+    }
+
+    think_heap[i] = last;
+    return top;
+}
+
+static bool G_IsIdleEntity(edict_t *ent)
+{
+    int entnum = ent - g_edicts;
+
+    if (entnum > 0 && entnum <= game.maxclients)
+        return false;
+
+    return ent->movetype == MOVETYPE_NONE && !ent->prethink && !ent->groundentity;
+}
+
+static void G_ScheduleThink(edict_t *ent)
+{
+    int entnum = ent - g_edicts;
+    int framenum = ent->nextthink;
+
+    if (!think_valid || framenum <= 0)
+        return;
+
+    // active entities check nextthink themselves
+    if (think_active[entnum >> 5] & (1U << (entnum & 31)))
+        return;
+
+    // already due, will be picked up by G_NextRunnable
+    if (framenum <= level.framenum) {
+        ThinkBitSet(think_due, entnum);
+        return;
+    }
+
+    // earlier heap entry will reschedule when it fires
+    if (think_heap_time[entnum] && think_heap_time[entnum] <= framenum)
+        return;
+
+    // too many stale entries, rebuild from scratch
+    if (think_heap_count == THINK_HEAP_SIZE) {
+        think_valid = false;
+        return;
+    }
+
+    think_heap_push(framenum, entnum);
+    think_heap_time[entnum] = framenum;
+}
+
+/*
+=============
+G_SetNextThink
+=============
+*/
+void G_SetNextThink(edict_t *ent, int framenum)
+{
+    ent->nextthink = framenum;
+    G_ScheduleThink(ent);
+}
+
+/*
+=============
+G_SetMoveType
+=============
+*/
+void G_SetMoveType(edict_t *ent, int movetype)
+{
+    ent->movetype = movetype;
+    G_ActivateEntity(ent);
+}
+
+/*
+=============
+G_ActivateEntity
+
+Makes entity to be run at least once more, after which it is reclassified.
+=============
+*/
+void G_ActivateEntity(edict_t *ent)
+{
+    ThinkBitSet(think_active, ent - g_edicts);
+}
+
+/*
+=============
+G_ResetThinkSchedule
+
+Called when entities are (re)loaded behind our back.
+=============
+*/
+void G_ResetThinkSchedule(void)
+{
+    think_valid = false;
+}
+
+static void G_RebuildThinkSchedule(void)
+{
+    edict_t *ent;
+    int i;
+
+    think_heap_count = 0;
+    memset(think_heap_time, 0, sizeof(think_heap_time));
+    memset(think_active, 0, sizeof(think_active));
+    memset(think_due, 0, sizeof(think_due));
+    think_valid = true;
+
+    for (i = 0, ent = g_edicts; i < globals.num_edicts; i++, ent++) {
+        if (G_IsIdleEntity(ent)) {
+            if (ent->inuse)
+                G_ScheduleThink(ent);
+        } else if (ent->inuse || i <= game.maxclients) {
+            ThinkBitSet(think_active, i);
+        }
+    }
+}
+
+/*
+=============
+G_BeginThinkFrame
+
+Moves entities whose nextthink has arrived from heap into due set.
+=============
+*/
+void G_BeginThinkFrame(void)
+{
+    thinkevent_t ev;
+    edict_t *ent;
+
+    if (!think_valid)
+        G_RebuildThinkSchedule();
+
+    while (think_heap_count && think_heap[0].framenum <= level.framenum) {
+        ev = think_heap_pop();
+        if (think_heap_time[ev.entnum] != ev.framenum)
+            continue;   // superseded by earlier entry
+        think_heap_time[ev.entnum] = 0;
+
+        ent = &g_edicts[ev.entnum];
+        if (ent->inuse)
+            G_ScheduleThink(ent);
+    }
+}
+
+/*
+=============
+G_NextRunnable
+
+Returns number of the next entity after `entnum' that needs to be run this
+frame, or -1 if there are no more. Entities activated during the frame with
+numbers greater than current are picked up, just like a full scan would.
+=============
+*/
+int G_NextRunnable(int entnum)
+{
+    uint32_t bits;
+    int i, w;
+
+    for (i = entnum + 1; i < globals.num_edicts; i = (w + 1) << 5) {
+        w = i >> 5;
+        bits = (think_active[w] | think_due[w]) >> (i & 31);
+        if (!bits)
+            continue;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            i++;
+        }
+        return i < globals.num_edicts ? i : -1;
+    }
+
+    return -1;
+}
+
+/*
+=============
+G_EndEntityFrame
+
+Reclassifies entity after it has been run. Idle entity that was moved this
+frame, e.g. by its think function, is run once more so that G_RunFrame
+updates old_origin at the start of next frame, just like it did when all
+entities were visited every frame.
+=============
+*/
+void G_EndEntityFrame(edict_t *ent)
+{
+    int entnum = ent - g_edicts;
+
+    ThinkBitClear(think_due, entnum);
+
+    // client slots are always checked, server may put them in use
+    if (entnum > 0 && entnum <= game.maxclients)
+        return;
+
+    ThinkBitClear(think_active, entnum);
+
+    if (!ent->inuse)
+        return;
+
+    if (G_IsIdleEntity(ent) && ((ent->s.renderfx & RF_BEAM) ||
+                                VectorCompare(ent->s.origin, ent->s.old_origin)))
+        G_ScheduleThink(ent);
+    else
+        ThinkBitSet(think_active, entnum);
+}
@@ -950,6 +950,7 @@ void ReadLevel(const char *filename)
     // wipe all the entities
     memset(g_edicts, 0, game.maxentities * sizeof(g_edicts[0]));
     globals.num_edicts = maxclients->value + 1;
+    G_ResetThinkSchedule();
 
     i = read_int(f);
     if (i != SAVE_MAGIC2) {
@@ -1007,7 +1008,7 @@ void ReadLevel(const char *filename)
         // fire any cross-level triggers
         if (ent->classname)
             if (strcmp(ent->classname, "target_crosslevel_target") == 0)
-                ent->nextthink = level.framenum + ent->delay * BASE_FRAMERATE;
+                G_SetNextThink(ent, level.framenum + ent->delay * BASE_FRAMERATE);
 
         if (ent->think == func_clock_think || ent->use == func_clock_use) {
             char *msg = ent->message;
@@ -586,6 +586,7 @@ void SpawnEntities(const char *mapname, const char *entities, const char *spawnp
 
     memset(&level, 0, sizeof(level));
     memset(g_edicts, 0, game.maxentities * sizeof(g_edicts[0]));
+    G_ResetThinkSchedule();
 
     Q_strlcpy(level.mapname, mapname, sizeof(level.mapname));
     Q_strlcpy(game.spawnpoint, spawnpoint, sizeof(game.spawnpoint));
@@ -835,7 +836,7 @@ Only used for the world.
 */
 void SP_worldspawn(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(ent, MOVETYPE_PUSH);
     ent->solid = SOLID_BSP;
     ent->inuse = true;          // since the world doesn't use G_Spawn()
     ent->s.modelindex = 1;      // world model is always index 1
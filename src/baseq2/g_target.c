@@ -246,7 +246,7 @@ void use_target_explosion(edict_t *self, edict_t *other, edict_t *activator)
     }
 
     self->think = target_explosion_explode;
-    self->nextthink = level.framenum + self->delay * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + self->delay * BASE_FRAMERATE);
 }
 
 void SP_target_explosion(edict_t *ent)
@@ -472,7 +472,7 @@ void SP_target_crosslevel_target(edict_t *self)
     self->svflags = SVF_NOCLIENT;
 
     self->think = target_crosslevel_target_think;
-    self->nextthink = level.framenum + self->delay * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + self->delay * BASE_FRAMERATE);
 }
 
 //==========================================================
@@ -540,7 +540,7 @@ void target_laser_think(edict_t *self)
 
     VectorCopy(tr.endpos, self->s.old_origin);
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 void target_laser_on(edict_t *self)
@@ -556,7 +556,7 @@ void target_laser_off(edict_t *self)
 {
     self->spawnflags &= ~1;
     self->svflags |= SVF_NOCLIENT;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
 }
 
 void target_laser_use(edict_t *self, edict_t *other, edict_t *activator)
@@ -572,7 +572,7 @@ void target_laser_start(edict_t *self)
 {
     edict_t *ent;
 
-    self->movetype = MOVETYPE_NONE;
+    G_SetMoveType(self, MOVETYPE_NONE);
     self->solid = SOLID_NOT;
     self->s.renderfx |= RF_BEAM | RF_TRANSLUCENT;
     self->s.modelindex = 1;         // must be non-zero
@@ -625,7 +625,7 @@ void SP_target_laser(edict_t *self)
 {
     // let everything else get spawned before we start firing
     self->think = target_laser_start;
-    self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
 }
 
 //==========================================================
@@ -645,7 +645,7 @@ void target_lightramp_think(edict_t *self)
     gi.configstring(CS_LIGHTS + self->enemy->style, style);
 
     if (diff < self->speed) {
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     } else if (self->spawnflags & 1) {
         char    temp;
 
@@ -748,13 +748,13 @@ void target_earthquake_think(edict_t *self)
     }
 
     if (level.framenum < self->timestamp)
-        self->nextthink = level.framenum + 0.1f * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + 0.1f * BASE_FRAMERATE);
 }
 
 void target_earthquake_use(edict_t *self, edict_t *other, edict_t *activator)
 {
     self->timestamp = level.framenum + self->count * BASE_FRAMERATE;
-    self->nextthink = level.framenum + 0.1f * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 0.1f * BASE_FRAMERATE);
     self->activator = activator;
     self->last_move_framenum = 0;
 }
@@ -24,7 +24,7 @@ void InitTrigger(edict_t *self)
         G_SetMovedir(self->s.angles, self->movedir);
 
     self->solid = SOLID_TRIGGER;
-    self->movetype = MOVETYPE_NONE;
+    G_SetMoveType(self, MOVETYPE_NONE);
     gi.setmodel(self, self->model);
     self->svflags = SVF_NOCLIENT;
 }
@@ -33,7 +33,7 @@ void InitTrigger(edict_t *self)
 // the wait time has passed, so set back up for another activation
 void multi_wait(edict_t *ent)
 {
-    ent->nextthink = 0;
+    G_SetNextThink(ent, 0);
 }
 
 
@@ -49,12 +49,12 @@ void multi_trigger(edict_t *ent)
 
     if (ent->wait > 0) {
         ent->think = multi_wait;
-        ent->nextthink = level.framenum + ent->wait * BASE_FRAMERATE;
+        G_SetNextThink(ent, level.framenum + ent->wait * BASE_FRAMERATE);
     } else {
         // we can't just remove (self) here, because this is a touch function
         // called while looping through area links...
         ent->touch = NULL;
-        ent->nextthink = level.framenum + 1;
+        G_SetNextThink(ent, level.framenum + 1);
         ent->think = G_FreeEdict;
     }
 }
@@ -118,7 +118,7 @@ void SP_trigger_multiple(edict_t *ent)
     if (!ent->wait)
         ent->wait = 0.2f;
     ent->touch = Touch_Multi;
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->svflags |= SVF_NOCLIENT;
 
 
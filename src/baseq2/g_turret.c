@@ -150,7 +150,7 @@ void turret_breach_think(edict_t *self)
 
     VectorScale(delta, 1.0f / FRAMETIME, self->avelocity);
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     for (ent = self->teammaster; ent; ent = ent->teamchain)
         ent->avelocity[1] = self->avelocity[1];
@@ -211,7 +211,7 @@ void turret_breach_finish_init(edict_t *self)
 void SP_turret_breach(edict_t *self)
 {
     self->solid = SOLID_BSP;
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
     gi.setmodel(self, self->model);
 
     if (!self->speed)
@@ -237,7 +237,7 @@ void SP_turret_breach(edict_t *self)
     self->blocked = turret_blocked;
 
     self->think = turret_breach_finish_init;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     gi.linkentity(self);
 }
 
@@ -250,7 +250,7 @@ MUST be teamed with a turret_breach.
 void SP_turret_base(edict_t *self)
 {
     self->solid = SOLID_BSP;
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
     gi.setmodel(self, self->model);
     self->blocked = turret_blocked;
     gi.linkentity(self);
@@ -294,7 +294,7 @@ void turret_driver_think(edict_t *self)
     vec3_t  dir;
     int     reaction_time;
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     if (self->enemy && (!self->enemy->inuse || self->enemy->health <= 0))
         self->enemy = NULL;
@@ -341,7 +341,7 @@ void turret_driver_link(edict_t *self)
     edict_t *ent;
 
     self->think = turret_driver_think;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     self->target_ent = G_PickTarget(self->target);
     self->target_ent->owner = self;
@@ -375,7 +375,7 @@ void SP_turret_driver(edict_t *self)
         return;
     }
 
-    self->movetype = MOVETYPE_PUSH;
+    G_SetMoveType(self, MOVETYPE_PUSH);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/infantry/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
@@ -408,7 +408,7 @@ void SP_turret_driver(edict_t *self)
     }
 
     self->think = turret_driver_link;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     gi.linkentity(self);
 }
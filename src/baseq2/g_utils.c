@@ -174,7 +174,7 @@ void G_UseTargets(edict_t *ent, edict_t *activator)
         // create a temp object to fire at a later time
         t = G_Spawn();
         t->classname = "DelayedUse";
-        t->nextthink = level.framenum + ent->delay * BASE_FRAMERATE;
+        G_SetNextThink(t, level.framenum + ent->delay * BASE_FRAMERATE);
         t->think = Think_Delay;
         t->activator = activator;
         if (!activator)
@@ -375,6 +375,7 @@ void G_InitEdict(edict_t *e)
     e->classname = "noclass";
     e->gravity = 1.0f;
     e->s.number = e - g_edicts;
+    G_ActivateEntity(e);
 }
 
 /*
@@ -334,7 +334,7 @@ void fire_blaster(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed
     VectorCopy(start, bolt->s.old_origin);
     vectoangles(dir, bolt->s.angles);
     VectorScale(dir, speed, bolt->velocity);
-    bolt->movetype = MOVETYPE_FLYMISSILE;
+    G_SetMoveType(bolt, MOVETYPE_FLYMISSILE);
     bolt->clipmask = MASK_SHOT;
     bolt->solid = SOLID_BBOX;
     bolt->s.effects |= effect;
@@ -344,7 +344,7 @@ void fire_blaster(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed
     bolt->s.sound = gi.soundindex("misc/lasfly.wav");
     bolt->owner = self;
     bolt->touch = blaster_touch;
-    bolt->nextthink = level.framenum + 2 * BASE_FRAMERATE;
+    G_SetNextThink(bolt, level.framenum + 2 * BASE_FRAMERATE);
     bolt->think = G_FreeEdict;
     bolt->dmg = damage;
     bolt->classname = "bolt";
@@ -465,7 +465,7 @@ void fire_grenade(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int sp
     scale = crandom() * 10.0f;
     VectorMA(grenade->velocity, scale, right, grenade->velocity);
     VectorSet(grenade->avelocity, 300, 300, 300);
-    grenade->movetype = MOVETYPE_BOUNCE;
+    G_SetMoveType(grenade, MOVETYPE_BOUNCE);
     grenade->clipmask = MASK_SHOT;
     grenade->solid = SOLID_BBOX;
     grenade->s.effects |= EF_GRENADE;
@@ -474,7 +474,7 @@ void fire_grenade(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int sp
     grenade->s.modelindex = gi.modelindex("models/objects/grenade/tris.md2");
     grenade->owner = self;
     grenade->touch = Grenade_Touch;
-    grenade->nextthink = level.framenum + timer * BASE_FRAMERATE;
+    G_SetNextThink(grenade, level.framenum + timer * BASE_FRAMERATE);
     grenade->think = Grenade_Explode;
     grenade->dmg = damage;
     grenade->dmg_radius = damage_radius;
@@ -501,7 +501,7 @@ void fire_grenade2(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int s
     scale = crandom() * 10.0f;
     VectorMA(grenade->velocity, scale, right, grenade->velocity);
     VectorSet(grenade->avelocity, 300, 300, 300);
-    grenade->movetype = MOVETYPE_BOUNCE;
+    G_SetMoveType(grenade, MOVETYPE_BOUNCE);
     grenade->clipmask = MASK_SHOT;
     grenade->solid = SOLID_BBOX;
     grenade->s.effects |= EF_GRENADE;
@@ -510,7 +510,7 @@ void fire_grenade2(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int s
     grenade->s.modelindex = gi.modelindex("models/objects/grenade2/tris.md2");
     grenade->owner = self;
     grenade->touch = Grenade_Touch;
-    grenade->nextthink = level.framenum + timer * BASE_FRAMERATE;
+    G_SetNextThink(grenade, level.framenum + timer * BASE_FRAMERATE);
     grenade->think = Grenade_Explode;
     grenade->dmg = damage;
     grenade->dmg_radius = damage_radius;
@@ -589,7 +589,7 @@ void fire_rocket(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed,
     VectorCopy(dir, rocket->movedir);
     vectoangles(dir, rocket->s.angles);
     VectorScale(dir, speed, rocket->velocity);
-    rocket->movetype = MOVETYPE_FLYMISSILE;
+    G_SetMoveType(rocket, MOVETYPE_FLYMISSILE);
     rocket->clipmask = MASK_SHOT;
     rocket->solid = SOLID_BBOX;
     rocket->s.effects |= EF_ROCKET;
@@ -598,7 +598,7 @@ void fire_rocket(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed,
     rocket->s.modelindex = gi.modelindex("models/objects/rocket/tris.md2");
     rocket->owner = self;
     rocket->touch = rocket_touch;
-    rocket->nextthink = level.framenum + BASE_FRAMERATE * 8000 / speed;
+    G_SetNextThink(rocket, level.framenum + BASE_FRAMERATE * 8000 / speed);
     rocket->think = G_FreeEdict;
     rocket->dmg = damage;
     rocket->radius_dmg = radius_damage;
@@ -717,7 +717,7 @@ void bfg_explode(edict_t *self)
         }
     }
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->s.frame++;
     if (self->s.frame == 5)
         self->think = G_FreeEdict;
@@ -751,7 +751,7 @@ void bfg_touch(edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf)
     self->s.sound = 0;
     self->s.effects &= ~EF_ANIM_ALLFAST;
     self->think = bfg_explode;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->enemy = other;
 
     gi.WriteByte(svc_temp_entity);
@@ -832,7 +832,7 @@ void bfg_think(edict_t *self)
         gi.multicast(self->s.origin, MULTICAST_PHS);
     }
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 
@@ -845,7 +845,7 @@ void fire_bfg(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed, fl
     VectorCopy(dir, bfg->movedir);
     vectoangles(dir, bfg->s.angles);
     VectorScale(dir, speed, bfg->velocity);
-    bfg->movetype = MOVETYPE_FLYMISSILE;
+    G_SetMoveType(bfg, MOVETYPE_FLYMISSILE);
     bfg->clipmask = MASK_SHOT;
     bfg->solid = SOLID_BBOX;
     bfg->s.effects |= EF_BFG | EF_ANIM_ALLFAST;
@@ -854,7 +854,7 @@ void fire_bfg(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed, fl
     bfg->s.modelindex = gi.modelindex("sprites/s_bfg1.sp2");
     bfg->owner = self;
     bfg->touch = bfg_touch;
-    bfg->nextthink = level.framenum + BASE_FRAMERATE * 8000 / speed;
+    G_SetNextThink(bfg, level.framenum + BASE_FRAMERATE * 8000 / speed);
     bfg->think = G_FreeEdict;
     bfg->radius_dmg = damage;
     bfg->dmg_radius = damage_radius;
@@ -862,7 +862,7 @@ void fire_bfg(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed, fl
     bfg->s.sound = gi.soundindex("weapons/bfg__l1a.wav");
 
     bfg->think = bfg_think;
-    bfg->nextthink = level.framenum + 1;
+    G_SetNextThink(bfg, level.framenum + 1);
     bfg->teammaster = bfg;
     bfg->teamchain = NULL;
 
@@ -279,9 +279,9 @@ void actor_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -415,7 +415,7 @@ void SP_misc_actor(edict_t *self)
         return;
     }
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("players/male/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
@@ -326,9 +326,9 @@ void berserk_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -414,7 +414,7 @@ void SP_monster_berserk(edict_t *self)
     self->s.modelindex = gi.modelindex("models/monsters/berserk/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, 32);
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
 
     self->health = 240;
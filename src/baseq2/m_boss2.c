@@ -477,9 +477,9 @@ void boss2_dead(edict_t *self)
 {
     VectorSet(self->mins, -56, -56, 0);
     VectorSet(self->maxs, 56, 56, 80);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -611,7 +611,7 @@ void SP_monster_boss2(edict_t *self)
 
     self->s.sound = gi.soundindex("bosshovr/bhvengn1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/boss2/tris.md2");
     VectorSet(self->mins, -56, -56, 0);
@@ -41,7 +41,7 @@ void Think_Boss3Stand(edict_t *ent)
         ent->s.frame = FRAME_stand201;
     else
         ent->s.frame++;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 /*QUAKED monster_boss3_stand (1 .5 0) (-32 -32 0) (32 32 90)
@@ -55,7 +55,7 @@ void SP_monster_boss3_stand(edict_t *self)
         return;
     }
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->model = "models/monsters/boss3/rider/tris.md2";
     self->s.modelindex = gi.modelindex(self->model);
@@ -68,6 +68,6 @@ void SP_monster_boss3_stand(edict_t *self)
 
     self->use = Use_Boss3;
     self->think = Think_Boss3Stand;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     gi.linkentity(self);
 }
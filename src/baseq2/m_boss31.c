@@ -537,8 +537,8 @@ void jorg_dead(edict_t *self)
     // Jorg is on modelindex2. Do not clear him.
     VectorSet(self->mins, -60, -60, 0);
     VectorSet(self->maxs, 60, 60, 72);
-    self->movetype = MOVETYPE_TOSS;
-    self->nextthink = 0;
+    G_SetMoveType(self, MOVETYPE_TOSS);
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 
     tempent = G_Spawn();
@@ -670,7 +670,7 @@ void SP_monster_jorg(edict_t *self)
 
     MakronPrecache();
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/boss3/rider/tris.md2");
     self->s.modelindex2 = gi.modelindex("models/monsters/boss3/jorg/tris.md2");
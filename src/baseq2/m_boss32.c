@@ -603,23 +603,23 @@ Makron Torso. This needs to be spawned in
 void makron_torso_think(edict_t *self)
 {
     if (++self->s.frame < 365)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 346;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
 void makron_torso(edict_t *ent)
 {
-    ent->movetype = MOVETYPE_NONE;
+    G_SetMoveType(ent, MOVETYPE_NONE);
     ent->solid = SOLID_NOT;
     VectorSet(ent->mins, -8, -8, 0);
     VectorSet(ent->maxs, 8, 8, 8);
     ent->s.frame = 346;
     ent->s.modelindex = gi.modelindex("models/monsters/boss3/rider/tris.md2");
     ent->think = makron_torso_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     ent->s.sound = gi.soundindex("makron/spine.wav");
     gi.linkentity(ent);
 }
@@ -633,9 +633,9 @@ void makron_dead(edict_t *self)
 {
     VectorSet(self->mins, -60, -60, 0);
     VectorSet(self->maxs, 60, 60, 72);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -790,7 +790,7 @@ void SP_monster_makron(edict_t *self)
 
     MakronPrecache();
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/boss3/rider/tris.md2");
     VectorSet(self->mins, -30, -30, 0);
@@ -859,7 +859,7 @@ void MakronToss(edict_t *self)
     edict_t *ent;
 
     ent = G_Spawn();
-    ent->nextthink = level.framenum + 0.8f * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 0.8f * BASE_FRAMERATE);
     ent->think = MakronSpawn;
     ent->target = self->target;
     VectorCopy(self->s.origin, ent->s.origin);
@@ -550,9 +550,9 @@ void brain_pain(edict_t *self, edict_t *other, float kick, int damage) {
 void brain_dead(edict_t *self) {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -612,7 +612,7 @@ void SP_monster_brain(edict_t *self) {
     sound_melee2 = gi.soundindex("brain/melee2.wav");
     sound_melee3 = gi.soundindex("brain/melee3.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/brain/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
@@ -284,9 +284,9 @@ void chick_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, 0);
     VectorSet(self->maxs, 16, 16, 16);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -614,7 +614,7 @@ void SP_monster_chick(edict_t *self)
     sound_sight             = gi.soundindex("chick/chksght1.wav");
     sound_search            = gi.soundindex("chick/chksrch1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
     VectorSet(self->mins, -16, -16, 0);
@@ -239,9 +239,9 @@ void flipper_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -359,7 +359,7 @@ void SP_monster_flipper(edict_t *self)
     sound_search    = gi.soundindex("flipper/flpsrch1.wav");
     sound_sight     = gi.soundindex("flipper/flpsght1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/flipper/tris.md2");
     VectorSet(self->mins, -16, -16, 0);
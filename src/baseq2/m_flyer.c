@@ -566,7 +566,7 @@ void SP_monster_flyer(edict_t *self)
     self->s.modelindex = gi.modelindex("models/monsters/flyer/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, 32);
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
 
     self->s.sound = gi.soundindex("flyer/flyidle1.wav");
@@ -262,9 +262,9 @@ void gladiator_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -343,7 +343,7 @@ void SP_monster_gladiator(edict_t *self)
     sound_search = gi.soundindex("gladiator/gldsrch1.wav");
     sound_sight = gi.soundindex("gladiator/sight.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/gladiatr/tris.md2");
     VectorSet(self->mins, -32, -32, -24);
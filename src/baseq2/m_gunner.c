@@ -300,9 +300,9 @@ void gunner_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -574,7 +574,7 @@ void SP_monster_gunner(edict_t *self)
     gi.soundindex("gunner/gunatck2.wav");
     gi.soundindex("gunner/gunatck3.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/gunner/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
@@ -495,7 +495,7 @@ void hover_pain(edict_t *self, edict_t *other, float kick, int damage)
 void hover_deadthink(edict_t *self)
 {
     if (!self->groundentity && level.framenum < self->timestamp) {
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
         return;
     }
     BecomeExplosion1(self);
@@ -505,9 +505,9 @@ void hover_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->think = hover_deadthink;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->timestamp = level.framenum + 15 * BASE_FRAMERATE;
     gi.linkentity(self);
 }
@@ -562,7 +562,7 @@ void SP_monster_hover(edict_t *self)
 
     self->s.sound = gi.soundindex("hover/hovidle1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/hover/tris.md2");
     VectorSet(self->mins, -24, -24, -24);
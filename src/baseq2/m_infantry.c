@@ -287,7 +287,7 @@ void infantry_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
     gi.linkentity(self);
 
@@ -545,7 +545,7 @@ void SP_monster_infantry(edict_t *self)
     sound_idle = gi.soundindex("infantry/infidle1.wav");
 
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/infantry/tris.md2");
     VectorSet(self->mins, -16, -16, -24);
@@ -542,10 +542,10 @@ void insane_dead(edict_t *self)
     } else {
         VectorSet(self->mins, -16, -16, -24);
         VectorSet(self->maxs, 16, 16, -8);
-        self->movetype = MOVETYPE_TOSS;
+        G_SetMoveType(self, MOVETYPE_TOSS);
     }
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -607,7 +607,7 @@ void SP_misc_insane(edict_t *self)
     sound_scream[6] = gi.soundindex("insane/insane9.wav");
     sound_scream[7] = gi.soundindex("insane/insane10.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/insane/tris.md2");
 
@@ -352,9 +352,9 @@ void medic_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -595,7 +595,7 @@ void medic_cable_attack(edict_t *self)
         ED_CallSpawn(self->enemy);
         self->enemy->owner = NULL;
         if (self->enemy->think) {
-            self->enemy->nextthink = level.framenum;
+            G_SetNextThink(self->enemy, level.framenum);
             self->enemy->think(self->enemy);
         }
         self->enemy->monsterinfo.aiflags |= AI_RESURRECTING;
@@ -703,7 +703,7 @@ void SP_monster_medic(edict_t *self)
 
     gi.soundindex("medic/medatck1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/medic/tris.md2");
     VectorSet(self->mins, -24, -24, -24);
@@ -509,7 +509,7 @@ void mutant_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -24);
     VectorSet(self->maxs, 16, 16, -8);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
     gi.linkentity(self);
 
@@ -600,7 +600,7 @@ void SP_monster_mutant(edict_t *self)
     sound_step3 = gi.soundindex("mutant/step3.wav");
     sound_thud = gi.soundindex("mutant/thud1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/mutant/tris.md2");
     VectorSet(self->mins, -32, -32, -24);
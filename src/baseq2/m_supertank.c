@@ -559,9 +559,9 @@ void supertank_dead(edict_t *self)
 {
     VectorSet(self->mins, -60, -60, 0);
     VectorSet(self->maxs, 60, 60, 72);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -624,7 +624,7 @@ void BossExplode(edict_t *self)
     gi.WritePosition(org);
     gi.multicast(self->s.origin, MULTICAST_PVS);
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 
@@ -660,7 +660,7 @@ void SP_monster_supertank(edict_t *self)
 //  self->s.sound = gi.soundindex ("bosstank/btkengn1.wav");
     tread_sound = gi.soundindex("bosstank/btkengn1.wav");
 
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
     self->s.modelindex = gi.modelindex("models/monsters/boss1/tris.md2");
     VectorSet(self->mins, -64, -64, 0);
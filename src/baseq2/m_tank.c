@@ -669,9 +669,9 @@ void tank_dead(edict_t *self)
 {
     VectorSet(self->mins, -16, -16, -16);
     VectorSet(self->maxs, 16, 16, -0);
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -759,7 +759,7 @@ void SP_monster_tank(edict_t *self)
     self->s.modelindex = gi.modelindex("models/monsters/tank/tris.md2");
     VectorSet(self->mins, -32, -32, -16);
     VectorSet(self->maxs, 32, 32, 72);
-    self->movetype = MOVETYPE_STEP;
+    G_SetMoveType(self, MOVETYPE_STEP);
     self->solid = SOLID_BBOX;
 
     sound_pain = gi.soundindex("tank/tnkpain2.wav");
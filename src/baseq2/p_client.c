@@ -106,7 +106,7 @@ void SP_info_player_start(edict_t *self)
     if (Q_stricmp(level.mapname, "security") == 0) {
         // invoke one of our gross, ugly, disgusting hacks
         self->think = SP_CreateCoopSpots;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -149,7 +149,7 @@ void SP_info_player_coop(edict_t *self)
         (Q_stricmp(level.mapname, "strike") == 0)) {
         // invoke one of our gross, ugly, disgusting hacks
         self->think = SP_FixCoopSpots;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -428,7 +428,7 @@ void TossClientWeapon(edict_t *self)
         drop->spawnflags |= DROPPED_PLAYER_ITEM;
 
         drop->touch = Touch_Item;
-        drop->nextthink = self->client->quad_framenum;
+        G_SetNextThink(drop, self->client->quad_framenum);
         drop->think = G_FreeEdict;
     }
 }
@@ -479,7 +479,7 @@ void player_die(edict_t *self, edict_t *inflictor, edict_t *attacker, int damage
     VectorClear(self->avelocity);
 
     self->takedamage = DAMAGE_YES;
-    self->movetype = MOVETYPE_TOSS;
+    G_SetMoveType(self, MOVETYPE_TOSS);
 
     self->s.modelindex2 = 0;    // remove linked weapon model
 
@@ -927,7 +927,7 @@ void CopyToBodyQue(edict_t *ent)
     body->solid = ent->solid;
     body->clipmask = ent->clipmask;
     body->owner = ent->owner;
-    body->movetype = ent->movetype;
+    G_SetMoveType(body, ent->movetype);
     body->groundentity = ent->groundentity;
 
     body->die = body_die;
@@ -1116,7 +1116,7 @@ void PutClientInServer(edict_t *ent)
     ent->groundentity = NULL;
     ent->client = &game.clients[index];
     ent->takedamage = DAMAGE_AIM;
-    ent->movetype = MOVETYPE_WALK;
+    G_SetMoveType(ent, MOVETYPE_WALK);
     ent->viewheight = 22;
     ent->inuse = true;
     ent->classname = "player";
@@ -1186,7 +1186,7 @@ void PutClientInServer(edict_t *ent)
 
         client->resp.spectator = true;
 
-        ent->movetype = MOVETYPE_NOCLIP;
+        G_SetMoveType(ent, MOVETYPE_NOCLIP);
         ent->solid = SOLID_NOT;
         ent->svflags |= SVF_NOCLIENT;
         ent->client->ps.gunindex = 0;
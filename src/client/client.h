@@ -26,6 +26,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "common/cmodel.h"
 #include "common/common.h"
 #include "common/cvar.h"
+#include "common/demo.h"
 #include "common/field.h"
 #include "common/files.h"
 #include "common/pmove.h"
@@ -385,6 +386,7 @@ typedef struct client_static_s {
 
 #if USE_ZLIB
     z_stream    z;
+    z_stream    zstream;    // persistent stream for svc_zstream
 #endif
 
     int         quakePort;          // a 16 bit value that allows quake servers
@@ -431,11 +433,13 @@ typedef struct client_static_s {
         int         others_dropped;     // number of misc svc_* messages that didn't fit
         int         frames_read;        // number of frames read from demo file
         int         last_snapshot;      // number of demo frame the last snapshot was saved
+        int         index_snapshots;    // number of snapshots loaded from index file
+        char        index_name[MAX_OSPATH]; // demo to write index for, if any
         int64_t     file_size;
         int64_t     file_offset;
         int         file_percent;
         sizebuf_t   buffer;
-        list_t      snapshots;
+        demosnaps_t snapshots;
         bool        paused;
         bool        seeking;
         bool        eof;
@@ -25,6 +25,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 static byte     demo_buffer[MAX_PACKETLEN];
 
 static cvar_t   *cl_demosnaps;
+static cvar_t   *cl_demosnapsize;
+static cvar_t   *cl_demoindex;
 static cvar_t   *cl_demomsglen;
 static cvar_t   *cl_demowait;
 
@@ -322,7 +324,7 @@ static void CL_Record_f(void)
     entity_packed_t pack;
     char            *s;
     qhandle_t       f;
-    unsigned        mode = FS_MODE_WRITE;
+    unsigned        mode = FS_MODE_WRITE | FS_FLAG_ASYNC;
     size_t          size = Cvar_ClampInteger(
                                cl_demomsglen,
                                MIN_PACKETLEN,
@@ -717,6 +719,7 @@ static void CL_PlayDemo_f(void)
 
     cls.demo.playback = f;
     cls.state = ca_connected;
+    Q_strlcpy(cls.demo.index_name, name, sizeof(cls.demo.index_name));
     Q_strlcpy(cls.servername, COM_SkipPath(name), sizeof(cls.servername));
     cls.serverAddress.type = NA_LOOPBACK;
 
@@ -740,14 +743,6 @@ static void CL_Demo_c(genctx_t *ctx, int argnum)
     }
 }
 
-typedef struct {
-    list_t entry;
-    int framenum;
-    int64_t filepos;
-    size_t msglen;
-    byte data[1];
-} demosnap_t;
-
 /*
 ====================
 CL_EmitDemoSnapshot
@@ -768,7 +763,13 @@ void CL_EmitDemoSnapshot(void)
     if (cl_demosnaps->integer <= 0)
         return;
 
-    if (cls.demo.frames_read < cls.demo.last_snapshot + cl_demosnaps->integer * 10)
+    // never emit snapshots before the most recent one
+    if (cls.demo.frames_read <= cls.demo.last_snapshot)
+        return;
+
+    // emit early if too much data was parsed since the last snapshot
+    if (cls.demo.frames_read < cls.demo.last_snapshot + cl_demosnaps->integer * 10 &&
+        cl_demosnapsize->integer <= 0)
         return;
 
     if (!cl.frame.valid)
@@ -781,6 +782,12 @@ void CL_EmitDemoSnapshot(void)
     if (pos < cls.demo.file_offset)
         return;
 
+    if (cls.demo.frames_read < cls.demo.last_snapshot + cl_demosnaps->integer * 10) {
+        snap = Demo_LastSnapshot(&cls.demo.snapshots);
+        if (snap && pos - snap->filepos < cl_demosnapsize->integer * 1024LL)
+            return;
+    }
+
     // write all the backups, since we can't predict what frame the next
     // delta will come from
     lastframe = NULL;
@@ -825,7 +832,7 @@ void CL_EmitDemoSnapshot(void)
     snap->filepos = pos;
     snap->msglen = msg_write.cursize;
     memcpy(snap->data, msg_write.data, msg_write.cursize);
-    List_Append(&cls.demo.snapshots, &snap->entry);
+    Demo_AddSnapshot(&cls.demo.snapshots, snap, TAG_GENERAL);
 
     Com_DPrintf("[%d] snaplen %zu\n", cls.demo.frames_read, msg_write.cursize);
 
@@ -834,22 +841,49 @@ void CL_EmitDemoSnapshot(void)
     cls.demo.last_snapshot = cls.demo.frames_read;
 }
 
-static demosnap_t *find_snapshot(int framenum)
+static void load_index(void)
 {
-    demosnap_t *snap, *prev;
-
-    if (LIST_EMPTY(&cls.demo.snapshots))
-        return NULL;
+    demosnap_t *snap;
+    int ret;
 
-    prev = LIST_FIRST(demosnap_t, &cls.demo.snapshots, entry);
+    if (!cls.demo.index_name[0] || !cl_demoindex->integer || cl_demosnaps->integer <= 0)
+        return;
 
-    LIST_FOR_EACH(demosnap_t, snap, &cls.demo.snapshots, entry) {
-        if (snap->framenum > framenum)
-            break;
-        prev = snap;
+    ret = Demo_LoadIndex(cls.demo.index_name, cls.demo.playback,
+                         &cls.demo.snapshots, TAG_GENERAL);
+    if (ret < 0 && ret != Q_ERR_NOENT) {
+        Com_DPrintf("Couldn't load index for %s: %s\n",
+                    cls.demo.index_name, Q_ErrorString(ret));
     }
+    if (ret <= 0)
+        return;
+
+    // don't emit snapshots already present in index
+    snap = Demo_LastSnapshot(&cls.demo.snapshots);
+    cls.demo.last_snapshot = snap->framenum;
+    cls.demo.index_snapshots = ret;
 
-    return prev;
+    Com_DPrintf("Loaded %d snapshots from index\n", ret);
+}
+
+static void save_index(void)
+{
+    int ret;
+
+    if (!cls.demo.index_name[0] || !cl_demoindex->integer)
+        return;
+
+    // only write index if some new snapshots were emitted
+    if (cls.demo.snapshots.numsnaps <= cls.demo.index_snapshots)
+        return;
+
+    ret = Demo_SaveIndex(cls.demo.index_name, cls.demo.playback, &cls.demo.snapshots);
+    if (ret < 0) {
+        Com_DPrintf("Couldn't save index for %s: %s\n",
+                    cls.demo.index_name, Q_ErrorString(ret));
+    } else {
+        Com_DPrintf("Saved %d snapshots to index\n", ret);
+    }
 }
 
 /*
@@ -865,6 +899,11 @@ void CL_FirstDemoFrame(void)
 
     Com_DPrintf("[%d] first frame\n", cl.frame.number);
 
+    // snapshots are saved relative to the first map only, don't index demos
+    // containing map changes
+    if (cls.demo.file_offset)
+        cls.demo.index_name[0] = 0;
+
     // save base configstrings
     memcpy(cl.baseconfigstrings, cl.configstrings, sizeof(cl.baseconfigstrings));
 
@@ -884,6 +923,9 @@ void CL_FirstDemoFrame(void)
 
     // force initial snapshot
     cls.demo.last_snapshot = INT_MIN;
+
+    // load snapshots saved by previous playback
+    load_index();
 }
 
 static void CL_Seek_f(void)
@@ -953,7 +995,11 @@ static void CL_Seek_f(void)
 
     // seek to the previous most recent snapshot
     if (frames < 0 || cls.demo.last_snapshot > cls.demo.frames_read) {
-        snap = find_snapshot(dest);
+        snap = Demo_FindSnapshot(&cls.demo.snapshots, dest);
+
+        // when seeking forward, only use snapshots ahead of current frame
+        if (snap && frames > 0 && snap->framenum <= cls.demo.frames_read)
+            snap = NULL;
 
         if (snap) {
             Com_DPrintf("found snap at %d\n", snap->framenum);
@@ -1164,14 +1210,15 @@ fail:
 
 void CL_CleanupDemos(void)
 {
-    demosnap_t *snap, *next;
     size_t total;
+    int i;
 
     if (cls.demo.recording) {
         CL_Stop_f();
     }
 
     if (cls.demo.playback) {
+        save_index();
         FS_FCloseFile(cls.demo.playback);
 
         if (com_timedemo->integer && cls.demo.time_frames) {
@@ -1188,17 +1235,15 @@ void CL_CleanupDemos(void)
     }
 
     total = 0;
-    LIST_FOR_EACH_SAFE(demosnap_t, snap, next, &cls.demo.snapshots, entry) {
-        total += snap->msglen;
-        Z_Free(snap);
-    }
+    for (i = 0; i < cls.demo.snapshots.numsnaps; i++)
+        total += cls.demo.snapshots.snaps[i]->msglen;
 
     if (total)
         Com_DPrintf("Freed %zu bytes of snaps\n", total);
 
-    memset(&cls.demo, 0, sizeof(cls.demo));
+    Demo_FreeSnapshots(&cls.demo.snapshots);
 
-    List_Init(&cls.demo.snapshots);
+    memset(&cls.demo, 0, sizeof(cls.demo));
 }
 
 /*
@@ -1259,9 +1304,10 @@ CL_InitDemos
 void CL_InitDemos(void)
 {
     cl_demosnaps = Cvar_Get("cl_demosnaps", "10", 0);
+    cl_demosnapsize = Cvar_Get("cl_demosnapsize", "128", 0);
+    cl_demoindex = Cvar_Get("cl_demoindex", "1", 0);
     cl_demomsglen = Cvar_Get("cl_demomsglen", va("%d", MAX_PACKETLEN_WRITABLE_DEFAULT), 0);
     cl_demowait = Cvar_Get("cl_demowait", "0", 0);
 
     Cmd_Register(c_demo);
-    List_Init(&cls.demo.snapshots);
 }
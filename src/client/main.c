@@ -3331,6 +3331,9 @@ void CL_Init(void)
     if (inflateInit2(&cls.z, -MAX_WBITS) != Z_OK) {
         Com_Error(ERR_FATAL, "%s: inflateInit2() failed", __func__);
     }
+    if (inflateInit2(&cls.zstream, -MAX_WBITS) != Z_OK) {
+        Com_Error(ERR_FATAL, "%s: inflateInit2() failed", __func__);
+    }
 #endif
 
     CL_LoadDownloadIgnores();
@@ -3378,6 +3381,7 @@ void CL_Shutdown(void)
 
 #if USE_ZLIB
     inflateEnd(&cls.z);
+    inflateEnd(&cls.zstream);
 #endif
 
     HTTP_Shutdown();
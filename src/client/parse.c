@@ -583,6 +583,10 @@ static void CL_ParseServerData(void)
         }
         Com_DPrintf("Using minor Q2PRO protocol version %d\n", i);
         cls.protocolVersion = i;
+#if USE_ZLIB
+        // server restarts svc_zstream compressor with serverdata
+        inflateReset(&cls.zstream);
+#endif
         i = MSG_ReadByte();
         if (cls.protocolVersion >= PROTOCOL_VERSION_Q2PRO_SERVER_STATE) {
             Com_DPrintf("Q2PRO server state %d\n", i);
@@ -1068,14 +1072,18 @@ static void CL_ParseDownload(int cmd)
     CL_HandleDownload(data, size, percent, decompressed_size);
 }
 
-static void CL_ParseZPacket(void)
+static void CL_ParseZPacket(bool stream)
 {
 #if USE_ZLIB
     sizebuf_t   temp;
     byte        buffer[MAX_MSGLEN];
+    z_streamp   z = stream ? &cls.zstream : &cls.z;
     int         ret, inlen, outlen;
 
-    if (msg_read.data != msg_read_buffer) {
+    // message is read either from packet buffer or in place from netchan
+    // fragment buffer, anything else means a nested compressed packet
+    if (msg_read.data != msg_read_buffer &&
+        (!cls.netchan || msg_read.data != cls.netchan->fragment_in.data)) {
         Com_Error(ERR_DROP, "%s: recursively entered", __func__);
     }
 
@@ -1090,17 +1098,31 @@ static void CL_ParseZPacket(void)
         Com_Error(ERR_DROP, "%s: invalid output length", __func__);
     }
 
-    inflateReset(&cls.z);
+    // svc_zstream continues the stream of previous ones
+    if (!stream)
+        inflateReset(z);
 
-    cls.z.next_in = msg_read.data + msg_read.readcount;
-    cls.z.avail_in = (uInt)inlen;
-    cls.z.next_out = buffer;
-    cls.z.avail_out = (uInt)outlen;
-    ret = inflate(&cls.z, Z_FINISH);
-    if (ret != Z_STREAM_END) {
+    z->next_in = msg_read.data + msg_read.readcount;
+    z->avail_in = (uInt)inlen;
+    z->next_out = buffer;
+    z->avail_out = (uInt)outlen;
+    ret = inflate(z, stream ? Z_SYNC_FLUSH : Z_FINISH);
+    if (stream ? (ret != Z_OK || z->avail_out) : ret != Z_STREAM_END) {
         Com_Error(ERR_DROP, "%s: inflate() failed with error %d", __func__, ret);
     }
 
+    // consume sync flush marker possibly left after output filled up
+    if (stream && z->avail_in) {
+        byte dummy;
+
+        z->next_out = &dummy;
+        z->avail_out = 1;
+        ret = inflate(z, Z_SYNC_FLUSH);
+        if ((ret != Z_OK && ret != Z_BUF_ERROR) || z->avail_in || !z->avail_out) {
+            Com_Error(ERR_DROP, "%s: trailing data in compressed stream", __func__);
+        }
+    }
+
     msg_read.readcount += inlen;
 
     temp = msg_read;
@@ -1284,7 +1306,15 @@ badbyte:
             if (cls.serverProtocol < PROTOCOL_VERSION_R1Q2) {
                 goto badbyte;
             }
-            CL_ParseZPacket();
+            CL_ParseZPacket(false);
+            continue;
+
+        case svc_zstream:
+            if (cls.serverProtocol != PROTOCOL_VERSION_Q2PRO ||
+                cls.protocolVersion < PROTOCOL_VERSION_Q2PRO_ZLIB_STREAM) {
+                goto badbyte;
+            }
+            CL_ParseZPacket(true);
             continue;
 
         case svc_zdownload:
@@ -34,6 +34,8 @@ static mleaf_t      nullleaf;
 static int          floodvalid;
 static int          checkcount;
 
+cmstats_t           cm_stats;
+
 static cvar_t       *map_noareas;
 static cvar_t       *map_allsolid_bug;
 
@@ -214,53 +216,57 @@ CM_BoxLeafnums
 Fills in a list of all the leafs touched
 =============
 */
-static int      leaf_count, leaf_maxcount;
-static mleaf_t  **leaf_list;
-static float    *leaf_mins, *leaf_maxs;
-static mnode_t  *leaf_topnode;
-
-static void CM_BoxLeafs_r(mnode_t *node)
+typedef struct {
+    int         count, maxcount;
+    mleaf_t     **list;
+    float       *mins, *maxs;
+    mnode_t     *topnode;
+} boxleafs_t;
+
+// state is kept on stack so that visibility can be checked from worker threads
+static void CM_BoxLeafs_r(boxleafs_t *bl, mnode_t *node)
 {
     int     s;
 
     while (node->plane) {
-        s = BoxOnPlaneSideFast(leaf_mins, leaf_maxs, node->plane);
+        s = BoxOnPlaneSideFast(bl->mins, bl->maxs, node->plane);
         if (s == 1) {
             node = node->children[0];
         } else if (s == 2) {
             node = node->children[1];
         } else {
             // go down both
-            if (!leaf_topnode) {
-                leaf_topnode = node;
+            if (!bl->topnode) {
+                bl->topnode = node;
             }
-            CM_BoxLeafs_r(node->children[0]);
+            CM_BoxLeafs_r(bl, node->children[0]);
             node = node->children[1];
         }
     }
 
-    if (leaf_count < leaf_maxcount) {
-        leaf_list[leaf_count++] = (mleaf_t *)node;
+    if (bl->count < bl->maxcount) {
+        bl->list[bl->count++] = (mleaf_t *)node;
     }
 }
 
 static int CM_BoxLeafs_headnode(vec3_t mins, vec3_t maxs, mleaf_t **list, int listsize,
                                 mnode_t *headnode, mnode_t **topnode)
 {
-    leaf_list = list;
-    leaf_count = 0;
-    leaf_maxcount = listsize;
-    leaf_mins = mins;
-    leaf_maxs = maxs;
+    boxleafs_t bl;
 
-    leaf_topnode = NULL;
+    bl.list = list;
+    bl.count = 0;
+    bl.maxcount = listsize;
+    bl.mins = mins;
+    bl.maxs = maxs;
+    bl.topnode = NULL;
 
-    CM_BoxLeafs_r(headnode);
+    CM_BoxLeafs_r(&bl, headnode);
 
     if (topnode)
-        *topnode = leaf_topnode;
+        *topnode = bl.topnode;
 
-    return leaf_count;
+    return bl.count;
 }
 
 int CM_BoxLeafs(cm_t *cm, vec3_t mins, vec3_t maxs, mleaf_t **list, int listsize, mnode_t **topnode)
@@ -490,6 +496,8 @@ static void CM_TraceToLeaf(mleaf_t *leaf)
 
         if (!(b->contents & trace_contents))
             continue;
+        if (cm_stats.enabled)
+            cm_stats.brushes++;
         CM_ClipBoxToBrush(trace_start, trace_end, trace_trace, b);
         if (!trace_trace->fraction)
             return;
@@ -518,6 +526,8 @@ static void CM_TestInLeaf(mleaf_t *leaf)
 
         if (!(b->contents & trace_contents))
             continue;
+        if (cm_stats.enabled)
+            cm_stats.brushes++;
         CM_TestBoxInBrush(trace_start, trace_trace, b);
         if (!trace_trace->fraction)
             return;
@@ -544,6 +554,9 @@ static void CM_RecursiveHullCheck(mnode_t *node, float p1f, float p2f, vec3_t p1
         return;     // already hit something nearer
 
 recheck:
+    if (cm_stats.enabled)
+        cm_stats.nodes++;
+
     // if plane is NULL, we are in a leaf node
     plane = node->plane;
     if (!plane) {
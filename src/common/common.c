@@ -486,6 +486,13 @@ void Com_Error(error_type_t code, const char *fmt, ...)
     va_list         argptr;
     size_t          len;
 
+    va_start(argptr, fmt);
+    len = Q_vscnprintf(msg, sizeof(msg), fmt, argptr);
+    va_end(argptr);
+
+    // errors raised inside Sys_ParallelFor are rethrown by the calling thread
+    Sys_AbortParallelFor(code, msg);
+
     // may not be entered recursively
     if (com_errorEntered) {
 #if USE_DEBUG
@@ -498,10 +505,6 @@ void Com_Error(error_type_t code, const char *fmt, ...)
 
     com_errorEntered = true;
 
-    va_start(argptr, fmt);
-    len = Q_vscnprintf(msg, sizeof(msg), fmt, argptr);
-    va_end(argptr);
-
     // save error msg
     // can't print into it directly since it may
     // overlap with one of the arguments!
@@ -1011,12 +1014,14 @@ void Qcommon_Init(int argc, char **argv)
         SCR_EndLoadingPlaque();
     }
 
+#if !USE_SWARM
     // even not given a starting map, dedicated server starts
     // listening for rcon commands (create socket after all configs
     // are executed to make sure port number is properly set)
     if (COM_DEDICATED) {
         NET_Config(NET_SERVER);
     }
+#endif
 
     Com_AddConfigFile(COM_POSTINIT_CFG, FS_TYPE_REAL);
 
@@ -31,6 +31,8 @@ cvar_t  *cvar_vars;
 
 int     cvar_modified;
 
+unsigned    cvar_serverinfo_changes;
+
 #define Cvar_Malloc(size)   Z_TagMalloc(size, TAG_CVAR)
 
 #define CVARHASH_SIZE    256
@@ -182,6 +184,9 @@ static void change_string_value(cvar_t *var, const char *value, from_t from)
     }
 
     var->modified = true;
+    if (var->flags & CVAR_SERVERINFO) {
+        cvar_serverinfo_changes++;
+    }
     if (from != FROM_CODE) {
         cvar_modified |= var->flags & CVAR_MODIFYMASK;
         var->flags |= CVAR_MODIFIED;
@@ -240,6 +245,10 @@ static void get_engine_cvar(cvar_t *var, const char *var_value, int flags)
         flags &= ~CVAR_GAME;
     }
 
+    if (flags & ~var->flags & CVAR_SERVERINFO) {
+        cvar_serverinfo_changes++;
+    }
+
     // some flags are not saved
     var->flags &= ~(CVAR_GAME | CVAR_CUSTOM | CVAR_WEAK);
     var->flags |= flags;
@@ -294,6 +303,9 @@ cvar_t *Cvar_Get(const char *var_name, const char *var_value, int flags)
     var->default_string = Z_CvarCopyString(var_value);
     parse_string_value(var);
     var->flags = flags;
+    if (flags & CVAR_SERVERINFO) {
+        cvar_serverinfo_changes++;
+    }
     var->changed = NULL;
     var->generator = Cvar_Default_g;
     var->modified = true;
@@ -442,6 +454,10 @@ cvar_t *Cvar_FullSet(const char *var_name, const char *value, int flags, from_t
         CL_UpdateUserinfo(var, from);
     }
 
+    if ((var->flags ^ flags) & CVAR_SERVERINFO) {
+        cvar_serverinfo_changes++;
+    }
+
     var->flags &= ~CVAR_INFOMASK;
     var->flags |= flags;
 
@@ -602,8 +618,10 @@ void Cvar_GetLatchedVars(void)
     cvar_t    *var;
 
     for (var = cvar_vars; var; var = var->next) {
-        if (var->flags & CVAR_GAME)
+        if ((var->flags & (CVAR_GAME | CVAR_SERVERINFO)) == (CVAR_GAME | CVAR_SERVERINFO)) {
             var->flags &= ~CVAR_SERVERINFO;
+            cvar_serverinfo_changes++;
+        }
         if (!(var->flags & CVAR_LATCH))
             continue;
         if (!var->latched_string)
@@ -613,6 +631,9 @@ void Cvar_GetLatchedVars(void)
         var->latched_string = NULL;
         parse_string_value(var);
         var->modified = true;
+        if (var->flags & CVAR_SERVERINFO) {
+            cvar_serverinfo_changes++;
+        }
         cvar_modified |= var->flags & CVAR_MODIFYMASK;
         if (var->changed) {
             var->changed(var);
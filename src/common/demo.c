@@ -0,0 +1,323 @@
+/*
+Copyright (C) 2003-2008 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// demo.c -- demo snapshot lists and index files
+//
+
+#include "shared/shared.h"
+#include "common/common.h"
+#include "common/demo.h"
+#include "common/files.h"
+#include "common/protocol.h"
+
+/*
+Index file layout, all values are little endian:
+
+header:
+    uint32  magic
+    uint32  version
+    int64   demo length
+    int64   demo modification time
+    uint32  number of snapshots
+
+each snapshot:
+    int32   frame number
+    int64   demo file position
+    uint32  message length
+    byte    message[length]
+
+Index is valid only if length and modification time match the demo.
+Snapshot contents are produced by the parser of this very version, so
+version is bumped whenever their format may change.
+*/
+
+#define INDEX_MAGIC     "DIDX"
+#define INDEX_VERSION   1
+
+#define HEADER_SIZE     28
+#define SNAP_HEADER     16
+
+static void put32(byte *p, uint32_t v)
+{
+    p[0] = v & 255;
+    p[1] = (v >> 8) & 255;
+    p[2] = (v >> 16) & 255;
+    p[3] = v >> 24;
+}
+
+static void put64(byte *p, uint64_t v)
+{
+    put32(p, v & 0xffffffff);
+    put32(p + 4, v >> 32);
+}
+
+static uint64_t get64(const byte *p)
+{
+    return LittleLongMem(p) | ((uint64_t)LittleLongMem(p + 4) << 32);
+}
+
+/*
+==================
+Demo_AddSnapshot
+
+Inserts snapshot into the list keeping it sorted by frame number. Snapshot
+replaces any existing one with the same frame number.
+==================
+*/
+void Demo_AddSnapshot(demosnaps_t *list, demosnap_t *snap, memtag_t tag)
+{
+    int lo, hi, mid;
+
+    // find the first snapshot past this frame
+    lo = 0;
+    hi = list->numsnaps;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (list->snaps[mid]->framenum > snap->framenum)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    if (lo > 0 && list->snaps[lo - 1]->framenum == snap->framenum) {
+        Z_Free(list->snaps[lo - 1]);
+        list->snaps[lo - 1] = snap;
+        return;
+    }
+
+    if (list->numsnaps == list->maxsnaps) {
+        list->maxsnaps = list->maxsnaps ? list->maxsnaps * 2 : 64;
+        if (list->snaps)
+            list->snaps = Z_Realloc(list->snaps, list->maxsnaps * sizeof(list->snaps[0]));
+        else
+            list->snaps = Z_TagMalloc(list->maxsnaps * sizeof(list->snaps[0]), tag);
+    }
+
+    memmove(list->snaps + lo + 1, list->snaps + lo,
+            (list->numsnaps - lo) * sizeof(list->snaps[0]));
+    list->snaps[lo] = snap;
+    list->numsnaps++;
+}
+
+/*
+==================
+Demo_FindSnapshot
+
+Returns the most recent snapshot at or before the given frame, or the
+very first snapshot if there is none. Returns NULL if the list is empty.
+==================
+*/
+demosnap_t *Demo_FindSnapshot(const demosnaps_t *list, int framenum)
+{
+    int lo, hi, mid;
+
+    if (!list->numsnaps)
+        return NULL;
+
+    lo = 0;
+    hi = list->numsnaps;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (list->snaps[mid]->framenum > framenum)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    return list->snaps[lo ? lo - 1 : 0];
+}
+
+void Demo_FreeSnapshots(demosnaps_t *list)
+{
+    int i;
+
+    for (i = 0; i < list->numsnaps; i++)
+        Z_Free(list->snaps[i]);
+
+    Z_Free(list->snaps);
+    memset(list, 0, sizeof(*list));
+}
+
+static int open_index(const char *name, qhandle_t *f, unsigned mode)
+{
+    char path[MAX_OSPATH];
+
+    if (Q_concat(path, sizeof(path), name, DEMO_INDEX_EXT) >= sizeof(path))
+        return Q_ERR(ENAMETOOLONG);
+
+    return FS_FOpenFile(path, f, mode);
+}
+
+/*
+==================
+Demo_LoadIndex
+
+Loads snapshots from index file of the given demo and adds them to the
+list. Returns number of snapshots loaded or negative error code. Nothing
+is appended if index is missing, stale or malformed.
+==================
+*/
+int Demo_LoadIndex(const char *name, qhandle_t demo, demosnaps_t *list, memtag_t tag)
+{
+    byte header[HEADER_SIZE];
+    file_info_t info;
+    demosnaps_t temp;
+    demosnap_t *snap;
+    qhandle_t f;
+    int64_t ret, filepos;
+    int i, count, framenum;
+    size_t msglen;
+
+    ret = FS_GetFileInfo(demo, &info);
+    if (ret)
+        return ret;
+
+    ret = open_index(name, &f, FS_MODE_READ);
+    if (!f)
+        return ret;
+
+    ret = FS_Read(header, sizeof(header), f);
+    if (ret != sizeof(header)) {
+        ret = ret < 0 ? ret : Q_ERR_UNEXPECTED_EOF;
+        goto fail;
+    }
+
+    if (memcmp(header, INDEX_MAGIC, 4)) {
+        ret = Q_ERR_UNKNOWN_FORMAT;
+        goto fail;
+    }
+
+    if (LittleLongMem(header + 4) != INDEX_VERSION ||
+        get64(header + 8) != info.size ||
+        get64(header + 16) != (uint64_t)info.mtime) {
+        ret = Q_ERR_INVALID_FORMAT;
+        goto fail;
+    }
+
+    count = LittleLongMem(header + 24);
+    if (count < 0) {
+        ret = Q_ERR_INVALID_FORMAT;
+        goto fail;
+    }
+
+    memset(&temp, 0, sizeof(temp));
+    framenum = INT_MIN;
+    for (i = 0; i < count; i++) {
+        ret = FS_Read(header, SNAP_HEADER, f);
+        if (ret != SNAP_HEADER) {
+            ret = ret < 0 ? ret : Q_ERR_UNEXPECTED_EOF;
+            break;
+        }
+
+        filepos = get64(header + 4);
+        msglen = LittleLongMem(header + 12);
+        if ((int)LittleLongMem(header) <= framenum || filepos < 0 ||
+            filepos > info.size || !msglen || msglen > MAX_MSGLEN) {
+            ret = Q_ERR_INVALID_FORMAT;
+            break;
+        }
+        framenum = LittleLongMem(header);
+
+        snap = Z_TagMalloc(sizeof(*snap) + msglen - 1, tag);
+        snap->framenum = framenum;
+        snap->filepos = filepos;
+        snap->msglen = msglen;
+        Demo_AddSnapshot(&temp, snap, tag);
+
+        ret = FS_Read(snap->data, msglen, f);
+        if (ret != msglen) {
+            ret = ret < 0 ? ret : Q_ERR_UNEXPECTED_EOF;
+            break;
+        }
+    }
+
+    if (i < count) {
+        Demo_FreeSnapshots(&temp);
+        goto fail;
+    }
+
+    for (i = 0; i < count; i++)
+        Demo_AddSnapshot(list, temp.snaps[i], tag);
+
+    Z_Free(temp.snaps);
+
+    FS_FCloseFile(f);
+    return count;
+
+fail:
+    FS_FCloseFile(f);
+    return ret;
+}
+
+/*
+==================
+Demo_SaveIndex
+
+Writes all snapshots from the list into index file of the given demo.
+==================
+*/
+int Demo_SaveIndex(const char *name, qhandle_t demo, const demosnaps_t *list)
+{
+    char path[MAX_OSPATH];
+    byte header[HEADER_SIZE];
+    file_info_t info;
+    demosnap_t *snap;
+    qhandle_t f;
+    int64_t ret;
+    int i;
+
+    ret = FS_GetFileInfo(demo, &info);
+    if (ret)
+        return ret;
+
+    ret = open_index(name, &f, FS_MODE_WRITE);
+    if (!f)
+        return ret;
+
+    memcpy(header, INDEX_MAGIC, 4);
+    put32(header + 4, INDEX_VERSION);
+    put64(header + 8, info.size);
+    put64(header + 16, info.mtime);
+    put32(header + 24, list->numsnaps);
+    ret = FS_Write(header, sizeof(header), f);
+
+    for (i = 0; i < list->numsnaps && ret >= 0; i++) {
+        snap = list->snaps[i];
+        put32(header, snap->framenum);
+        put64(header + 4, snap->filepos);
+        put32(header + 12, snap->msglen);
+        ret = FS_Write(header, SNAP_HEADER, f);
+        if (ret >= 0)
+            ret = FS_Write(snap->data, snap->msglen, f);
+    }
+
+    if (ret >= 0)
+        ret = FS_FCloseFile(f);
+    else
+        FS_FCloseFile(f);
+
+    if (ret < 0) {
+        // don't leave truncated index behind
+        Q_concat(path, sizeof(path), name, DEMO_INDEX_EXT);
+        FS_RemoveFile(path);
+        return ret;
+    }
+
+    return list->numsnaps;
+}
@@ -74,6 +74,9 @@ QUAKE FILESYSTEM
 #define FS_ERR_READ(fp) \
     (ferror(fp) ? Q_ERR_FAILURE : Q_ERR_UNEXPECTED_EOF)
 
+#define FS_ERR_WRITE(fp) \
+    (ferror(fp) && errno ? Q_ERRNO : Q_ERR_FAILURE)
+
 #define PATH_NOT_CHECKED    -1
 
 #define FOR_EACH_SYMLINK(link, list) \
@@ -93,6 +96,7 @@ typedef enum {
 #if USE_ZLIB
     FS_ZIP,
     FS_GZ,
+    FS_BGZF,
 #endif
     FS_BAD
 } filetype_t;
@@ -103,6 +107,33 @@ typedef struct {
     unsigned    rest_in;
     byte        buffer[ZIP_BUFSIZE];
 } zipstream_t;
+
+// BGZF is a series of independently deflated gzip members no larger than
+// 64 KiB each, with compressed member size stored in the extra field.
+// This allows random access and is still readable by any gzip tool.
+#define BGZF_HEADER     18
+#define BGZF_FOOTER     8
+#define BGZF_MAXBLOCK   0x10000
+#define BGZF_BLOCKLEN   0xff00      // uncompressed data per written block
+
+typedef struct {
+    int64_t     coffset;    // position of block in compressed file
+    int64_t     uoffset;    // position of block data in uncompressed file
+    unsigned    csize;
+    unsigned    usize;
+} bgzfblock_t;
+
+typedef struct {
+    z_stream    stream;
+    bgzfblock_t *blocks;    // only for reading
+    int         numblocks;
+    int         curblock;
+    unsigned    upos;
+    unsigned    ulen;
+    int64_t     written;    // only for writing
+    byte        ubuf[BGZF_MAXBLOCK];
+    byte        cbuf[BGZF_MAXBLOCK];
+} bgzfstream_t;
 #endif
 
 typedef struct packfile_s {
@@ -142,7 +173,8 @@ typedef struct {
     unsigned    mode;
     FILE        *fp;
 #if USE_ZLIB
-    void        *zfp;       // gzFile for FS_GZ or zipstream_t for FS_ZIP
+    void        *zfp;       // gzFile for FS_GZ, zipstream_t for FS_ZIP
+                            // or bgzfstream_t for FS_BGZF
 #endif
     packfile_t  *entry;     // pack entry this handle is tied to
     pack_t      *pack;      // points to the pack entry is from
@@ -150,8 +182,31 @@ typedef struct {
     int         error;      // stream error indicator from read/write operation
     unsigned    rest_out;   // remaining unread length for FS_PAK/FS_ZIP
     int64_t     length;     // total cached file length
+    time_t      mtime;      // modification time for FS_REAL/FS_GZ
+    struct asyncfile_s *async;  // non-NULL if writes are deferred
 } file_t;
 
+#define ASYNC_BUFFERS   2
+
+// buffer handed over to async work thread
+typedef struct {
+    file_t      *file;
+    byte        *data;
+    size_t      len;
+    int         error;      // set by work thread
+    unsigned    usec;       // set by work thread
+    bool        pending;
+} asyncbuf_t;
+
+typedef struct asyncfile_s {
+    asyncbuf_t  bufs[ASYNC_BUFFERS];
+    int         current;    // buffer being filled
+    size_t      size;
+    int64_t     pos;        // logical file position
+    int         pending;    // buffers queued for writing
+    int         error;
+} asyncfile_t;
+
 typedef struct {
     list_t      entry;
     unsigned    targlen;
@@ -194,6 +249,19 @@ static cvar_t       *fs_debug;
 
 cvar_t              *fs_game;
 
+static cvar_t       *fs_async_writes;
+static cvar_t       *fs_async_bufsize;
+
+static struct {
+    int         depth;      // buffers queued or being written
+    int         peak;
+    unsigned    writes;
+    unsigned    stalls;
+    uint64_t    bytes;
+    uint64_t    total_usec;
+    unsigned    max_usec;
+} fs_async_stats;
+
 #if USE_ZLIB
 // local stream used for all file loads
 static zipstream_t  fs_zipstream;
@@ -202,8 +270,18 @@ static void open_zip_file(file_t *file);
 static void close_zip_file(file_t *file);
 static int tell_zip_file(file_t *file);
 static int read_zip_file(file_t *file, void *buf, size_t len);
+
+static int close_bgzf_file(file_t *file);
+static int64_t tell_bgzf_file(file_t *file);
+static int seek_bgzf_file(file_t *file, int64_t offset);
+static int read_bgzf_file(file_t *file, void *buf, size_t len);
+static int write_bgzf_file(file_t *file, const void *buf, size_t len);
+static int flush_bgzf_file(file_t *file);
 #endif
 
+static int finish_async_writes(file_t *file);
+static void close_async_file(file_t *file);
+
 // for tracking users of pack_t instance
 // allows FS to be restarted while reading something from pack
 static pack_t *pack_get(pack_t *pack);
@@ -476,6 +554,30 @@ int64_t FS_Length(qhandle_t f)
     return Q_ERR_NOSYS;
 }
 
+/*
+================
+FS_GetFileInfo
+
+Returns cached file length and modification time. Only works for files
+opened directly from disk.
+================
+*/
+int FS_GetFileInfo(qhandle_t f, file_info_t *info)
+{
+    file_t *file = file_for_handle(f);
+
+    if (!file)
+        return Q_ERR_BADF;
+
+    if ((file->mode & FS_MODE_MASK) != FS_MODE_READ || !file->mtime)
+        return Q_ERR_NOSYS;
+
+    info->size = file->length;
+    info->ctime = 0;
+    info->mtime = file->mtime;
+    return Q_ERR_SUCCESS;
+}
+
 /*
 ============
 FS_Tell
@@ -489,6 +591,9 @@ int64_t FS_Tell(qhandle_t f)
     if (!file)
         return Q_ERR_BADF;
 
+    if (file->async)
+        return file->async->pos;
+
     switch (file->type) {
     case FS_REAL:
         ret = os_ftell(file->fp);
@@ -507,6 +612,8 @@ int64_t FS_Tell(qhandle_t f)
             return Q_ERR_LIBRARY_ERROR;
         }
         return ret;
+    case FS_BGZF:
+        return tell_bgzf_file(file);
 #endif
     default:
         return Q_ERR_NOSYS;
@@ -528,23 +635,8 @@ static int seek_pak_file(file_t *file, int64_t offset)
     return Q_ERR_SUCCESS;
 }
 
-/*
-============
-FS_Seek
-
-Seeks to an absolute position within the file.
-============
-*/
-int FS_Seek(qhandle_t f, int64_t offset)
+static int seek_file(file_t *file, int64_t offset)
 {
-    file_t *file = file_for_handle(f);
-
-    if (!file)
-        return Q_ERR_BADF;
-
-    if (offset < 0)
-        offset = 0;
-
     switch (file->type) {
     case FS_REAL:
         if (os_fseek(file->fp, offset, SEEK_SET) == -1) {
@@ -559,12 +651,47 @@ int FS_Seek(qhandle_t f, int64_t offset)
             return Q_ERR_LIBRARY_ERROR;
         }
         return Q_ERR_SUCCESS;
+    case FS_BGZF:
+        return seek_bgzf_file(file, offset);
 #endif
     default:
         return Q_ERR_NOSYS;
     }
 }
 
+/*
+============
+FS_Seek
+
+Seeks to an absolute position within the file.
+============
+*/
+int FS_Seek(qhandle_t f, int64_t offset)
+{
+    file_t *file = file_for_handle(f);
+    int ret;
+
+    if (!file)
+        return Q_ERR_BADF;
+
+    if (offset < 0)
+        offset = 0;
+
+    if (!file->async)
+        return seek_file(file, offset);
+
+    ret = finish_async_writes(file);
+    if (ret)
+        return ret;
+
+    ret = seek_file(file, offset);
+    if (ret)
+        return ret;
+
+    file->async->pos = offset;
+    return Q_ERR_SUCCESS;
+}
+
 /*
 ============
 FS_CreatePath
@@ -629,6 +756,9 @@ int FS_FCloseFile(qhandle_t f)
     if (!file)
         return Q_ERR_BADF;
 
+    if (file->async)
+        close_async_file(file);
+
     ret = file->error;
     switch (file->type) {
     case FS_REAL:
@@ -652,6 +782,10 @@ int FS_FCloseFile(qhandle_t f)
             pack_put(file->pack);
         }
         break;
+    case FS_BGZF:
+        if (close_bgzf_file(file) && !ret)
+            ret = Q_ERR_FAILURE;
+        break;
 #endif
     default:
         ret = Q_ERR_NOSYS;
@@ -801,17 +935,44 @@ fail:
     return ret;
 }
 
+#if USE_ZLIB
+static voidpf FS_zalloc(voidpf opaque, uInt items, uInt size);
+static void FS_zfree(voidpf opaque, voidpf address);
+#endif
+
+// gzip files are always written in BGZF format
 static int64_t open_file_write_gzip(file_t *file, const char *fullpath, const char *mode_str)
 {
 #if USE_ZLIB
-    void *zfp = gzopen(fullpath, mode_str);
-    if (!zfp)
+    bgzfstream_t *s;
+    z_streamp z;
+    int64_t ret;
+
+    ret = open_file_write_real(file, fullpath, mode_str);
+    if (ret < 0)
+        return ret;
+
+    s = FS_Malloc(sizeof(*s));
+    memset(&s->stream, 0, sizeof(s->stream));
+    s->blocks = NULL;
+    s->numblocks = 0;
+    s->curblock = -1;
+    s->upos = s->ulen = 0;
+    s->written = 0;
+
+    z = &s->stream;
+    z->zalloc = FS_zalloc;
+    z->zfree = FS_zfree;
+    if (deflateInit2(z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                     -MAX_WBITS, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        Z_Free(s);
+        fclose(file->fp);
+        memset(file, 0, sizeof(*file));
         return Q_ERR_LIBRARY_ERROR;
+    }
 
-    file->type = FS_GZ;
-    file->zfp = zfp;
-    file->unique = true;
-    file->error = Q_ERR_SUCCESS;
+    file->type = FS_BGZF;
+    file->zfp = s;
     return 0;
 #else
     return Q_ERR_NOSYS;
@@ -1074,6 +1235,299 @@ static int read_zip_file(file_t *file, void *buf, size_t len)
     return len;
 }
 
+static const byte bgzf_header[BGZF_HEADER - 2] = {
+    0x1f, 0x8b, Z_DEFLATED, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0
+};
+
+static const byte bgzf_eof[BGZF_HEADER + BGZF_FOOTER + 2] = {
+    0x1f, 0x8b, Z_DEFLATED, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0,
+    27, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static bool bgzf_check_header(const byte *h)
+{
+    return h[0] == 0x1f && h[1] == 0x8b && h[2] == Z_DEFLATED && (h[3] & 4)
+        && LittleShortMem(&h[10]) == 6 && h[12] == 'B' && h[13] == 'C'
+        && LittleShortMem(&h[14]) == 2;
+}
+
+static void bgzf_write_long(byte *p, uint32_t v)
+{
+    p[0] = v & 255;
+    p[1] = (v >> 8) & 255;
+    p[2] = (v >> 16) & 255;
+    p[3] = v >> 24;
+}
+
+// compresses and writes out pending uncompressed data as a single block
+static int flush_bgzf_file(file_t *file)
+{
+    bgzfstream_t *s = file->zfp;
+    z_streamp z = &s->stream;
+    byte *p = s->cbuf + BGZF_HEADER;
+    size_t len;
+
+    if (file->error)
+        return file->error;
+
+    if (!s->ulen)
+        return Q_ERR_SUCCESS;
+
+    deflateReset(z);
+    z->next_in = s->ubuf;
+    z->avail_in = s->ulen;
+    z->next_out = p;
+    z->avail_out = BGZF_MAXBLOCK - BGZF_HEADER - BGZF_FOOTER;
+
+    if (deflate(z, Z_FINISH) == Z_STREAM_END) {
+        len = z->total_out;
+    } else {
+        // incompressible data, write a single stored block
+        p[0] = 1;
+        p[1] = s->ulen & 255;
+        p[2] = s->ulen >> 8;
+        p[3] = ~s->ulen & 255;
+        p[4] = (~s->ulen >> 8) & 255;
+        memcpy(p + 5, s->ubuf, s->ulen);
+        len = s->ulen + 5;
+    }
+
+    len += BGZF_HEADER + BGZF_FOOTER;
+    memcpy(s->cbuf, bgzf_header, sizeof(bgzf_header));
+    s->cbuf[16] = (len - 1) & 255;
+    s->cbuf[17] = (len - 1) >> 8;
+    bgzf_write_long(s->cbuf + len - 8, crc32(0, s->ubuf, s->ulen));
+    bgzf_write_long(s->cbuf + len - 4, s->ulen);
+
+    s->ulen = 0;
+
+    if (fwrite(s->cbuf, 1, len, file->fp) != len)
+        file->error = FS_ERR_WRITE(file->fp);
+
+    return file->error;
+}
+
+static int write_bgzf_file(file_t *file, const void *buf, size_t len)
+{
+    bgzfstream_t *s = file->zfp;
+    size_t block, total = len;
+
+    while (len) {
+        block = min(len, BGZF_BLOCKLEN - s->ulen);
+        memcpy(s->ubuf + s->ulen, buf, block);
+        s->ulen += block;
+        buf = (const byte *)buf + block;
+        len -= block;
+
+        if (s->ulen == BGZF_BLOCKLEN && flush_bgzf_file(file))
+            return file->error;
+    }
+
+    s->written += total;
+    return total;
+}
+
+// finds all blocks by following compressed block sizes in headers.
+// returns 1 if the file is BGZF, 0 if it is a regular gzip file.
+static int open_bgzf_file(file_t *file)
+{
+    byte header[BGZF_HEADER];
+    bgzfstream_t *s;
+    bgzfblock_t *blocks = NULL;
+    int64_t pos, total;
+    unsigned csize, usize;
+    int numblocks = 0;
+
+    for (pos = total = 0; pos + BGZF_HEADER + BGZF_FOOTER <= file->length; pos += csize) {
+        if (os_fseek(file->fp, pos, SEEK_SET) == -1)
+            goto fail;
+        if (fread(header, 1, BGZF_HEADER, file->fp) != BGZF_HEADER)
+            goto fail;
+        if (!bgzf_check_header(header)) {
+            if (!pos)
+                return 0;
+            break;  // trailing garbage
+        }
+
+        csize = LittleShortMem(&header[16]) + 1;
+        if (csize < BGZF_HEADER + BGZF_FOOTER || pos + csize > file->length)
+            break;  // truncated
+
+        if (os_fseek(file->fp, pos + csize - 4, SEEK_SET) == -1)
+            goto fail;
+        if (fread(header, 1, 4, file->fp) != 4)
+            goto fail;
+        usize = LittleLongMem(header);
+        if (usize > BGZF_MAXBLOCK)
+            break;
+        if (!usize)
+            continue;   // EOF marker
+
+        if (!(numblocks & 1023))
+            blocks = Z_Realloc(blocks, sizeof(blocks[0]) * (numblocks + 1024));
+        blocks[numblocks].coffset = pos;
+        blocks[numblocks].uoffset = total;
+        blocks[numblocks].csize = csize;
+        blocks[numblocks].usize = usize;
+        numblocks++;
+        total += usize;
+    }
+
+    s = FS_Malloc(sizeof(*s));
+    memset(&s->stream, 0, sizeof(s->stream));
+    s->stream.zalloc = FS_zalloc;
+    s->stream.zfree = FS_zfree;
+    if (inflateInit2(&s->stream, -MAX_WBITS) != Z_OK) {
+        Com_Error(ERR_FATAL, "%s: inflateInit2() failed", __func__);
+    }
+    s->blocks = blocks;
+    s->numblocks = numblocks;
+    s->curblock = -1;
+    s->upos = s->ulen = 0;
+    s->written = 0;
+
+    file->type = FS_BGZF;
+    file->zfp = s;
+    file->length = total;
+    return 1;
+
+fail:
+    Z_Free(blocks);
+    return FS_ERR_READ(file->fp);
+}
+
+static int close_bgzf_file(file_t *file)
+{
+    bgzfstream_t *s = file->zfp;
+    int ret = 0;
+
+    if ((file->mode & FS_MODE_MASK) == FS_MODE_READ) {
+        inflateEnd(&s->stream);
+    } else {
+        if (flush_bgzf_file(file))
+            ret = -1;
+        else if (fwrite(bgzf_eof, 1, sizeof(bgzf_eof), file->fp) != sizeof(bgzf_eof))
+            ret = -1;
+        deflateEnd(&s->stream);
+    }
+
+    if (fclose(file->fp))
+        ret = -1;
+
+    Z_Free(s->blocks);
+    Z_Free(s);
+    return ret;
+}
+
+static int load_bgzf_block(file_t *file, int n)
+{
+    bgzfstream_t *s = file->zfp;
+    bgzfblock_t *b = &s->blocks[n];
+    z_streamp z = &s->stream;
+
+    if (os_fseek(file->fp, b->coffset, SEEK_SET) == -1)
+        return Q_ERRNO;
+
+    if (fread(s->cbuf, 1, b->csize, file->fp) != b->csize)
+        return FS_ERR_READ(file->fp);
+
+    inflateReset(z);
+    z->next_in = s->cbuf + BGZF_HEADER;
+    z->avail_in = b->csize - BGZF_HEADER - BGZF_FOOTER;
+    z->next_out = s->ubuf;
+    z->avail_out = b->usize;
+
+    if (inflate(z, Z_FINISH) != Z_STREAM_END || z->avail_out)
+        return Q_ERR_INFLATE_FAILED;
+
+    if (crc32(0, s->ubuf, b->usize) != LittleLongMem(s->cbuf + b->csize - 8))
+        return Q_ERR_INFLATE_FAILED;
+
+    s->curblock = n;
+    s->upos = 0;
+    s->ulen = b->usize;
+    return Q_ERR_SUCCESS;
+}
+
+static int64_t tell_bgzf_file(file_t *file)
+{
+    bgzfstream_t *s = file->zfp;
+
+    if ((file->mode & FS_MODE_MASK) != FS_MODE_READ)
+        return s->written;
+
+    if (s->curblock < 0)
+        return 0;
+
+    return s->blocks[s->curblock].uoffset + s->upos;
+}
+
+static int seek_bgzf_file(file_t *file, int64_t offset)
+{
+    bgzfstream_t *s = file->zfp;
+    int ret, left, right, mid;
+
+    if ((file->mode & FS_MODE_MASK) != FS_MODE_READ)
+        return Q_ERR_NOSYS;
+
+    if (!s->numblocks)
+        return Q_ERR_SUCCESS;
+
+    if (offset > file->length)
+        offset = file->length;
+
+    // find the last block starting at or before offset
+    left = 0;
+    right = s->numblocks - 1;
+    while (left < right) {
+        mid = (left + right + 1) / 2;
+        if (s->blocks[mid].uoffset <= offset)
+            left = mid;
+        else
+            right = mid - 1;
+    }
+
+    if (left != s->curblock) {
+        ret = load_bgzf_block(file, left);
+        if (ret) {
+            file->error = ret;
+            return ret;
+        }
+    }
+
+    s->upos = offset - s->blocks[left].uoffset;
+    file->error = Q_ERR_SUCCESS;
+    return Q_ERR_SUCCESS;
+}
+
+static int read_bgzf_file(file_t *file, void *buf, size_t len)
+{
+    bgzfstream_t *s = file->zfp;
+    size_t block, total = 0;
+    int ret;
+
+    while (len) {
+        if (s->upos == s->ulen) {
+            if (s->curblock + 1 >= s->numblocks)
+                break;
+            ret = load_bgzf_block(file, s->curblock + 1);
+            if (ret) {
+                file->error = ret;
+                return total ? total : ret;
+            }
+        }
+
+        block = min(len, s->ulen - s->upos);
+        memcpy(buf, s->ubuf + s->upos, block);
+        s->upos += block;
+        buf = (byte *)buf + block;
+        len -= block;
+        total += block;
+    }
+
+    return total;
+}
+
 #endif
 
 // open a new file on the pakfile
@@ -1156,6 +1610,7 @@ static int check_for_gzip(file_t *file, const char *fullpath)
 {
     uint32_t magic, length;
     void *zfp;
+    int ret;
 
     // should have at least 10 bytes of header and 8 bytes of trailer
     if (file->length < 18) {
@@ -1176,6 +1631,12 @@ static int check_for_gzip(file_t *file, const char *fullpath)
         return 0;
     }
 
+    // check for seekable BGZF
+    ret = open_bgzf_file(file);
+    if (ret) {
+        return ret;
+    }
+
     // seek to the trailer
     if (os_fseek(file->fp, file->length - 4, SEEK_SET) == -1) {
         return Q_ERRNO;
@@ -1224,16 +1685,18 @@ static int64_t open_from_disk(file_t *file, const char *fullpath)
     file->unique = true;
     file->error = Q_ERR_SUCCESS;
     file->length = info.size;
+    file->mtime = info.mtime;
 
 #if USE_ZLIB
     if (file->mode & FS_FLAG_GZIP) {
         ret = check_for_gzip(file, fullpath);
-        if (ret) {
+        if (ret < 0) {
+            fclose(fp);
+            memset(file, 0, sizeof(*file));
+            goto fail;
+        }
+        if (ret > 0 && file->type == FS_GZ) {
             fclose(fp);
-            if (ret < 0) {
-                memset(file, 0, sizeof(*file));
-                goto fail;
-            }
         }
     }
 #endif
@@ -1472,6 +1935,8 @@ int FS_Read(void *buf, size_t len, qhandle_t f)
         return ret;
     case FS_ZIP:
         return read_zip_file(file, buf, len);
+    case FS_BGZF:
+        return read_bgzf_file(file, buf, len);
 #endif
     default:
         return Q_ERR_NOSYS;
@@ -1512,6 +1977,9 @@ void FS_Flush(qhandle_t f)
     if (!file)
         return;
 
+    if (file->async && finish_async_writes(file))
+        return;
+
     switch (file->type) {
     case FS_REAL:
         fflush(file->fp);
@@ -1520,12 +1988,186 @@ void FS_Flush(qhandle_t f)
     case FS_GZ:
         gzflush(file->zfp, Z_SYNC_FLUSH);
         break;
+    case FS_BGZF:
+        if ((file->mode & FS_MODE_MASK) != FS_MODE_READ)
+            flush_bgzf_file(file);
+        break;
 #endif
     default:
         break;
     }
 }
 
+static int write_file_data(file_t *file, const void *buf, size_t len)
+{
+    switch (file->type) {
+    case FS_REAL:
+        if (fwrite(buf, 1, len, file->fp) != len) {
+            file->error = FS_ERR_WRITE(file->fp);
+            return file->error;
+        }
+        break;
+#if USE_ZLIB
+    case FS_GZ:
+        if (gzwrite(file->zfp, buf, len) != len) {
+            file->error = Q_ERR_LIBRARY_ERROR;
+            return file->error;
+        }
+        break;
+    case FS_BGZF:
+        return write_bgzf_file(file, buf, len);
+#endif
+    default:
+        Com_Error(ERR_FATAL, "%s: bad file type", __func__);
+    }
+
+    return len;
+}
+
+/*
+===============================================================================
+
+ASYNC WRITES
+
+Files opened with FS_FLAG_ASYNC are written by the async work thread. Data
+is appended to one of two buffers, each full buffer is queued for writing
+(and compression, for gzip files) while the other one is being filled. If
+the thread falls behind so that both buffers are queued, the writer blocks
+until it catches up. Pending data is written out on flush and close.
+
+===============================================================================
+*/
+
+static void async_write_work(void *arg)
+{
+    asyncbuf_t *buf = arg;
+    uint64_t start = Sys_Microseconds();
+    int ret;
+
+    // can't continue after error
+    if (buf->file->error)
+        ret = buf->file->error;
+    else
+        ret = write_file_data(buf->file, buf->data, buf->len);
+
+    buf->error = ret < 0 ? ret : 0;
+    buf->usec = Sys_Microseconds() - start;
+}
+
+static void async_write_done(void *arg)
+{
+    asyncbuf_t *buf = arg;
+    asyncfile_t *async = buf->file->async;
+
+    if (buf->error && !async->error)
+        async->error = buf->error;
+
+    fs_async_stats.depth--;
+    fs_async_stats.writes++;
+    fs_async_stats.bytes += buf->len;
+    fs_async_stats.total_usec += buf->usec;
+    fs_async_stats.max_usec = max(fs_async_stats.max_usec, buf->usec);
+
+    buf->len = 0;
+    buf->pending = false;
+    async->pending--;
+}
+
+static void submit_async_buffer(asyncfile_t *async)
+{
+    asyncbuf_t *buf = &async->bufs[async->current];
+    asyncwork_t work = {
+        .work_cb = async_write_work,
+        .done_cb = async_write_done,
+        .cb_arg = buf,
+    };
+
+    if (!buf->len)
+        return;
+
+    buf->pending = true;
+    async->pending++;
+    Sys_QueueAsyncWork(&work);
+
+    fs_async_stats.depth++;
+    fs_async_stats.peak = max(fs_async_stats.peak, fs_async_stats.depth);
+
+    async->current = (async->current + 1) % ASYNC_BUFFERS;
+}
+
+static int write_async_file(file_t *file, const void *data, size_t len)
+{
+    asyncfile_t *async = file->async;
+    asyncbuf_t *buf;
+    size_t block, total = len;
+
+    while (len) {
+        buf = &async->bufs[async->current];
+        if (buf->pending) {
+            // work thread fell behind, wait for it
+            fs_async_stats.stalls++;
+            Sys_WaitAsyncWork(&async->pending);
+        }
+
+        if (async->error)
+            return async->error;
+
+        block = min(len, async->size - buf->len);
+        memcpy(buf->data + buf->len, data, block);
+        buf->len += block;
+        data = (const byte *)data + block;
+        len -= block;
+
+        if (buf->len == async->size)
+            submit_async_buffer(async);
+    }
+
+    async->pos += total;
+    return total;
+}
+
+// queues partially filled buffer and waits for all writes to complete
+static int finish_async_writes(file_t *file)
+{
+    asyncfile_t *async = file->async;
+
+    submit_async_buffer(async);
+    Sys_WaitAsyncWork(&async->pending);
+
+    return async->error;
+}
+
+static void open_async_file(file_t *file, int64_t pos)
+{
+    asyncfile_t *async;
+    int i;
+
+    async = FS_Mallocz(sizeof(*async));
+    async->size = Cvar_ClampInteger(fs_async_bufsize, 4, 4096) * 1024;
+    async->pos = pos;
+    for (i = 0; i < ASYNC_BUFFERS; i++) {
+        async->bufs[i].file = file;
+        async->bufs[i].data = FS_Malloc(async->size);
+    }
+
+    file->async = async;
+}
+
+static void close_async_file(file_t *file)
+{
+    asyncfile_t *async = file->async;
+    int i;
+
+    // errors are also recorded in file->error by work thread
+    finish_async_writes(file);
+
+    for (i = 0; i < ASYNC_BUFFERS; i++)
+        Z_Free(async->bufs[i].data);
+    Z_Free(async);
+
+    file->async = NULL;
+}
+
 /*
 =================
 FS_Write
@@ -1541,36 +2183,20 @@ int FS_Write(const void *buf, size_t len, qhandle_t f)
     if ((file->mode & FS_MODE_MASK) == FS_MODE_READ)
         return Q_ERR_INVAL;
 
+    if (len > INT_MAX)
+        return Q_ERR_INVAL;
+
+    if (file->async)
+        return len ? write_async_file(file, buf, len) : 0;
+
     // can't continue after error
     if (file->error)
         return file->error;
 
-    if (len > INT_MAX)
-        return Q_ERR_INVAL;
-
     if (len == 0)
         return 0;
 
-    switch (file->type) {
-    case FS_REAL:
-        if (fwrite(buf, 1, len, file->fp) != len) {
-            file->error = Q_ERR_FAILURE;
-            return file->error;
-        }
-        break;
-#if USE_ZLIB
-    case FS_GZ:
-        if (gzwrite(file->zfp, buf, len) != len) {
-            file->error = Q_ERR_LIBRARY_ERROR;
-            return file->error;
-        }
-        break;
-#endif
-    default:
-        Com_Error(ERR_FATAL, "%s: bad file type", __func__);
-    }
-
-    return len;
+    return write_file_data(file, buf, len);
 }
 
 /*
@@ -1606,6 +2232,8 @@ int64_t FS_FOpenFile(const char *name, qhandle_t *f, unsigned mode)
         ret = expand_open_file_read(file, name, true);
     } else {
         ret = open_file_write(file, name);
+        if (ret >= 0 && (mode & FS_FLAG_ASYNC) && fs_async_writes->integer)
+            open_async_file(file, ret);
     }
 
     if (ret >= 0) {
@@ -1859,8 +2487,6 @@ bool FS_EasyWriteFile(char *buf, size_t size, unsigned mode,
     return true;
 }
 
-#if USE_CLIENT
-
 static int build_absolute_path(char *buffer, const char *path)
 {
     char normalized[MAX_OSPATH];
@@ -1880,6 +2506,26 @@ static int build_absolute_path(char *buffer, const char *path)
     return Q_ERR_SUCCESS;
 }
 
+/*
+================
+FS_RemoveFile
+================
+*/
+int FS_RemoveFile(const char *path)
+{
+    char fullpath[MAX_OSPATH];
+    int ret;
+
+    if ((ret = build_absolute_path(fullpath, path)))
+        return ret;
+    if (remove(fullpath))
+        return Q_ERRNO;
+
+    return Q_ERR_SUCCESS;
+}
+
+#if USE_CLIENT
+
 /*
 ================
 FS_RenameFile
@@ -3072,6 +3718,33 @@ static void FS_Path_f(void)
 #endif
 }
 
+/*
+================
+FS_AsyncStats_f
+================
+*/
+static void FS_AsyncStats_f(void)
+{
+    unsigned writes = fs_async_stats.writes;
+
+    if (Cmd_Argc() > 1 && !strcmp(Cmd_Argv(1), "reset")) {
+        fs_async_stats.peak = fs_async_stats.depth;
+        fs_async_stats.writes = 0;
+        fs_async_stats.stalls = 0;
+        fs_async_stats.bytes = 0;
+        fs_async_stats.total_usec = 0;
+        fs_async_stats.max_usec = 0;
+        return;
+    }
+
+    Com_Printf("Queue depth: %d (peak %d)\n", fs_async_stats.depth, fs_async_stats.peak);
+    Com_Printf("Buffers written: %u (%"PRIu64" bytes)\n", writes, fs_async_stats.bytes);
+    Com_Printf("Writer stalls: %u\n", fs_async_stats.stalls);
+    Com_Printf("Write latency: %.2f ms avg, %.2f ms max\n",
+               writes ? fs_async_stats.total_usec * 1e-3 / writes : 0.0,
+               fs_async_stats.max_usec * 1e-3);
+}
+
 #if USE_DEBUG
 /*
 ================
@@ -3416,6 +4089,7 @@ static const cmdreg_t c_fs[] = {
     { "softlink", FS_Link_f, FS_Link_c },
     { "softunlink", FS_UnLink_f, FS_Link_c },
     { "fs_restart", FS_Restart_f },
+    { "fs_asyncstats", FS_AsyncStats_f },
 
     { NULL }
 };
@@ -3523,6 +4197,9 @@ void FS_Init(void)
     fs_debug = Cvar_Get("fs_debug", "0", 0);
 #endif
 
+    fs_async_writes = Cvar_Get("fs_async_writes", "1", 0);
+    fs_async_bufsize = Cvar_Get("fs_async_bufsize", "64", 0);
+
     // get the game cvar and start the filesystem
     fs_game = Cvar_Get("game", DEFGAME, CVAR_LATCH | CVAR_SERVERINFO);
     fs_game->changed = fs_game_changed;
@@ -213,8 +213,6 @@ void MSG_WriteAngle(float f)
     MSG_WriteByte(ANGLE2BYTE(f));
 }
 
-#if USE_CLIENT
-
 /*
 =============
 MSG_WriteDeltaUsercmd
@@ -307,6 +305,8 @@ int MSG_WriteDeltaUsercmd(const usercmd_t *from, const usercmd_t *cmd, int versi
     return bits;
 }
 
+#if USE_CLIENT
+
 /*
 =============
 MSG_WriteBits
@@ -1513,14 +1513,14 @@ size_t MSG_ReadStringLine(char *dest, size_t size)
     return len;
 }
 
-#if USE_CLIENT || USE_MVD_CLIENT
+#if USE_CLIENT || USE_MVD_CLIENT || USE_SWARM
 
 static inline float MSG_ReadCoord(void)
 {
     return SHORT2COORD(MSG_ReadShort());
 }
 
-#if !USE_CLIENT
+#if !USE_CLIENT && !USE_SWARM
 static inline
 #endif
 void MSG_ReadPos(vec3_t pos)
@@ -1785,7 +1785,7 @@ void MSG_ReadDeltaUsercmd_Enhanced(const usercmd_t *from,
     }
 }
 
-#if USE_CLIENT || USE_MVD_CLIENT
+#if USE_CLIENT || USE_MVD_CLIENT || USE_SWARM
 
 /*
 =================
@@ -1944,9 +1944,9 @@ void MSG_ParseDeltaEntity(const entity_state_t *from,
     }
 }
 
-#endif // USE_CLIENT || USE_MVD_CLIENT
+#endif // USE_CLIENT || USE_MVD_CLIENT || USE_SWARM
 
-#if USE_CLIENT
+#if USE_CLIENT || USE_SWARM
 
 /*
 ===================
@@ -2059,6 +2059,9 @@ void MSG_ParseDeltaPlayerstate_Default(const player_state_t *from,
             to->stats[i] = MSG_ReadShort();
 }
 
+#endif // USE_CLIENT || USE_SWARM
+
+#if USE_CLIENT
 
 /*
 ===================
@@ -2490,6 +2493,8 @@ const char *MSG_ServerCommandString(int cmd)
         S(zpacket)
         S(zdownload)
         S(gamestate)
+        S(setting)
+        S(zstream)
 #undef S
     }
 }
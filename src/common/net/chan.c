@@ -95,6 +95,9 @@ static cvar_t       *showdrop;
 #define SHOWDROP(...)
 #endif
 
+// maximum size of fragmented packet header (sequence, ack, qport, offset)
+#define FRAGMENT_HEADER     11
+
 cvar_t      *net_qport;
 cvar_t      *net_maxmsglen;
 cvar_t      *net_chantype;
@@ -161,6 +164,19 @@ void Netchan_OutOfBand(netsrc_t sock, const netadr_t *address, const char *forma
 
 // ============================================================================
 
+static void Netchan_SendPacket(netchan_t *chan, const void *data, size_t len)
+{
+#if USE_SWARM
+    if (chan->socket != -1) {
+        NET_SendSocketPacket(chan->socket, data, len, &chan->remote_address);
+        return;
+    }
+#endif
+    NET_SendPacket(chan->sock, data, len, &chan->remote_address);
+}
+
+// ============================================================================
+
 static size_t NetchanOld_TransmitNextFragment(netchan_t *netchan)
 {
     Com_Error(ERR_FATAL, "%s: not implemented", __func__);
@@ -222,7 +238,7 @@ static size_t NetchanOld_Transmit(netchan_t *chan, size_t length, const void *da
     SZ_WriteLong(&send, w1);
     SZ_WriteLong(&send, w2);
 
-#if USE_CLIENT
+#if USE_CLIENT || USE_SWARM
     // send the qport if we are a client
     if (chan->sock == NS_CLIENT) {
         if (chan->protocol < PROTOCOL_VERSION_R1Q2) {
@@ -257,7 +273,7 @@ static size_t NetchanOld_Transmit(netchan_t *chan, size_t length, const void *da
 
     // send the datagram
     for (i = 0; i < numpackets; i++) {
-        NET_SendPacket(chan->sock, send.data, send.cursize, &chan->remote_address);
+        Netchan_SendPacket(chan, send.data, send.cursize);
     }
 
     chan->outgoing_sequence++;
@@ -381,10 +397,11 @@ NetchanNew_TransmitNextFragment
 static size_t NetchanNew_TransmitNextFragment(netchan_t *chan)
 {
     sizebuf_t   send;
-    byte        send_buf[MAX_PACKETLEN];
+    byte        send_buf[FRAGMENT_HEADER];
     bool        send_reliable, more_fragments;
     int         w1, w2, offset;
     size_t      fragment_length;
+    byte        *data;
 
     send_reliable = chan->reliable_length;
 
@@ -402,7 +419,7 @@ static size_t NetchanNew_TransmitNextFragment(netchan_t *chan)
     SZ_WriteLong(&send, w1);
     SZ_WriteLong(&send, w2);
 
-#if USE_CLIENT
+#if USE_CLIENT || USE_SWARM
     // send the qport if we are a client
     if (chan->sock == NS_CLIENT && chan->qport) {
         SZ_WriteByte(&send, chan->qport);
@@ -425,12 +442,17 @@ static size_t NetchanNew_TransmitNextFragment(netchan_t *chan)
         offset |= 0x8000;
     SZ_WriteShort(&send, offset);
 
-    // write fragment contents
-    SZ_Write(&send, chan->fragment_out.data + chan->fragment_out.readcount, fragment_length);
+    // prepend the header to fragment contents in place. this overwrites the
+    // tail of previous fragment (or header space reserved before the buffer
+    // for the first one), which has already been sent and is never needed
+    // again, so the fragment payload itself is not copied.
+    data = chan->fragment_out.data + chan->fragment_out.readcount - send.cursize;
+    memcpy(data, send.data, send.cursize);
+    fragment_length += send.cursize;
 
     SHOWPACKET("send %4zu : s=%d ack=%d rack=%d "
                "fragment_offset=%zu more_fragments=%d",
-               send.cursize,
+               fragment_length,
                chan->outgoing_sequence,
                chan->incoming_sequence,
                chan->incoming_reliable_sequence,
@@ -441,7 +463,7 @@ static size_t NetchanNew_TransmitNextFragment(netchan_t *chan)
     }
     SHOWPACKET("\n");
 
-    chan->fragment_out.readcount += fragment_length;
+    chan->fragment_out.readcount += fragment_length - send.cursize;
     chan->fragment_pending = more_fragments;
 
     // if the message has been sent completely, clear the fragment buffer
@@ -452,9 +474,9 @@ static size_t NetchanNew_TransmitNextFragment(netchan_t *chan)
     }
 
     // send the datagram
-    NET_SendPacket(chan->sock, send.data, send.cursize, &chan->remote_address);
+    Netchan_SendPacket(chan, data, fragment_length);
 
-    return send.cursize;
+    return fragment_length;
 }
 
 /*
@@ -525,7 +547,7 @@ static size_t NetchanNew_Transmit(netchan_t *chan, size_t length, const void *da
     SZ_WriteLong(&send, w1);
     SZ_WriteLong(&send, w2);
 
-#if USE_CLIENT
+#if USE_CLIENT || USE_SWARM
     // send the qport if we are a client
     if (chan->sock == NS_CLIENT && chan->qport) {
         SZ_WriteByte(&send, chan->qport);
@@ -553,7 +575,7 @@ static size_t NetchanNew_Transmit(netchan_t *chan, size_t length, const void *da
 
     // send the datagram
     for (i = 0; i < numpackets; i++) {
-        NET_SendPacket(chan->sock, send.data, send.cursize, &chan->remote_address);
+        Netchan_SendPacket(chan, send.data, send.cursize);
     }
 
     chan->outgoing_sequence++;
@@ -673,9 +695,10 @@ static bool NetchanNew_Process(netchan_t *chan)
             return false;
         }
 
-        // message has been sucessfully assembled
-        SZ_Clear(&msg_read);
-        SZ_Write(&msg_read, chan->fragment_in.data, chan->fragment_in.cursize);
+        // message has been sucessfully assembled, read it in place. contents
+        // of fragment buffer remain valid until the next packet is processed.
+        SZ_Init(&msg_read, chan->fragment_in.data, chan->fragment_in.maxsize);
+        msg_read.cursize = chan->fragment_in.cursize;
         SZ_Clear(&chan->fragment_in);
     }
 
@@ -731,6 +754,9 @@ netchan_t *Netchan_Setup(netsrc_t sock, netchan_type_t type,
     chan->type = type;
     chan->protocol = protocol;
     chan->sock = sock;
+#if USE_SWARM
+    chan->socket = -1;
+#endif
     chan->remote_address = *adr;
     chan->qport = qport;
     chan->maxpacketlen = maxpacketlen;
@@ -758,10 +784,10 @@ netchan_t *Netchan_Setup(netsrc_t sock, netchan_type_t type,
         chan->TransmitNextFragment = NetchanNew_TransmitNextFragment;
         chan->ShouldUpdate = NetchanNew_ShouldUpdate;
 
-        chan->message_buf = Z_TagMalloc(MAX_MSGLEN * 4, tag);
+        chan->message_buf = Z_TagMalloc(MAX_MSGLEN * 4 + FRAGMENT_HEADER, tag);
         chan->reliable_buf = chan->message_buf + MAX_MSGLEN;
         chan->fragment_in_buf = chan->message_buf + MAX_MSGLEN * 2;
-        chan->fragment_out_buf = chan->message_buf + MAX_MSGLEN * 3;
+        chan->fragment_out_buf = chan->message_buf + MAX_MSGLEN * 3 + FRAGMENT_HEADER;
 
         SZ_Init(&chan->message, chan->message_buf, MAX_MSGLEN);
         SZ_TagInit(&chan->fragment_in, chan->fragment_in_buf, MAX_MSGLEN, SZ_NC_FRG_IN);
@@ -907,6 +907,55 @@ void NET_GetPackets(netsrc_t sock, void (*packet_cb)(void))
     NET_GetUdpPackets(udp6_sockets[sock], packet_cb);
 }
 
+#if USE_SWARM
+/*
+=============
+NET_GetSocketPackets
+
+Same as NET_GetPackets, but for a socket opened with NET_OpenSocket.
+=============
+*/
+void NET_GetSocketPackets(qsocket_t sock, void (*packet_cb)(void))
+{
+    NET_GetUdpPackets(sock, packet_cb);
+}
+#endif
+
+static bool NET_SendUdpPacket(qsocket_t s, const void *data,
+                              size_t len, const netadr_t *to)
+{
+    int ret;
+
+    if (s == -1)
+        return false;
+
+    ret = os_udp_send(s, data, len, to);
+    if (ret == NET_AGAIN)
+        return false;
+
+    if (ret == NET_ERROR) {
+        Com_DPrintf("%s: %s to %s\n", __func__,
+                    NET_ErrorString(), NET_AdrToString(to));
+        net_send_errors++;
+        return false;
+    }
+
+    if (ret < len)
+        Com_WPrintf("%s: short send to %s\n", __func__,
+                    NET_AdrToString(to));
+
+#if USE_DEBUG
+    if (net_log_enable->integer)
+        NET_LogPacket(to, "UDP send", data, ret);
+#endif
+
+    net_rate_sent += ret;
+    net_bytes_sent += ret;
+    net_packets_sent++;
+
+    return true;
+}
+
 /*
 =============
 NET_SendPacket
@@ -916,7 +965,6 @@ NET_SendPacket
 bool NET_SendPacket(netsrc_t sock, const void *data,
                     size_t len, const netadr_t *to)
 {
-    int ret;
     qsocket_t s;
 
     if (len == 0)
@@ -946,35 +994,35 @@ bool NET_SendPacket(netsrc_t sock, const void *data,
         Com_Error(ERR_FATAL, "%s: bad address type", __func__);
     }
 
-    if (s == -1)
-        return false;
+    return NET_SendUdpPacket(s, data, len, to);
+}
 
-    ret = os_udp_send(s, data, len, to);
-    if (ret == NET_AGAIN)
-        return false;
+#if USE_SWARM
+/*
+=============
+NET_SendSocketPacket
 
-    if (ret == NET_ERROR) {
-        Com_DPrintf("%s: %s to %s\n", __func__,
-                    NET_ErrorString(), NET_AdrToString(to));
-        net_send_errors++;
+Sends IPv4 packet through a socket opened with NET_OpenSocket.
+=============
+*/
+bool NET_SendSocketPacket(qsocket_t sock, const void *data,
+                          size_t len, const netadr_t *to)
+{
+    if (len == 0)
         return false;
-    }
 
-    if (ret < len)
-        Com_WPrintf("%s: short send to %s\n", __func__,
+    if (len > MAX_PACKETLEN) {
+        Com_EPrintf("%s: oversize packet to %s\n", __func__,
                     NET_AdrToString(to));
+        return false;
+    }
 
-#if USE_DEBUG
-    if (net_log_enable->integer)
-        NET_LogPacket(to, "UDP send", data, ret);
-#endif
-
-    net_rate_sent += ret;
-    net_bytes_sent += ret;
-    net_packets_sent++;
+    if (to->type != NA_IP)
+        return false;
 
-    return true;
+    return NET_SendUdpPacket(sock, data, len, to);
 }
+#endif
 
 //=============================================================================
 
@@ -1302,6 +1350,40 @@ static void NET_OpenClient6(void)
 }
 #endif
 
+#if USE_SWARM
+/*
+====================
+NET_OpenSocket
+
+Opens an IPv4 UDP socket bound to a random port, independent of
+NS_CLIENT and NS_SERVER sockets. Used by the client swarm to give
+each simulated player its own source address.
+====================
+*/
+qsocket_t NET_OpenSocket(void)
+{
+    ioentry_t *e;
+    qsocket_t s;
+
+    s = UDP_OpenSocket(net_ip->string, PORT_ANY, AF_INET);
+    if (s == -1)
+        return -1;
+
+    e = NET_AddFd(s);
+    e->wantread = true;
+    return s;
+}
+
+void NET_CloseSocket(qsocket_t sock)
+{
+    if (sock == -1)
+        return;
+
+    NET_RemoveFd(sock);
+    os_closesocket(sock);
+}
+#endif
+
 /*
 ====================
 NET_Config
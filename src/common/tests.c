@@ -22,6 +22,10 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "common/common.h"
 #include "common/files.h"
 #include "common/mdfour.h"
+#include "common/msg.h"
+#include "common/net/chan.h"
+#include "common/net/net.h"
+#include "common/protocol.h"
 #include "common/tests.h"
 #include "refresh/refresh.h"
 #include "system/system.h"
@@ -656,6 +660,96 @@ static void Com_MdfourTest_f(void)
     Com_Printf("%d failures, %d strings tested\n", errors, tests);
 }
 
+static netchan_t    *bench_chan;
+static netadr_t     bench_adr;
+static byte         bench_data[MAX_MSGLEN];
+static size_t       bench_size;
+static int          bench_received;
+static int          bench_errors;
+static uint64_t     bench_process_us;
+
+static void bench_packet(void)
+{
+    uint64_t start;
+    bool ret;
+
+    if (!NET_IsEqualAdr(&net_from, &bench_adr))
+        return;
+
+    start = Sys_Microseconds();
+    ret = bench_chan->Process(bench_chan);
+    bench_process_us += Sys_Microseconds() - start;
+    if (!ret)
+        return;
+
+    if (msg_read.cursize != bench_size ||
+        memcmp(msg_read.data + msg_read.readcount,
+               bench_data, msg_read.cursize - msg_read.readcount))
+        bench_errors++;
+
+    bench_received++;
+}
+
+// sends large fragmented messages to ourselves over server UDP socket
+static void Com_FragBench_f(void)
+{
+    netchan_t *send;
+    uint64_t start, end;
+    int i, count, packets;
+    size_t total;
+
+    if (!NET_GetAddress(NS_SERVER, &bench_adr) || bench_adr.type != NA_IP) {
+        Com_Printf("Server IPv4 socket not open.\n");
+        return;
+    }
+    if (!bench_adr.ip.u32[0])
+        bench_adr.ip.u32[0] = BigLong(0x7f000001);
+
+    count = Cmd_Argc() > 1 ? atoi(Cmd_Argv(1)) : 1000;
+    bench_size = Cmd_Argc() > 2 ? atoi(Cmd_Argv(2)) : MAX_MSGLEN;
+    clamp(count, 1, 1000000);
+    clamp(bench_size, MAX_PACKETLEN_WRITABLE_DEFAULT + 1, MAX_MSGLEN);
+
+    for (i = 0; i < bench_size; i++)
+        bench_data[i] = Q_rand();
+
+    send = Netchan_Setup(NS_SERVER, NETCHAN_NEW, &bench_adr, 0,
+                         MAX_PACKETLEN_WRITABLE_DEFAULT, PROTOCOL_VERSION_Q2PRO);
+    bench_chan = Netchan_Setup(NS_SERVER, NETCHAN_NEW, &bench_adr, 0,
+                               MAX_PACKETLEN_WRITABLE_DEFAULT, PROTOCOL_VERSION_Q2PRO);
+    bench_received = bench_errors = 0;
+    bench_process_us = 0;
+    total = packets = 0;
+
+    start = Sys_Microseconds();
+    for (i = 0; i < count; i++) {
+        total += send->Transmit(send, bench_size, bench_data, 1);
+        packets++;
+        while (send->fragment_pending) {
+            total += send->TransmitNextFragment(send);
+            packets++;
+        }
+        NET_Sleep(0);
+        NET_GetPackets(NS_SERVER, bench_packet);
+    }
+    end = Sys_Microseconds() - start;
+
+    Netchan_Close(send);
+    Netchan_Close(bench_chan);
+    bench_chan = NULL;
+
+    if (!end)
+        end = 1;
+
+    Com_Printf("%d/%d messages of %zu bytes received, %d corrupted\n",
+               bench_received, count, bench_size, bench_errors);
+    Com_Printf("%"PRIu64" usec total, %"PRIu64" usec processing\n",
+               end, bench_process_us);
+    Com_Printf("%.f packets/sec, %.f msgs/sec, %.1f MB/sec\n",
+               packets * 1e6 / end,
+               count * 1e6 / end, total / (double)end);
+}
+
 typedef struct {
     const char *ext;
     const char *name;
@@ -715,4 +809,5 @@ void TST_Init(void)
 #endif
     Cmd_AddCommand("mdfourtest", Com_MdfourTest_f);
     Cmd_AddCommand("extcmptest", Com_ExtCmpTest_f);
+    Cmd_AddCommand("fragbench", Com_FragBench_f);
 }
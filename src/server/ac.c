@@ -128,8 +128,8 @@ typedef struct {
 static ac_locals_t  ac;
 static ac_static_t  acs;
 
-static LIST_DECL(ac_required_list);
-static LIST_DECL(ac_exempt_list);
+static ADDRLIST_DECL(ac_required_list);
+static ADDRLIST_DECL(ac_exempt_list);
 
 static byte     ac_send_buffer[AC_SEND_SIZE];
 static byte     ac_recv_buffer[AC_RECV_SIZE];
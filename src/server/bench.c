@@ -0,0 +1,717 @@
+/*
+Copyright (C) 2003-2011 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// bench.c -- usercmd capture and replay benchmark
+//
+// Movement commands executed for clients can be captured into a compact
+// file, one block per server frame. Replaying such file restarts the server
+// on the captured map and connects synthetic clients without network peer,
+// each replaying one of captured command streams. Commands are delivered as
+// regular clc_move packets through netchan and packet parser, and every
+// packet acknowledges everything sent to the client so far. Server frames
+// are then run back to back, and frame rate, per phase timings, bytes sent
+// per client and memory allocations per frame are reported.
+//
+// File format is a header (magic, version, map name) followed by blocks of
+// 16-bit length and a sequence of (client slot, delta compressed usercmd)
+// pairs. Each usercmd is delta compressed against the previous usercmd of
+// the same slot, using the original protocol encoding.
+//
+
+#include "server.h"
+
+#define UCMD_MAGIC      MakeRawLong('U','C','M','D')
+#define UCMD_VERSION    1
+
+#define MAX_BLOCK_SIZE  0xffff
+#define MIN_CMD_SIZE    4       // slot, bits, msec, lightlevel
+#define MAX_FRAME_CMDS  (MAX_BLOCK_SIZE / MIN_CMD_SIZE)
+
+#define WARMUP_FRAMES   10
+
+typedef struct {
+    client_t    *client;
+    int         stream;
+    usercmd_t   oldest, oldcmd;     // backup commands sent with clc_move
+    uint64_t    bytes_sent;         // value of client counter at start
+} benchclient_t;
+
+typedef struct {
+    int         next;               // next command of the same stream
+    usercmd_t   cmd;
+} benchcmd_t;
+
+static struct {
+    usercmd_t   lastcmds[MAX_CLIENTS];  // delta compression base per slot
+    char        mapname[MAX_QPATH];
+
+    // capture
+    qhandle_t   recording;
+    sizebuf_t   block;
+    unsigned    numframes;
+    unsigned    overflows;
+
+    // replay
+    byte        *data;
+    size_t      len;
+    size_t      start;          // offset of the first block
+    size_t      pos;
+    int         streams[MAX_CLIENTS];   // slot -> stream index
+    int         numstreams;
+    benchclient_t   *clients;
+    int         numclients;
+    benchcmd_t  *cmds;
+    int         first[MAX_CLIENTS];     // stream -> first command of frame
+    int         last[MAX_CLIENTS];      // stream -> last command of frame
+    unsigned    frame;          // including warmup frames
+    unsigned    maxframes;
+    uint64_t    start_usec;
+    uint64_t    start_allocs;
+} bench;
+
+bool sv_cmdrecording;
+bool sv_benchmarking;
+
+/*
+==============================================================================
+
+CAPTURE
+
+==============================================================================
+*/
+
+static void rec_stop(void)
+{
+    int ret;
+
+    if (bench.overflows)
+        Com_WPrintf("%u movement commands didn't fit in frame blocks.\n",
+                    bench.overflows);
+
+    ret = FS_FCloseFile(bench.recording);
+    if (ret)
+        Com_EPrintf("Couldn't write movement commands: %s\n", Q_ErrorString(ret));
+    else
+        Com_Printf("Recorded %u frames of movement commands.\n", bench.numframes);
+
+    Z_Free(bench.block.data);
+    memset(&bench.block, 0, sizeof(bench.block));
+    bench.recording = 0;
+    sv_cmdrecording = false;
+}
+
+static void rec_frame(void)
+{
+    uint16_t len;
+    int ret;
+
+    len = LittleShort(bench.block.cursize);
+    ret = FS_Write(&len, 2, bench.recording);
+    if (ret != 2)
+        goto fail;
+    ret = FS_Write(bench.block.data, bench.block.cursize, bench.recording);
+    if (ret != bench.block.cursize)
+        goto fail;
+
+    SZ_Clear(&bench.block);
+    bench.numframes++;
+    return;
+
+fail:
+    Com_EPrintf("Couldn't write movement commands: %s\n",
+                Q_ErrorString(ret < 0 ? ret : Q_ERR_FAILURE));
+    rec_stop();
+}
+
+// same as MSG_WriteDeltaUsercmd for protocol 34, but into the given buffer
+static void encode_cmd(sizebuf_t *sb, const usercmd_t *from, const usercmd_t *cmd)
+{
+    int bits = 0;
+
+    if (cmd->angles[0] != from->angles[0])
+        bits |= CM_ANGLE1;
+    if (cmd->angles[1] != from->angles[1])
+        bits |= CM_ANGLE2;
+    if (cmd->angles[2] != from->angles[2])
+        bits |= CM_ANGLE3;
+    if (cmd->forwardmove != from->forwardmove)
+        bits |= CM_FORWARD;
+    if (cmd->sidemove != from->sidemove)
+        bits |= CM_SIDE;
+    if (cmd->upmove != from->upmove)
+        bits |= CM_UP;
+    if (cmd->buttons != from->buttons)
+        bits |= CM_BUTTONS;
+    if (cmd->impulse != from->impulse)
+        bits |= CM_IMPULSE;
+
+    SZ_WriteByte(sb, bits);
+
+    if (bits & CM_ANGLE1)
+        SZ_WriteShort(sb, cmd->angles[0]);
+    if (bits & CM_ANGLE2)
+        SZ_WriteShort(sb, cmd->angles[1]);
+    if (bits & CM_ANGLE3)
+        SZ_WriteShort(sb, cmd->angles[2]);
+    if (bits & CM_FORWARD)
+        SZ_WriteShort(sb, cmd->forwardmove);
+    if (bits & CM_SIDE)
+        SZ_WriteShort(sb, cmd->sidemove);
+    if (bits & CM_UP)
+        SZ_WriteShort(sb, cmd->upmove);
+    if (bits & CM_BUTTONS)
+        SZ_WriteByte(sb, cmd->buttons);
+    if (bits & CM_IMPULSE)
+        SZ_WriteByte(sb, cmd->impulse);
+
+    SZ_WriteByte(sb, cmd->msec);
+}
+
+/*
+==================
+SV_BenchmarkRecordCmd
+
+Called for each movement command about to be executed for sv_client.
+==================
+*/
+void SV_BenchmarkRecordCmd(const usercmd_t *cmd)
+{
+    usercmd_t *last = &bench.lastcmds[sv_client->slot];
+    byte buffer[32];
+    sizebuf_t sb;
+
+    // called from client think, msg_write may hold pending data
+    SZ_Init(&sb, buffer, sizeof(buffer));
+    SZ_WriteByte(&sb, sv_client->slot);
+    encode_cmd(&sb, last, cmd);
+    SZ_WriteByte(&sb, cmd->lightlevel);
+
+    if (bench.block.cursize + sb.cursize > bench.block.maxsize) {
+        bench.overflows++;
+    } else {
+        SZ_Write(&bench.block, sb.data, sb.cursize);
+        *last = *cmd;
+    }
+}
+
+static void SV_CmdRecord_f(void)
+{
+    char buffer[MAX_OSPATH];
+    byte header[4 + 2 + MAX_QPATH];
+    uint32_t magic = UCMD_MAGIC;
+    sizebuf_t sb;
+    qhandle_t f;
+    int ret;
+
+    if (Cmd_Argc() != 2) {
+        Com_Printf("Usage: %s <filename>\n", Cmd_Argv(0));
+        return;
+    }
+
+    if (sv.state != ss_game) {
+        Com_Printf("No server running.\n");
+        return;
+    }
+
+    if (sv_cmdrecording) {
+        Com_Printf("Already recording movement commands.\n");
+        return;
+    }
+
+    if (sv_benchmarking) {
+        Com_Printf("Can't record while running a benchmark.\n");
+        return;
+    }
+
+    f = FS_EasyOpenFile(buffer, sizeof(buffer), FS_MODE_WRITE | FS_FLAG_ASYNC,
+                        "bench/", Cmd_Argv(1), ".ucmd");
+    if (!f)
+        return;
+
+    SZ_Init(&sb, header, sizeof(header));
+    SZ_Write(&sb, &magic, 4);
+    SZ_WriteShort(&sb, UCMD_VERSION);
+    SZ_WriteString(&sb, sv.name);
+
+    ret = FS_Write(sb.data, sb.cursize, f);
+    if (ret != sb.cursize) {
+        Com_EPrintf("Couldn't write %s: %s\n", buffer,
+                    Q_ErrorString(ret < 0 ? ret : Q_ERR_FAILURE));
+        FS_FCloseFile(f);
+        return;
+    }
+
+    Com_Printf("Recording movement commands to %s\n", buffer);
+
+    memset(bench.lastcmds, 0, sizeof(bench.lastcmds));
+    Q_strlcpy(bench.mapname, sv.name, sizeof(bench.mapname));
+    SZ_Init(&bench.block, SV_Malloc(MAX_BLOCK_SIZE), MAX_BLOCK_SIZE);
+    bench.recording = f;
+    bench.numframes = 0;
+    bench.overflows = 0;
+    sv_cmdrecording = true;
+}
+
+static void SV_CmdStop_f(void)
+{
+    if (!sv_cmdrecording) {
+        Com_Printf("Not recording movement commands.\n");
+        return;
+    }
+
+    rec_stop();
+}
+
+/*
+==============================================================================
+
+REPLAY
+
+==============================================================================
+*/
+
+static void free_replay(void)
+{
+    FS_FreeFile(bench.data);
+    Z_Free(bench.clients);
+    Z_Free(bench.cmds);
+    bench.data = NULL;
+    bench.clients = NULL;
+    bench.cmds = NULL;
+    bench.numclients = 0;
+    sv_benchmarking = false;
+}
+
+// validates all blocks and assigns streams to slots with commands
+static int scan_blocks(void)
+{
+    int numframes = 0;
+    usercmd_t cmd;
+    size_t len;
+    int slot;
+
+    for (slot = 0; slot < MAX_CLIENTS; slot++)
+        bench.streams[slot] = -1;
+    bench.numstreams = 0;
+
+    for (bench.pos = bench.start; bench.pos < bench.len; bench.pos += 2 + len) {
+        if (bench.len - bench.pos < 2)
+            return -1;
+        len = LittleShortMem(bench.data + bench.pos);
+        if (len > bench.len - bench.pos - 2)
+            return -1;
+
+        SZ_Init(&msg_read, bench.data + bench.pos + 2, len);
+        msg_read.cursize = len;
+
+        while (msg_read.readcount < msg_read.cursize) {
+            slot = MSG_ReadByte();
+            if (slot >= MAX_CLIENTS)
+                return -1;
+            MSG_ReadDeltaUsercmd(NULL, &cmd);
+            if (msg_read.readcount > msg_read.cursize)
+                return -1;
+            if (bench.streams[slot] == -1)
+                bench.streams[slot] = bench.numstreams++;
+        }
+
+        numframes++;
+    }
+
+    return numframes;
+}
+
+static void clear_block(void)
+{
+    int i;
+
+    for (i = 0; i < bench.numstreams; i++)
+        bench.first[i] = bench.last[i] = -1;
+}
+
+// decodes commands of the next frame and links them per stream
+static bool read_block(void)
+{
+    benchcmd_t *c;
+    size_t len;
+    int i, slot, stream;
+
+    clear_block();
+
+    if (bench.pos >= bench.len)
+        return false;
+
+    len = LittleShortMem(bench.data + bench.pos);
+    SZ_Init(&msg_read, bench.data + bench.pos + 2, len);
+    msg_read.cursize = len;
+    bench.pos += 2 + len;
+
+    for (i = 0; msg_read.readcount < msg_read.cursize; i++) {
+        slot = MSG_ReadByte();
+        stream = bench.streams[slot];
+
+        c = &bench.cmds[i];
+        MSG_ReadDeltaUsercmd(&bench.lastcmds[slot], &c->cmd);
+        bench.lastcmds[slot] = c->cmd;
+        c->next = -1;
+
+        if (bench.last[stream] == -1)
+            bench.first[stream] = i;
+        else
+            bench.cmds[bench.last[stream]].next = i;
+        bench.last[stream] = i;
+    }
+
+    return true;
+}
+
+static void rewind_replay(void)
+{
+    memset(bench.lastcmds, 0, sizeof(bench.lastcmds));
+    bench.pos = bench.start;
+}
+
+// runs packet built in msg_write as if it was received from the client
+static void process_packet(client_t *cl)
+{
+    memcpy(msg_read_buffer, msg_write.data, msg_write.cursize);
+    SZ_Init(&msg_read, msg_read_buffer, sizeof(msg_read_buffer));
+    msg_read.cursize = msg_write.cursize;
+    SZ_Clear(&msg_write);
+
+    SV_ProcessClientPacket(cl);
+}
+
+// acknowledges everything sent to the client so far
+static void write_header(client_t *cl)
+{
+    netchan_t *chan = cl->netchan;
+
+    MSG_WriteLong(chan->incoming_sequence + 1);
+    MSG_WriteLong((chan->outgoing_sequence - 1) | ((unsigned)chan->reliable_sequence << 31));
+}
+
+static void write_cmd(const usercmd_t *from, const usercmd_t *cmd)
+{
+    MSG_WriteDeltaUsercmd(from, cmd, 0);
+    MSG_WriteByte(cmd->lightlevel);
+}
+
+static void send_begin(benchclient_t *bc)
+{
+    client_t *cl = bc->client;
+
+    write_header(cl);
+    MSG_WriteByte(clc_stringcmd);
+    MSG_WriteString("new");
+    MSG_WriteByte(clc_stringcmd);
+    MSG_WriteString(va("begin %i\n", cl->spawncount));
+    process_packet(cl);
+}
+
+static void send_move(benchclient_t *bc, const usercmd_t *cmd)
+{
+    client_t *cl = bc->client;
+
+    write_header(cl);
+    if (cmd) {
+        MSG_WriteByte(clc_move);
+        MSG_WriteLong(cl->framenum > 1 ? cl->framenum - 1 : -1);
+        write_cmd(NULL, &bc->oldest);
+        write_cmd(&bc->oldest, &bc->oldcmd);
+        write_cmd(&bc->oldcmd, cmd);
+        bc->oldest = bc->oldcmd;
+        bc->oldcmd = *cmd;
+    }
+    process_packet(cl);
+}
+
+static void send_packets(void)
+{
+    benchclient_t *bc;
+    int i, j;
+
+    for (i = 0, bc = bench.clients; i < bench.numclients; i++, bc++) {
+        if (!bc->client)
+            continue;
+
+        // kicked by the game or operator
+        if (bc->client->state <= cs_zombie) {
+            bc->client = NULL;
+            continue;
+        }
+
+        if (!bench.frame) {
+            send_begin(bc);
+            continue;
+        }
+
+        j = bench.first[bc->stream];
+        if (j == -1) {
+            send_move(bc, NULL);
+            continue;
+        }
+
+        for (; j != -1; j = bench.cmds[j].next)
+            send_move(bc, &bench.cmds[j].cmd);
+    }
+}
+
+static void start_measure(void)
+{
+    benchclient_t *bc;
+    int i;
+
+    for (i = 0, bc = bench.clients; i < bench.numclients; i++, bc++)
+        if (bc->client)
+            bc->bytes_sent = bc->client->bytes_sent;
+
+    bench.start_allocs = Z_AllocCount();
+    bench.start_usec = Sys_Microseconds();
+    SV_ProfileBenchStart();
+}
+
+static void finish_benchmark(void)
+{
+    uint64_t usec = Sys_Microseconds() - bench.start_usec;
+    uint64_t allocs = Z_AllocCount() - bench.start_allocs;
+    unsigned frames = bench.frame - WARMUP_FRAMES;
+    uint64_t bytes = 0;
+    benchclient_t *bc;
+    int i, count = 0;
+
+    for (i = 0, bc = bench.clients; i < bench.numclients; i++, bc++) {
+        if (bc->client) {
+            bytes += bc->client->bytes_sent - bc->bytes_sent;
+            count++;
+        }
+    }
+
+    Com_Printf("%u frames with %d clients in %.3f sec, %.1f frames/sec\n",
+               frames, count, usec * 1e-6, usec ? frames * 1e6 / usec : 0.0);
+
+    SV_ProfileBenchStop(true);
+
+    Com_Printf("%.1f bytes sent per client per frame\n"
+               "%.1f allocations per frame\n",
+               count ? (double)bytes / count / frames : 0.0,
+               (double)allocs / frames);
+
+    for (i = 0, bc = bench.clients; i < bench.numclients; i++, bc++)
+        if (bc->client)
+            SV_DropClient(bc->client, NULL);
+
+    free_replay();
+}
+
+static void replay_frame(void)
+{
+    if (bench.frame == WARMUP_FRAMES)
+        start_measure();
+
+    if (bench.frame >= WARMUP_FRAMES) {
+        if (bench.maxframes && bench.frame - WARMUP_FRAMES == bench.maxframes) {
+            finish_benchmark();
+            return;
+        }
+        if (!read_block()) {
+            if (!bench.maxframes) {
+                finish_benchmark();
+                return;
+            }
+            rewind_replay();
+            read_block();
+        }
+    } else {
+        // let clients spawn and receive gamestate before measuring
+        clear_block();
+    }
+
+    SV_PROFILE(PROF_PACKETS, send_packets());
+    bench.frame++;
+}
+
+static void SV_Benchmark_f(void)
+{
+    char buffer[MAX_OSPATH];
+    char mapname[MAX_QPATH];
+    uint32_t magic = UCMD_MAGIC;
+    benchclient_t *bc;
+    int i, ret, numclients, numframes;
+    void *data;
+
+    if (Cmd_Argc() < 2) {
+        Com_Printf("Usage: %s <filename> [clients] [frames]\n", Cmd_Argv(0));
+        return;
+    }
+
+    if (sv_cmdrecording) {
+        Com_Printf("Can't run a benchmark while recording.\n");
+        return;
+    }
+
+    if (sv_benchmarking) {
+        Com_Printf("Already running a benchmark.\n");
+        return;
+    }
+
+    // in case map command in previous attempt has thrown an error
+    free_replay();
+
+    if (Q_concat(buffer, sizeof(buffer), "bench/", Cmd_Argv(1)) >= sizeof(buffer) ||
+        COM_DefaultExtension(buffer, ".ucmd", sizeof(buffer)) >= sizeof(buffer)) {
+        Com_Printf("Oversize filename specified.\n");
+        return;
+    }
+
+    ret = FS_LoadFile(buffer, &data);
+    if (!data) {
+        Com_Printf("Couldn't load %s: %s\n", buffer, Q_ErrorString(ret));
+        return;
+    }
+
+    bench.data = data;
+    bench.len = ret;
+
+    if (bench.len < 4 || memcmp(bench.data, &magic, 4)) {
+        Com_Printf("%s is not a movement command file.\n", buffer);
+        goto fail;
+    }
+
+    SZ_Init(&msg_read, bench.data + 4, bench.len - 4);
+    msg_read.cursize = bench.len - 4;
+    if (MSG_ReadShort() != UCMD_VERSION) {
+        Com_Printf("%s has unsupported version.\n", buffer);
+        goto fail;
+    }
+    if (MSG_ReadString(mapname, sizeof(mapname)) >= sizeof(mapname) ||
+        msg_read.readcount > msg_read.cursize) {
+        Com_Printf("%s has bad header.\n", buffer);
+        goto fail;
+    }
+    bench.start = 4 + msg_read.readcount;
+
+    numframes = scan_blocks();
+    if (numframes < 0) {
+        Com_Printf("%s is corrupted.\n", buffer);
+        goto fail;
+    }
+    if (!bench.numstreams) {
+        Com_Printf("%s has no movement commands.\n", buffer);
+        goto fail;
+    }
+
+    numclients = bench.numstreams;
+    if (Cmd_Argc() > 2) {
+        numclients = atoi(Cmd_Argv(2));
+        clamp(numclients, 1, CLIENTNUM_RESERVED);
+    }
+
+    bench.maxframes = 0;
+    if (Cmd_Argc() > 3)
+        bench.maxframes = max(atoi(Cmd_Argv(3)), 1);
+
+    // restart the game on captured map with enough client slots
+    if (sv_maxclients->integer < numclients)
+        Cvar_SetInteger(sv_maxclients, numclients, FROM_CODE);
+
+    Cmd_ExecuteString(&cmd_buffer, va("map \"%s\" force", mapname));
+    if (sv.state != ss_game || strcmp(sv.name, mapname)) {
+        Com_Printf("Couldn't load map %s.\n", mapname);
+        goto fail;
+    }
+
+    bench.clients = SV_Mallocz(sizeof(bench.clients[0]) * numclients);
+    bench.cmds = SV_Malloc(sizeof(bench.cmds[0]) * MAX_FRAME_CMDS);
+
+    for (i = 0; i < numclients; i++) {
+        bc = &bench.clients[bench.numclients];
+        bc->client = SV_AddSyntheticClient(va("\\name\\bench%d\\skin\\male/grunt"
+                                              "\\hand\\2\\rate\\100000", i));
+        if (!bc->client)
+            break;
+        bc->stream = i % bench.numstreams;
+        bench.numclients++;
+    }
+
+    if (!bench.numclients) {
+        Com_Printf("Couldn't connect synthetic clients.\n");
+        goto fail;
+    }
+
+    Com_Printf("Replaying %d frames of %d command streams from %s "
+               "with %d clients.\n", numframes, bench.numstreams, buffer,
+               bench.numclients);
+
+    rewind_replay();
+    bench.frame = 0;
+    sv_benchmarking = true;
+    return;
+
+fail:
+    free_replay();
+}
+
+/*
+==================
+SV_BenchmarkFrame
+
+Called each server frame before timeouts are checked, while recording or
+replaying movement commands.
+==================
+*/
+void SV_BenchmarkFrame(void)
+{
+    if (sv_cmdrecording) {
+        if (strcmp(sv.name, bench.mapname)) {
+            Com_Printf("Map changed, stopping movement command recording.\n");
+            rec_stop();
+            return;
+        }
+        rec_frame();
+    }
+
+    if (sv_benchmarking)
+        replay_frame();
+}
+
+void SV_BenchmarkShutdown(void)
+{
+    if (sv_cmdrecording)
+        rec_stop();
+
+    if (sv_benchmarking) {
+        Com_Printf("Benchmark aborted.\n");
+        SV_ProfileBenchStop(false);
+        free_replay();
+    }
+}
+
+static const cmdreg_t c_bench[] = {
+    { "sv_cmdrecord", SV_CmdRecord_f },
+    { "sv_cmdstop", SV_CmdStop_f },
+    { "sv_benchmark", SV_Benchmark_f },
+
+    { NULL }
+};
+
+void SV_RegisterBenchmark(void)
+{
+    Cmd_Register(c_bench);
+}
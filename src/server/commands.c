@@ -471,11 +471,13 @@ static void SV_Kick_f(void)
         if (addr->type == NA_IP || addr->type == NA_IP6) {
             addrmatch_t *match = Z_Malloc(sizeof(*match));
             match->addr = *addr;
-            make_mask(&match->mask, addr->type, addr->type == NA_IP6 ? 64 : 32);
+            match->bits = addr->type == NA_IP6 ? 64 : 32;
+            make_mask(&match->mask, addr->type, match->bits);
             match->hits = 0;
             match->time = 0;
             match->comment[0] = 0;
-            List_Append(&sv_banlist, &match->entry);
+            if (SV_AddAddress(&sv_banlist, match))
+                Z_Free(match);  // already banned
         }
     }
 
@@ -627,6 +629,42 @@ static void dump_protocols(void)
     }
 }
 
+static void dump_rates(void)
+{
+    client_t    *cl;
+
+    Com_Printf(
+        "num name            rate  estim srtt base loss  fps sup\n"
+        "--- --------------- ----- ----- ---- ---- ---- ---- ---\n");
+
+    FOR_EACH_CLIENT(cl) {
+        Com_Printf("%3i %-15.15s %5u %5u %4d %4d %4d %4d %3d\n",
+                   cl->number, cl->name, cl->rate, cl->cc.rate,
+                   cl->cc.srtt, cl->cc.base_rtt, cl->cc.loss,
+                   cl->settings[CLS_FPS], cl->suppress_count);
+    }
+}
+
+#if USE_ZLIB
+static void dump_compression(void)
+{
+    client_t    *cl;
+
+    Com_Printf(
+        "num name            mode   msgs   in(KB)  out(KB) ratio usec/msg\n"
+        "--- --------------- ------ ----- -------- -------- ----- --------\n");
+
+    FOR_EACH_CLIENT(cl) {
+        Com_Printf("%3i %-15.15s %-6s %5u %8"PRIu64" %8"PRIu64" %5.2f %8.1f\n",
+                   cl->number, cl->name,
+                   cl->zstream ? "stream" : cl->has_zlib ? "packet" : "none",
+                   cl->zmessages, cl->zbytes_in / 1024, cl->zbytes_out / 1024,
+                   cl->zbytes_out ? (double)cl->zbytes_in / cl->zbytes_out : 0.0,
+                   cl->zmessages ? (double)cl->zusec / cl->zmessages : 0.0);
+    }
+}
+#endif
+
 static void dump_settings(void)
 {
     client_t    *cl;
@@ -676,11 +714,15 @@ static void SV_Status_f(void)
             case 'd': dump_downloads(); break;
             case 'l': dump_lag();       break;
             case 'p': dump_protocols(); break;
+            case 'r': dump_rates();     break;
             case 's': dump_settings();  break;
             case 't': dump_time();      break;
             case 'v': dump_versions();  break;
+#if USE_ZLIB
+            case 'z': dump_compression(); break;
+#endif
             default:
-                Com_Printf("Usage: %s [d|l|p|s|t|v]\n", Cmd_Argv(0));
+                Com_Printf("Usage: %s [d|l|p|r|s|t|v|z]\n", Cmd_Argv(0));
                 dump_clients();
                 break;
             }
@@ -751,6 +793,8 @@ static void SV_Serverinfo_f(void)
 
     Com_Printf("Server info settings:\n");
     Info_Print(serverinfo);
+
+    SV_StatusCacheInfo();
 }
 
 void SV_PrintMiscInfo(void)
@@ -1022,7 +1066,7 @@ static void make_mask(netadr_t *mask, netadrtype_t type, int bits)
     }
 }
 
-static bool parse_mask(char *s, netadr_t *addr, netadr_t *mask)
+static bool parse_mask(char *s, netadr_t *addr, netadr_t *mask, int *bits_p)
 {
     int bits, size;
     char *p;
@@ -1056,22 +1100,21 @@ static bool parse_mask(char *s, netadr_t *addr, netadr_t *mask)
     }
 
     make_mask(mask, addr->type, bits);
+    *bits_p = bits;
     return true;
 }
 
 static size_t format_mask(addrmatch_t *match, char *buf, size_t buf_size)
 {
-    int i;
-    for (i = 0; i < addr_bits(match->mask.type) && match->mask.ip.u8[i >> 3] & (1 << (7 - (i & 7))); i++)
-        ;
-    return Q_snprintf(buf, buf_size, "%s/%d", NET_BaseAdrToString(&match->addr), i);
+    return Q_snprintf(buf, buf_size, "%s/%d", NET_BaseAdrToString(&match->addr), match->bits);
 }
 
-void SV_AddMatch_f(list_t *list)
+void SV_AddMatch_f(addrlist_t *list)
 {
     char *s, buf[MAX_QPATH];
-    addrmatch_t *match;
+    addrmatch_t *match, *old;
     netadr_t addr, mask;
+    int bits;
     size_t len;
 
     if (Cmd_Argc() < 2) {
@@ -1080,98 +1123,91 @@ void SV_AddMatch_f(list_t *list)
     }
 
     s = Cmd_Argv(1);
-    if (!parse_mask(s, &addr, &mask)) {
+    if (!parse_mask(s, &addr, &mask, &bits)) {
         return;
     }
 
-    LIST_FOR_EACH(addrmatch_t, match, list, entry) {
-        if (NET_IsEqualBaseAdr(&match->addr, &addr) &&
-            NET_IsEqualBaseAdr(&match->mask, &mask)) {
-            format_mask(match, buf, sizeof(buf));
-            Com_Printf("Entry %s already exists.\n", buf);
-            return;
-        }
-    }
-
     s = Cmd_ArgsFrom(2);
     len = strlen(s);
     match = Z_Malloc(sizeof(*match) + len);
     match->addr = addr;
     match->mask = mask;
+    match->bits = bits;
     match->hits = 0;
     match->time = 0;
     memcpy(match->comment, s, len + 1);
-    List_Append(list, &match->entry);
+
+    old = SV_AddAddress(list, match);
+    if (old) {
+        format_mask(old, buf, sizeof(buf));
+        Com_Printf("Entry %s already exists.\n", buf);
+        Z_Free(match);
+    }
 }
 
-void SV_DelMatch_f(list_t *list)
+void SV_DelMatch_f(addrlist_t *list)
 {
     char *s;
-    addrmatch_t *match, *next;
+    addrmatch_t *match;
     netadr_t addr, mask;
-    int i;
+    int i, bits;
 
     if (Cmd_Argc() < 2) {
         Com_Printf("Usage: %s <address[/mask]|id|all>\n", Cmd_Argv(0));
         return;
     }
 
-    if (LIST_EMPTY(list)) {
+    if (LIST_EMPTY(&list->list)) {
         Com_Printf("Address list is empty.\n");
         return;
     }
 
     s = Cmd_Argv(1);
     if (!strcmp(s, "all")) {
-        LIST_FOR_EACH_SAFE(addrmatch_t, match, next, list, entry) {
-            Z_Free(match);
-        }
-        List_Init(list);
+        SV_ClearAddresses(list);
         return;
     }
 
     // numeric values are just slot numbers
     if (COM_IsUint(s)) {
         i = atoi(s);
-        match = LIST_INDEX(addrmatch_t, i - 1, list, entry);
+        match = LIST_INDEX(addrmatch_t, i - 1, &list->list, entry);
         if (match) {
-            goto remove;
+            SV_RemoveAddress(list, match);
+            return;
         }
         Com_Printf("No such index: %d\n", i);
         return;
     }
 
-    if (!parse_mask(s, &addr, &mask)) {
+    if (!parse_mask(s, &addr, &mask, &bits)) {
         return;
     }
 
-    LIST_FOR_EACH(addrmatch_t, match, list, entry) {
-        if (NET_IsEqualBaseAdr(&match->addr, &addr) &&
-            NET_IsEqualBaseAdr(&match->mask, &mask)) {
-remove:
-            List_Remove(&match->entry);
-            Z_Free(match);
+    LIST_FOR_EACH(addrmatch_t, match, &list->list, entry) {
+        if (NET_IsEqualBaseAdrMask(&match->addr, &addr, &mask) && match->bits == bits) {
+            SV_RemoveAddress(list, match);
             return;
         }
     }
     Com_Printf("No such entry: %s\n", s);
 }
 
-void SV_ListMatches_f(list_t *list)
+void SV_ListMatches_f(addrlist_t *list)
 {
     addrmatch_t *match;
     char last[MAX_QPATH];
     char addr[MAX_QPATH];
     int id = 0;
 
-    if (LIST_EMPTY(list)) {
+    if (LIST_EMPTY(&list->list)) {
         Com_Printf("Address list is empty.\n");
         return;
     }
 
     Com_Printf("id address/mask       hits last hit     comment\n"
                "-- ------------------ ---- ------------ -------\n");
-    LIST_FOR_EACH(addrmatch_t, match, list, entry) {
+    LIST_FOR_EACH(addrmatch_t, match, &list->list, entry) {
         format_mask(match, addr, sizeof(addr));
         if (!match->time) {
             strcpy(last, "never");
@@ -1745,6 +1781,7 @@ static const cmdreg_t c_server[] = {
     { "addblackhole", SV_AddBlackHole_f },
     { "delblackhole", SV_DelBlackHole_f },
     { "listblackholes", SV_ListBlackHoles_f },
+    { "listsources", SV_ListSources_f },
     { "addstuffcmd", SV_AddStuffCmd_f, SV_StuffCmd_c },
     { "delstuffcmd", SV_DelStuffCmd_f, SV_StuffCmd_c },
     { "liststuffcmds", SV_ListStuffCmds_f, SV_StuffCmd_c },
@@ -30,6 +30,203 @@ Encode a client frame onto the network channel
 #define Q2PRO_OPTIMIZE(c) \
     ((c)->protocol == PROTOCOL_VERSION_Q2PRO && !(c)->settings[CLS_RECORDING])
 
+#if USE_MVD_CLIENT
+
+/*
+=============================================================================
+
+SHARED FRAMES
+
+MVD spectators chasing the same player (or floating at the same spot) see
+exactly the same world. Such spectators are grouped together each frame:
+the group is culled and packed into the circular client_entities array
+only once, and all members reference the same entities. Shared frames
+are tagged with unique ids, so that the encoded frame can be replayed to
+other members that delta compress from an identical frame, too.
+
+=============================================================================
+*/
+
+#define FRAME_CACHE_SIZE    64
+
+typedef struct framegroup_s {
+    client_t        *leader;    // culling is done from this client's view
+    int             count;
+    bool            culled;
+    bool            shared;     // false if first person entity is hidden
+    client_frame_t  frame;
+    int             num_visible;
+    uint16_t        visible[MAX_PACKET_ENTITIES];
+} framegroup_t;
+
+typedef struct {
+    // cache key
+    unsigned        shareid;
+    unsigned        oldshareid;     // 0 if not delta compressed
+    int             protocol;
+    int             version;
+    int             maxclients;
+    msgEsFlags_t    esFlags;
+    msgPsFlags_t    psFlags;
+
+    uint32_t        extraflags;
+    size_t          size, maxsize;
+    byte            *data;
+
+    // baselines new entities were delta compressed from
+    int             num_baselines;
+    uint16_t        basenums[MAX_PACKET_ENTITIES];
+    entity_packed_t baselines[MAX_PACKET_ENTITIES];
+} framecache_t;
+
+typedef uint32_t (*writeframe_t)(client_t *, client_frame_t *,
+                                 client_frame_t *, msgPsFlags_t, int);
+
+static framegroup_t sv_framegroups[MAX_CLIENTS];
+static framecache_t *sv_framecache[FRAME_CACHE_SIZE];
+static framecache_t *sv_framecache_capture;
+static int          sv_framecache_count;
+static unsigned     sv_next_shareid;
+
+static void capture_baseline(int number, const entity_packed_t *base)
+{
+    framecache_t *fc = sv_framecache_capture;
+
+    if (fc->num_baselines < MAX_PACKET_ENTITIES) {
+        fc->basenums[fc->num_baselines] = number;
+        memcpy(&fc->baselines[fc->num_baselines], base, sizeof(*base));
+    }
+    fc->num_baselines++;
+}
+
+static bool framecache_matches(const framecache_t *fc, const client_t *client,
+                               unsigned shareid, unsigned oldshareid,
+                               msgPsFlags_t psFlags)
+{
+    const entity_packed_t *base;
+    int i, num;
+
+    if (fc->shareid != shareid || fc->oldshareid != oldshareid)
+        return false;
+    if (fc->protocol != client->protocol || fc->version != client->version)
+        return false;
+    if (fc->maxclients != client->maxclients || fc->esFlags != client->esFlags)
+        return false;
+    if (fc->psFlags != psFlags)
+        return false;
+
+    // new entities must be delta compressed from identical baselines
+    for (i = 0; i < fc->num_baselines; i++) {
+        num = fc->basenums[i];
+        base = client->baselines[num >> SV_BASELINES_SHIFT];
+        if (base) {
+            base += (num & SV_BASELINES_MASK);
+        } else {
+            base = &nullEntityState;
+        }
+        if (memcmp(base, &fc->baselines[i], sizeof(*base)))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+=============
+write_shared_frame
+
+Replays the frame if it was already encoded for another spectator with the
+same settings, otherwise encodes it and keeps a copy until the end of this
+server frame. Returns extra playerstate flags for the frame header.
+=============
+*/
+static uint32_t write_shared_frame(client_t *client, client_frame_t *frame,
+                                   client_frame_t *oldframe, msgPsFlags_t psFlags,
+                                   int clientEntityNum, writeframe_t write)
+{
+    framecache_t *fc;
+    unsigned oldshareid;
+    uint32_t extraflags;
+    size_t start, len;
+    int i;
+
+    // delta base must be shared too
+    if (!frame->shareid || (oldframe && !oldframe->shareid) || clientEntityNum)
+        return write(client, frame, oldframe, psFlags, clientEntityNum);
+
+    oldshareid = oldframe ? oldframe->shareid : 0;
+
+    for (i = 0; i < sv_framecache_count; i++) {
+        fc = sv_framecache[i];
+        if (framecache_matches(fc, client, frame->shareid, oldshareid, psFlags)) {
+            MSG_WriteData(fc->data, fc->size);
+            return fc->extraflags;
+        }
+    }
+
+    if (sv_framecache_count == FRAME_CACHE_SIZE)
+        return write(client, frame, oldframe, psFlags, clientEntityNum);
+
+    fc = sv_framecache[sv_framecache_count];
+    if (!fc) {
+        fc = sv_framecache[sv_framecache_count] = Z_Mallocz(sizeof(*fc));
+    }
+
+    fc->shareid = frame->shareid;
+    fc->oldshareid = oldshareid;
+    fc->protocol = client->protocol;
+    fc->version = client->version;
+    fc->maxclients = client->maxclients;
+    fc->esFlags = client->esFlags;
+    fc->psFlags = psFlags;
+    fc->num_baselines = 0;
+
+    start = msg_write.cursize;
+    sv_framecache_capture = fc;
+    extraflags = write(client, frame, oldframe, psFlags, clientEntityNum);
+    sv_framecache_capture = NULL;
+
+    if (msg_write.overflowed || fc->num_baselines > MAX_PACKET_ENTITIES)
+        return extraflags;
+
+    len = msg_write.cursize - start;
+    if (len > fc->maxsize) {
+        fc->maxsize = len;
+        fc->data = Z_Realloc(fc->data, len);
+    }
+    memcpy(fc->data, msg_write.data + start, len);
+    fc->size = len;
+    fc->extraflags = extraflags;
+    sv_framecache_count++;
+
+    return extraflags;
+}
+
+/*
+=============
+SV_FlushFrameCache
+=============
+*/
+void SV_FlushFrameCache(void)
+{
+    int i;
+
+    for (i = 0; i < FRAME_CACHE_SIZE; i++) {
+        if (sv_framecache[i]) {
+            Z_Free(sv_framecache[i]->data);
+            Z_Free(sv_framecache[i]);
+            sv_framecache[i] = NULL;
+        }
+    }
+
+    sv_framecache_count = 0;
+}
+
+#else
+#define write_shared_frame(client, frame, oldframe, psFlags, clientEntityNum, write) \
+    write(client, frame, oldframe, psFlags, clientEntityNum)
+#endif
+
 /*
 =============
 SV_EmitPacketEntities
@@ -105,6 +302,11 @@ static void SV_EmitPacketEntities(client_t         *client,
             } else {
                 oldent = &nullEntityState;
             }
+#if USE_MVD_CLIENT
+            if (sv_framecache_capture) {
+                capture_baseline(newnum, oldent);
+            }
+#endif
             if (newnum == clientEntityNum) {
                 flags |= MSG_ES_FIRSTPERSON;
                 VectorCopy(oldent->origin, newent->origin);
@@ -164,6 +366,25 @@ static client_frame_t *get_last_frame(client_t *client)
     return frame;
 }
 
+static uint32_t write_frame_default(client_t *client, client_frame_t *frame,
+                                    client_frame_t *oldframe, msgPsFlags_t psFlags,
+                                    int clientEntityNum)
+{
+    // send over the areabits
+    MSG_WriteByte(frame->areabytes);
+    MSG_WriteData(frame->areabits, frame->areabytes);
+
+    // delta encode the playerstate
+    MSG_WriteByte(svc_playerinfo);
+    MSG_WriteDeltaPlayerstate_Default(oldframe ? &oldframe->ps : NULL, &frame->ps);
+
+    // delta encode the entities
+    MSG_WriteByte(svc_packetentities);
+    SV_EmitPacketEntities(client, oldframe, frame, clientEntityNum);
+
+    return 0;
+}
+
 /*
 ==================
 SV_WriteFrameToClient_Default
@@ -172,7 +393,6 @@ SV_WriteFrameToClient_Default
 void SV_WriteFrameToClient_Default(client_t *client)
 {
     client_frame_t  *frame, *oldframe;
-    player_packed_t *oldstate;
     int             lastframe;
 
     // this is the frame we are creating
@@ -181,10 +401,8 @@ void SV_WriteFrameToClient_Default(client_t *client)
     // this is the frame we are delta'ing from
     oldframe = get_last_frame(client);
     if (oldframe) {
-        oldstate = &oldframe->ps;
         lastframe = client->lastframe;
     } else {
-        oldstate = NULL;
         lastframe = -1;
     }
 
@@ -195,17 +413,43 @@ void SV_WriteFrameToClient_Default(client_t *client)
     client->suppress_count = 0;
     client->frameflags = 0;
 
+    write_shared_frame(client, frame, oldframe, 0, 0, write_frame_default);
+}
+
+static uint32_t write_frame_enhanced(client_t *client, client_frame_t *frame,
+                                     client_frame_t *oldframe, msgPsFlags_t psFlags,
+                                     int clientEntityNum)
+{
+    uint32_t    extraflags;
+
     // send over the areabits
     MSG_WriteByte(frame->areabytes);
     MSG_WriteData(frame->areabits, frame->areabytes);
 
     // delta encode the playerstate
-    MSG_WriteByte(svc_playerinfo);
-    MSG_WriteDeltaPlayerstate_Default(oldstate, &frame->ps);
+    extraflags = MSG_WriteDeltaPlayerstate_Enhanced(oldframe ? &oldframe->ps : NULL,
+                                                    &frame->ps, psFlags);
+
+    if (client->protocol == PROTOCOL_VERSION_Q2PRO) {
+        // delta encode the clientNum
+        if (client->version < PROTOCOL_VERSION_Q2PRO_CLIENTNUM_FIX) {
+            if (!oldframe || frame->clientNum != oldframe->clientNum) {
+                extraflags |= EPS_CLIENTNUM;
+                MSG_WriteByte(frame->clientNum);
+            }
+        } else {
+            int clientNum = oldframe ? oldframe->clientNum : 0;
+            if (clientNum != frame->clientNum) {
+                extraflags |= EPS_CLIENTNUM;
+                MSG_WriteByte(frame->clientNum);
+            }
+        }
+    }
 
     // delta encode the entities
-    MSG_WriteByte(svc_packetentities);
-    SV_EmitPacketEntities(client, oldframe, frame, 0);
+    SV_EmitPacketEntities(client, oldframe, frame, clientEntityNum);
+
+    return extraflags;
 }
 
 /*
@@ -216,7 +460,6 @@ SV_WriteFrameToClient_Enhanced
 void SV_WriteFrameToClient_Enhanced(client_t *client)
 {
     client_frame_t  *frame, *oldframe;
-    player_packed_t *oldstate;
     uint32_t        extraflags, delta;
     int             suppressed;
     byte            *b1, *b2;
@@ -229,10 +472,8 @@ void SV_WriteFrameToClient_Enhanced(client_t *client)
     // this is the frame we are delta'ing from
     oldframe = get_last_frame(client);
     if (oldframe) {
-        oldstate = &oldframe->ps;
         delta = client->framenum - client->lastframe;
     } else {
-        oldstate = NULL;
         delta = 31;
     }
 
@@ -244,10 +485,6 @@ void SV_WriteFrameToClient_Enhanced(client_t *client)
     // second byte to be patched
     b2 = SZ_GetSpace(&msg_write, 1);
 
-    // send over the areabits
-    MSG_WriteByte(frame->areabytes);
-    MSG_WriteData(frame->areabits, frame->areabytes);
-
     // ignore some parts of playerstate if not recording demo
     psFlags = 0;
     if (!client->settings[CLS_RECORDING]) {
@@ -283,24 +520,9 @@ void SV_WriteFrameToClient_Enhanced(client_t *client)
         suppressed = client->suppress_count;
     }
 
-    // delta encode the playerstate
-    extraflags = MSG_WriteDeltaPlayerstate_Enhanced(oldstate, &frame->ps, psFlags);
-
-    if (client->protocol == PROTOCOL_VERSION_Q2PRO) {
-        // delta encode the clientNum
-        if (client->version < PROTOCOL_VERSION_Q2PRO_CLIENTNUM_FIX) {
-            if (!oldframe || frame->clientNum != oldframe->clientNum) {
-                extraflags |= EPS_CLIENTNUM;
-                MSG_WriteByte(frame->clientNum);
-            }
-        } else {
-            int clientNum = oldframe ? oldframe->clientNum : 0;
-            if (clientNum != frame->clientNum) {
-                extraflags |= EPS_CLIENTNUM;
-                MSG_WriteByte(frame->clientNum);
-            }
-        }
-    }
+    // encode the frame body
+    extraflags = write_shared_frame(client, frame, oldframe, psFlags,
+                                    clientEntityNum, write_frame_enhanced);
 
     // save 3 high bits of extraflags
     *b1 = svc_frame | (((extraflags & 0x70) << 1));
@@ -311,9 +533,6 @@ void SV_WriteFrameToClient_Enhanced(client_t *client)
 
     client->suppress_count = 0;
     client->frameflags = 0;
-
-    // delta encode the entities
-    SV_EmitPacketEntities(client, oldframe, frame, clientEntityNum);
 }
 
 /*
@@ -369,22 +588,13 @@ fix_old_origin(client_t *client, entity_packed_t *state, edict_t *ent, int e)
 }
 #endif
 
-/*
-=============
-SV_BuildClientFrame
-
-Decides which entities are going to be visible to the client, and
-copies off the playerstat and areabits.
-=============
-*/
-void SV_BuildClientFrame(client_t *client)
+// builds up the list of entities visible from client's view
+static int cull_frame(client_t *client, client_frame_t *frame, uint16_t *visible)
 {
-    int         e, i;
+    int         e, i, num_visible;
     vec3_t      org;
     edict_t     *ent;
     edict_t     *clent;
-    client_frame_t  *frame;
-    entity_packed_t *state;
     player_state_t  *ps;
     int         clientarea, clientcluster;
     mleaf_t     *leaf;
@@ -392,16 +602,7 @@ void SV_BuildClientFrame(client_t *client)
     byte        clientpvs[VIS_MAX_BYTES];
 
     clent = client->edict;
-    if (!clent->client)
-        return;        // not in game yet
-
-    // this is the frame we are creating
-    frame = &client->frames[client->framenum & UPDATE_MASK];
-    frame->number = client->framenum;
-    frame->sentTime = com_eventTime; // save it for ping calc later
-    frame->latency = -1; // not yet acked
-
-    client->frames_sent++;
+    num_visible = 0;
 
     // find the client's PVS
     ps = &clent->client->ps;
@@ -432,9 +633,6 @@ void SV_BuildClientFrame(client_t *client)
     BSP_ClusterVis(client->cm->cache, clientphs, clientcluster, DVIS_PHS);
 
     // build up the list of visible entities
-    frame->num_entities = 0;
-    frame->first_entity = svs.next_entity;
-
     for (e = 1; e < client->pool->num_edicts; e++) {
         ent = EDICT_POOL(client, e);
 
@@ -503,6 +701,31 @@ void SV_BuildClientFrame(client_t *client)
             }
         }
 
+        visible[num_visible] = e;
+        if (++num_visible == MAX_PACKET_ENTITIES) {
+            break;
+        }
+    }
+
+    return num_visible;
+}
+
+// copies visible entities into the circular client_entities array
+static void pack_entities(client_t *client, client_frame_t *frame,
+                          const uint16_t *visible, int num_visible)
+{
+    int         e, i;
+    edict_t     *ent;
+    edict_t     *clent = client->edict;
+    entity_packed_t *state;
+
+    frame->num_entities = 0;
+    frame->first_entity = svs.next_entity;
+
+    for (i = 0; i < num_visible; i++) {
+        e = visible[i];
+        ent = EDICT_POOL(client, e);
+
         if (ent->s.number != e) {
             Com_WPrintf("%s: fixing ent->s.number: %d to %d\n",
                         __func__, ent->s.number, e);
@@ -546,9 +769,224 @@ void SV_BuildClientFrame(client_t *client)
         }
 
         svs.next_entity++;
+        frame->num_entities++;
+    }
+}
 
-        if (++frame->num_entities == MAX_PACKET_ENTITIES) {
-            break;
+/*
+=============
+SV_CullClientFrame
+
+Decides which entities are going to be visible to the client, and
+copies off the playerstate and areabits.
+
+Doesn't modify any shared state, so may be called for different clients
+from worker threads in parallel.
+=============
+*/
+void SV_CullClientFrame(client_t *client)
+{
+    client_frame_t  *frame;
+
+#if USE_MVD_CLIENT
+    framegroup_t    *group = client->framegroup;
+
+    if (group) {
+        // only the group leader is culled in parallel
+        if (!group->culled) {
+            group->num_visible = cull_frame(group->leader, &group->frame, group->visible);
+            group->culled = true;
+        }
+        return;
+    }
+#endif
+
+    client->frame_culled = true;
+    client->num_visible = 0;
+
+    if (!client->edict->client)
+        return;        // not in game yet
+
+    // this is the frame we are creating
+    frame = &client->frames[client->framenum & UPDATE_MASK];
+
+    client->num_visible = cull_frame(client, frame, client->visible);
+}
+
+#if USE_MVD_CLIENT
+
+static bool group_matches(const framegroup_t *group, const client_t *client,
+                          const player_packed_t *ps, int clientNum)
+{
+    const client_t *leader = group->leader;
+
+    if (leader->pool != client->pool || leader->cm != client->cm)
+        return false;
+    if (leader->protocol != client->protocol || leader->esFlags != client->esFlags)
+        return false;
+#if USE_FPS
+    if (leader->framediv != client->framediv)
+        return false;
+#endif
+    if (leader->settings[CLS_RECORDING] != client->settings[CLS_RECORDING] ||
+        leader->settings[CLS_NOGIBS] != client->settings[CLS_NOGIBS] ||
+        leader->settings[CLS_NOFOOTSTEPS] != client->settings[CLS_NOFOOTSTEPS])
+        return false;
+    if (group->frame.clientNum != clientNum)
+        return false;
+
+    // view origin is culled from before packing
+    if (!VectorCompare(leader->edict->client->ps.viewoffset,
+                       client->edict->client->ps.viewoffset))
+        return false;
+
+    return !memcmp(&group->frame.ps, ps, sizeof(*ps));
+}
+
+/*
+=============
+SV_GroupClientFrames
+
+Groups spectators that are about to receive identical frames. Called
+before culling with the list of clients frames will be built for.
+Returns the list compacted to clients that need to be culled.
+=============
+*/
+int SV_GroupClientFrames(client_t **clients, int count)
+{
+    framegroup_t    *group;
+    client_t        *client;
+    player_packed_t ps;
+    int             i, j, numgroups, clientNum;
+
+    FOR_EACH_CLIENT(client)
+        client->framegroup = NULL;
+
+    sv_framecache_count = 0;
+
+    if (sv.state != ss_broadcast || !mvd_shared_frames->integer)
+        return count;
+
+    numgroups = 0;
+    for (i = 0; i < count; i++) {
+        client = clients[i];
+        if (!client->edict->client)
+            continue;
+
+        memset(&ps, 0, sizeof(ps));
+        MSG_PackPlayer(&ps, &client->edict->client->ps);
+
+        if (g_features->integer & GMF_CLIENTNUM) {
+            clientNum = client->edict->client->clientNum;
+        } else {
+            clientNum = client->number;
         }
+
+        for (j = 0; j < numgroups; j++) {
+            if (group_matches(&sv_framegroups[j], client, &ps, clientNum))
+                break;
+        }
+
+        group = &sv_framegroups[j];
+        if (j == numgroups) {
+            group->leader = client;
+            group->count = 0;
+            group->culled = false;
+            group->frame.ps = ps;
+            group->frame.clientNum = clientNum;
+            group->frame.shareid = 0;
+
+            // entities can't be shared if SV_EmitPacketEntities
+            // is going to patch the first person entity
+            group->shared = client->protocol != PROTOCOL_VERSION_Q2PRO ||
+                client->settings[CLS_RECORDING] || ps.pmove.pm_type >= PM_DEAD;
+            numgroups++;
+        }
+
+        group->count++;
+        client->framegroup = group;
+    }
+
+    // cull group leaders and clients not in any group
+    for (i = j = 0; i < count; i++) {
+        client = clients[i];
+        group = client->framegroup;
+        if (group && group->count == 1) {
+            client->framegroup = group = NULL;
+        }
+        if (!group || group->leader == client) {
+            clients[j++] = client;
+        }
+    }
+
+    return j;
+}
+
+static void build_group_frame(client_t *client, client_frame_t *frame)
+{
+    framegroup_t *group = client->framegroup;
+
+    frame->areabytes = group->frame.areabytes;
+    memcpy(frame->areabits, group->frame.areabits, sizeof(frame->areabits));
+    frame->ps = group->frame.ps;
+    frame->clientNum = group->frame.clientNum;
+
+    if (!group->shared) {
+        frame->shareid = 0;
+        pack_entities(client, frame, group->visible, group->num_visible);
+        return;
     }
+
+    // first member to build the frame packs entities for everyone
+    if (!group->frame.shareid) {
+        pack_entities(client, &group->frame, group->visible, group->num_visible);
+        if (!++sv_next_shareid)
+            sv_next_shareid++;
+        group->frame.shareid = sv_next_shareid;
+    }
+
+    frame->first_entity = group->frame.first_entity;
+    frame->num_entities = group->frame.num_entities;
+    frame->shareid = group->frame.shareid;
+}
+
+#endif // USE_MVD_CLIENT
+
+/*
+=============
+SV_BuildClientFrame
+
+Copies entities found visible by SV_CullClientFrame into the circular
+client_entities array. Runs culling first unless it has been already
+done for this frame.
+=============
+*/
+void SV_BuildClientFrame(client_t *client)
+{
+    client_frame_t  *frame;
+
+    if (!client->frame_culled)
+        SV_CullClientFrame(client);
+    client->frame_culled = false;
+
+    if (!client->edict->client)
+        return;        // not in game yet
+
+    // this is the frame we are creating
+    frame = &client->frames[client->framenum & UPDATE_MASK];
+    frame->number = client->framenum;
+    frame->sentTime = com_eventTime; // save it for ping calc later
+    frame->latency = -1; // not yet acked
+
+    client->frames_sent++;
+
+#if USE_MVD_CLIENT
+    if (client->framegroup) {
+        build_group_frame(client, frame);
+        return;
+    }
+#endif
+
+    frame->shareid = 0;
+    pack_entities(client, frame, client->visible, client->num_visible);
 }
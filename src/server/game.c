@@ -397,6 +397,8 @@ static void PF_configstring(int index, const char *val)
     memcpy(dst, val, len);
     dst[len] = 0;
 
+    SV_FlushGamestateCache();
+
     if (sv.state == ss_loading) {
         return;
     }
@@ -789,6 +791,63 @@ static void *SV_LoadGameLibrary(const char *libdir, const char *gamedir)
     return SV_LoadGameLibraryFrom(path);
 }
 
+/*
+===============
+Profiled game imports
+
+Hot imports are timed separately so that the profiler can tell time spent
+in the game library itself from time spent in the server on its behalf.
+Calls are also attributed to their call sites in the game library.
+===============
+*/
+static intptr_t game_entry;
+
+#define PF_PROFILE(phase, call) \
+    do { \
+        cmstats_t prof_cm; \
+        uint64_t prof_start = SV_ProfileImportStart(&prof_cm); \
+        call; \
+        SV_ProfileImport(phase, prof_start, \
+                         (intptr_t)q_return_address() - game_entry, &prof_cm); \
+    } while (0)
+
+static trace_t q_gameabi PF_Trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end,
+                                  edict_t *passedict, int contentmask)
+{
+    trace_t trace;
+    PF_PROFILE(PROF_TRACE, trace = SV_Trace(start, mins, maxs, end, passedict, contentmask));
+    return trace;
+}
+
+static int PF_PointContents(vec3_t p)
+{
+    int contents;
+    PF_PROFILE(PROF_POINTCONTENTS, contents = SV_PointContents(p));
+    return contents;
+}
+
+static void PF_ProfileLinkEdict(edict_t *ent)
+{
+    PF_PROFILE(PROF_LINKENTITY, PF_LinkEdict(ent));
+}
+
+static int PF_AreaEdicts(vec3_t mins, vec3_t maxs, edict_t **list, int maxcount, int areatype)
+{
+    int count;
+    PF_PROFILE(PROF_AREAEDICTS, count = SV_AreaEdicts(mins, maxs, list, maxcount, areatype));
+    return count;
+}
+
+static void PF_Multicast(vec3_t origin, multicast_t to)
+{
+    PF_PROFILE(PROF_MULTICAST, SV_Multicast(origin, to));
+}
+
+static void PF_ProfilePmove(pmove_t *pm)
+{
+    PF_PROFILE(PROF_PMOVE, PF_Pmove(pm));
+}
+
 /*
 ===============
 SV_InitGameProgs
@@ -828,8 +887,11 @@ void SV_InitGameProgs(void)
     if (!entry)
         Com_Error(ERR_DROP, "Failed to load game library");
 
+    // call sites are profiled relative to the entry point
+    game_entry = (intptr_t)entry;
+
     // load a new game dll
-    import.multicast = SV_Multicast;
+    import.multicast = PF_Multicast;
     import.unicast = PF_Unicast;
     import.bprintf = PF_bprintf;
     import.dprintf = PF_dprintf;
@@ -837,15 +899,15 @@ void SV_InitGameProgs(void)
     import.centerprintf = PF_centerprintf;
     import.error = PF_error;
 
-    import.linkentity = PF_LinkEdict;
+    import.linkentity = PF_ProfileLinkEdict;
     import.unlinkentity = PF_UnlinkEdict;
-    import.BoxEdicts = SV_AreaEdicts;
-    import.trace = SV_Trace;
-    import.pointcontents = SV_PointContents;
+    import.BoxEdicts = PF_AreaEdicts;
+    import.trace = PF_Trace;
+    import.pointcontents = PF_PointContents;
     import.setmodel = PF_setmodel;
     import.inPVS = PF_inPVS;
     import.inPHS = PF_inPHS;
-    import.Pmove = PF_Pmove;
+    import.Pmove = PF_ProfilePmove;
 
     import.modelindex = PF_ModelIndex;
     import.soundindex = PF_SoundIndex;
@@ -163,6 +163,8 @@ void SV_SpawnServer(mapcmd_t *cmd)
 
     // wipe the entire per-level structure
     memset(&sv, 0, sizeof(sv));
+    SV_FlushGamestateCache();
+    SV_InvalidateStatus();
     sv.spawncount = Q_rand() & 0x7fffffff;
 
     // set legacy spawncounts
@@ -18,13 +18,14 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "server.h"
 #include "client/input.h"
+#include "common/mdfour.h"
 
 pmoveParams_t   sv_pmp;
 
 master_t    sv_masters[MAX_MASTERS];   // address of group servers
 
-LIST_DECL(sv_banlist);
-LIST_DECL(sv_blacklist);
+ADDRLIST_DECL(sv_banlist);
+ADDRLIST_DECL(sv_blacklist);
 LIST_DECL(sv_cmdlist_connect);
 LIST_DECL(sv_cmdlist_begin);
 LIST_DECL(sv_lrconlist);
@@ -59,11 +60,16 @@ cvar_t  *sv_show_name_changes;
 cvar_t  *sv_airaccelerate;
 cvar_t  *sv_qwmod;              // atu QW Physics modificator
 cvar_t  *sv_novis;
+cvar_t  *sv_threads;
 
 cvar_t  *sv_maxclients;
 cvar_t  *sv_reserved_slots;
 cvar_t  *sv_locked;
 cvar_t  *sv_downloadserver;
+cvar_t  *sv_download_cache_size;
+#if USE_ZLIB
+cvar_t  *sv_zlib_stream;
+#endif
 cvar_t  *sv_redirect_address;
 
 cvar_t  *sv_hostname;
@@ -76,6 +82,7 @@ cvar_t  *sv_pad_packets;
 cvar_t  *sv_lan_force_rate;
 cvar_t  *sv_min_rate;
 cvar_t  *sv_max_rate;
+cvar_t  *sv_rate_control;
 cvar_t  *sv_calcpings_method;
 cvar_t  *sv_changemapcmd;
 
@@ -96,6 +103,7 @@ cvar_t  *sv_status_show;
 cvar_t  *sv_uptime;
 cvar_t  *sv_auth_limit;
 cvar_t  *sv_rcon_limit;
+cvar_t  *sv_source_limit;
 cvar_t  *sv_namechange_limit;
 
 cvar_t  *sv_allow_unconnected_cmds;
@@ -154,6 +162,8 @@ void SV_CleanClient(client_t *client)
     // close any existing donwload
     SV_CloseDownload(client);
 
+    SV_FreeClientStream(client);
+
     if (client->version_string) {
         Z_Free(client->version_string);
         client->version_string = NULL;
@@ -244,6 +254,8 @@ void SV_DropClient(client_t *client, const char *reason)
 
     SV_CleanClient(client);
 
+    SV_InvalidateStatus();
+
     Com_DPrintf("Going to cs_zombie for %s\n", client->name);
 
     // give MVD server a chance to detect if its dummy client was dropped
@@ -377,21 +389,377 @@ void SV_RateInit(ratelimit_t *r, const char *s)
     r->cost = rate2credits(rate);
 }
 
-addrmatch_t *SV_MatchAddress(list_t *list, netadr_t *addr)
+/*
+==============================================================================
+
+PER-SOURCE RATE LIMITING
+
+Connectionless packets are charged to a token bucket keyed by source address
+(IPv4 address or IPv6 /64 prefix). Buckets live in a fixed size open addressed
+hash table; when all slots in a probe sequence are taken, the least recently
+used one is recycled. No allocation is ever done on packet arrival.
+
+==============================================================================
+*/
+
+#define SOURCE_HASH_SIZE    1024
+#define SOURCE_HASH_MASK    (SOURCE_HASH_SIZE - 1)
+#define SOURCE_PROBES       4
+
+typedef struct {
+    uint64_t    key;
+    netadrtype_t type;      // NA_UNSPECIFIED for free slot
+    ratelimit_t rate;
+    unsigned    passed;
+    unsigned    dropped;
+    unsigned    first;      // svs.realtime when slot was taken
+} srcbucket_t;
+
+static srcbucket_t  sv_sources[SOURCE_HASH_SIZE];
+static uint64_t     sv_source_seed;
+static unsigned     sv_source_drops;
+static unsigned     sv_source_evictions;
+
+static srcbucket_t *find_source(netadrtype_t type, uint64_t key)
 {
-    addrmatch_t *match;
+    srcbucket_t *b, *oldest = NULL;
+    uint64_t h;
+    int i;
 
-    LIST_FOR_EACH(addrmatch_t, match, list, entry) {
-        if (NET_IsEqualBaseAdrMask(addr, &match->addr, &match->mask)) {
-            match->hits++;
-            match->time = time(NULL);
-            return match;
+    h = (key ^ sv_source_seed) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 32;
+
+    for (i = 0; i < SOURCE_PROBES; i++) {
+        b = &sv_sources[(h + i) & SOURCE_HASH_MASK];
+        if (b->type == type && b->key == key)
+            return b;
+        if (b->type == NA_UNSPECIFIED) {
+            oldest = b;
+            break;
         }
+        if (!oldest || svs.realtime - b->rate.time > svs.realtime - oldest->rate.time)
+            oldest = b;
+    }
+
+    if (oldest->type != NA_UNSPECIFIED)
+        sv_source_evictions++;
+
+    oldest->key = key;
+    oldest->type = type;
+    oldest->rate = svs.ratelimit_source;
+    oldest->rate.time = svs.realtime;
+    oldest->passed = oldest->dropped = 0;
+    oldest->first = svs.realtime;
+    return oldest;
+}
+
+/*
+===============
+SV_SourceLimited
+
+Returns true if connectionless packet from this address should be dropped.
+===============
+*/
+bool SV_SourceLimited(const netadr_t *addr)
+{
+    srcbucket_t *b;
+
+    if (!svs.ratelimit_source.cost)
+        return false;
+
+    switch (addr->type) {
+    case NA_IP:
+        b = find_source(NA_IP, addr->ip.u32[0]);
+        break;
+    case NA_IP6:
+        b = find_source(NA_IP6, addr->ip.u64[0]);
+        break;
+    default:
+        return false;   // loopback
+    }
+
+    if (SV_RateLimited(&b->rate)) {
+        b->dropped++;
+        sv_source_drops++;
+        return true;
     }
 
+    b->passed++;
+    return false;
+}
+
+void SV_ClearSources(void)
+{
+    memset(sv_sources, 0, sizeof(sv_sources));
+    sv_source_seed = ((uint64_t)Q_rand() << 32) | Q_rand();
+    sv_source_drops = sv_source_evictions = 0;
+}
+
+static int srccmp(const void *p1, const void *p2)
+{
+    const srcbucket_t *b1 = *(const srcbucket_t **)p1;
+    const srcbucket_t *b2 = *(const srcbucket_t **)p2;
+
+    if (b1->dropped != b2->dropped)
+        return b1->dropped < b2->dropped ? 1 : -1;
+    if (b1->passed != b2->passed)
+        return b1->passed < b2->passed ? 1 : -1;
+    return 0;
+}
+
+static void format_source(const srcbucket_t *b, char *buf, size_t size)
+{
+    netadr_t adr = { .type = b->type };
+
+    if (b->type == NA_IP6) {
+        adr.ip.u64[0] = b->key;
+        Q_snprintf(buf, size, "%s/64", NET_BaseAdrToString(&adr));
+    } else {
+        adr.ip.u32[0] = b->key;
+        Q_strlcpy(buf, NET_BaseAdrToString(&adr), size);
+    }
+}
+
+/*
+===============
+SV_ListSources_f
+
+Lists per-source buckets sorted by number of dropped packets.
+===============
+*/
+void SV_ListSources_f(void)
+{
+    srcbucket_t *sorted[SOURCE_HASH_SIZE];
+    char buf[MAX_QPATH];
+    int i, count, total;
+
+    if (Cmd_Argc() > 1 && !strcmp(Cmd_Argv(1), "clear")) {
+        SV_ClearSources();
+        return;
+    }
+
+    count = Cmd_Argc() > 1 ? atoi(Cmd_Argv(1)) : 20;
+
+    for (i = total = 0; i < SOURCE_HASH_SIZE; i++)
+        if (sv_sources[i].type != NA_UNSPECIFIED)
+            sorted[total++] = &sv_sources[i];
+
+    Com_Printf("%d of %d slots in use, %u packets dropped, %u slots recycled\n",
+               total, SOURCE_HASH_SIZE, sv_source_drops, sv_source_evictions);
+    if (!total)
+        return;
+
+    qsort(sorted, total, sizeof(sorted[0]), srccmp);
+
+    Com_Printf("address                                     passed  dropped  age\n"
+               "------------------------------------------- ------- -------- -----\n");
+    for (i = 0; i < total && i < count; i++) {
+        format_source(sorted[i], buf, sizeof(buf));
+        Com_Printf("%-43s %7u %8u %5u\n", buf, sorted[i]->passed, sorted[i]->dropped,
+                   (svs.realtime - sorted[i]->first) / 1000);
+    }
+}
+
+/*
+==============================================================================
+
+ADDRESS MATCHING
+
+Address lists are indexed by path compressed binary tries, one per address
+family, giving longest prefix match in time proportional to address length
+rather than number of entries.
+
+==============================================================================
+*/
+
+struct addrnode_s {
+    addrnode_t  *child[2];
+    addrmatch_t *match;     // NULL for branch nodes
+    int         bits;
+    byte        prefix[16];
+};
+
+static inline int prefix_bit(const byte *p, int i)
+{
+    return (p[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+// returns number of leading bits equal in a and b, up to max
+static int common_prefix(const byte *a, const byte *b, int max)
+{
+    int i, x;
+
+    for (i = 0; i < max; i += 8) {
+        x = a[i >> 3] ^ b[i >> 3];
+        if (x) {
+            while (!(x & 0x80)) {
+                x <<= 1;
+                i++;
+            }
+            return min(i, max);
+        }
+    }
+
+    return max;
+}
+
+static addrnode_t **addr_trie(addrlist_t *list, netadrtype_t type)
+{
+    switch (type) {
+    case NA_IP:
+        return &list->tries[0];
+    case NA_IP6:
+        return &list->tries[1];
+    default:
+        return NULL;
+    }
+}
+
+static addrnode_t *new_node(const byte *prefix, int bits, addrmatch_t *match)
+{
+    addrnode_t *node = Z_Mallocz(sizeof(*node));
+
+    memcpy(node->prefix, prefix, (bits + 7) >> 3);
+    node->bits = bits;
+    node->match = match;
+    return node;
+}
+
+addrmatch_t *SV_MatchAddress(addrlist_t *list, const netadr_t *addr)
+{
+    addrnode_t **trie = addr_trie(list, addr->type);
+    addrnode_t *node;
+    addrmatch_t *best = NULL;
+
+    if (!trie)
+        return NULL;
+
+    for (node = *trie; node; node = node->child[prefix_bit(addr->ip.u8, node->bits)]) {
+        if (common_prefix(addr->ip.u8, node->prefix, node->bits) < node->bits)
+            break;
+        if (node->match)
+            best = node->match;
+        if (node->bits == (addr->type == NA_IP6 ? 128 : 32))
+            break;
+    }
+
+    if (best) {
+        best->hits++;
+        best->time = time(NULL);
+    }
+
+    return best;
+}
+
+/*
+===============
+SV_AddAddress
+
+Links the match into the list. If an entry with the same address and mask
+already exists, returns it and does nothing.
+===============
+*/
+addrmatch_t *SV_AddAddress(addrlist_t *list, addrmatch_t *match)
+{
+    addrnode_t **link = addr_trie(list, match->addr.type);
+    addrnode_t *node, *split;
+    const byte *p = match->addr.ip.u8;
+    int bits = match->bits, common;
+
+    if (!link)
+        return NULL;
+
+    while ((node = *link) != NULL) {
+        common = common_prefix(p, node->prefix, min(bits, node->bits));
+        if (common < node->bits) {
+            // new prefix diverges from or is shorter than this node
+            if (common == bits) {
+                split = new_node(p, bits, match);
+            } else {
+                split = new_node(p, common, NULL);
+                split->child[prefix_bit(p, common)] = new_node(p, bits, match);
+            }
+            split->child[prefix_bit(node->prefix, common)] = node;
+            *link = split;
+            goto insert;
+        }
+        if (bits == node->bits) {
+            if (node->match)
+                return node->match;
+            node->match = match;
+            goto insert;
+        }
+        link = &node->child[prefix_bit(p, node->bits)];
+    }
+
+    *link = new_node(p, bits, match);
+
+insert:
+    List_Append(&list->list, &match->entry);
     return NULL;
 }
 
+static bool remove_node(addrnode_t **link, const addrmatch_t *match)
+{
+    addrnode_t *node = *link;
+
+    if (!node)
+        return false;
+    if (common_prefix(match->addr.ip.u8, node->prefix, node->bits) < node->bits)
+        return false;
+
+    if (node->bits == match->bits) {
+        if (node->match != match)
+            return false;
+        node->match = NULL;
+    } else if (node->bits > match->bits) {
+        return false;
+    } else if (!remove_node(&node->child[prefix_bit(match->addr.ip.u8, node->bits)], match)) {
+        return false;
+    }
+
+    // collapse branch nodes that are no longer needed
+    if (!node->match && !(node->child[0] && node->child[1])) {
+        *link = node->child[0] ? node->child[0] : node->child[1];
+        Z_Free(node);
+    }
+
+    return true;
+}
+
+void SV_RemoveAddress(addrlist_t *list, addrmatch_t *match)
+{
+    addrnode_t **trie = addr_trie(list, match->addr.type);
+
+    if (trie)
+        remove_node(trie, match);
+    List_Remove(&match->entry);
+    Z_Free(match);
+}
+
+static void free_nodes(addrnode_t *node)
+{
+    if (node) {
+        free_nodes(node->child[0]);
+        free_nodes(node->child[1]);
+        Z_Free(node);
+    }
+}
+
+void SV_ClearAddresses(addrlist_t *list)
+{
+    addrmatch_t *match, *next;
+
+    LIST_FOR_EACH_SAFE(addrmatch_t, match, next, &list->list, entry) {
+        Z_Free(match);
+    }
+    List_Init(&list->list);
+
+    free_nodes(list->tries[0]);
+    free_nodes(list->tries[1]);
+    list->tries[0] = list->tries[1] = NULL;
+}
+
 /*
 ==============================================================================
 
@@ -469,6 +837,86 @@ static size_t SV_StatusString(char *status)
     return total;
 }
 
+/*
+==============================================================================
+
+STATUS CACHE
+
+Formatted status and info responses are kept until something they depend on
+changes. Client connects, disconnects and name changes invalidate the cache
+explicitly. Serverinfo cvar changes, including those made by code or by the
+game library, are picked up from cvar_serverinfo_changes, and frags, pings
+and uptime are covered by a signature recomputed at most once per server
+frame.
+
+==============================================================================
+*/
+
+static struct {
+    char        status[MAX_PACKETLEN_DEFAULT];
+    size_t      status_len;
+    char        info[MAX_QPATH + 10];
+    size_t      info_len;
+    unsigned    framenum;   // frame signature was last checked
+    unsigned    serverinfo; // cvar_serverinfo_changes when last checked
+    uint32_t    signature;
+    unsigned    hits;
+    unsigned    rebuilds;
+} sv_status_cache;
+
+void SV_InvalidateStatus(void)
+{
+    sv_status_cache.status_len = 0;
+    sv_status_cache.info_len = 0;
+}
+
+void SV_StatusCacheInfo(void)
+{
+    Com_Printf("Status cache: %u hits, %u rebuilds\n",
+               sv_status_cache.hits, sv_status_cache.rebuilds);
+}
+
+static uint32_t status_signature(void)
+{
+    uint32_t sig = sv_reserved_slots->integer;
+    client_t *cl;
+
+    if (sv_uptime->integer > 0)
+        sig = sig * 31 + svs.realtime / 1000;
+
+    if (sv_status_show->integer > 1) {
+        FOR_EACH_CLIENT(cl) {
+            if (cl->state == cs_zombie)
+                continue;
+            sig = sig * 31 + cl->edict->client->ps.stats[STAT_FRAGS];
+            sig = sig * 31 + cl->ping;
+        }
+    }
+
+    return sig;
+}
+
+static void check_status_cache(void)
+{
+    uint32_t sig;
+
+    if (sv_status_cache.serverinfo != cvar_serverinfo_changes) {
+        sv_status_cache.serverinfo = cvar_serverinfo_changes;
+        SV_InvalidateStatus();
+    }
+
+    if (sv_status_cache.framenum == sv.framenum)
+        return;
+
+    sv_status_cache.framenum = sv.framenum;
+
+    sig = status_signature();
+    if (sig != sv_status_cache.signature) {
+        sv_status_cache.signature = sig;
+        sv_status_cache.status_len = 0;
+    }
+}
+
 /*
 ================
 SVC_Status
@@ -478,8 +926,7 @@ Responds with all the info that qplug or qspy can see
 */
 static void SVC_Status(void)
 {
-    char    buffer[MAX_PACKETLEN_DEFAULT];
-    size_t  len;
+    char    *buffer = sv_status_cache.status;
 
     if (!sv_status_show->integer) {
         return;
@@ -491,14 +938,19 @@ static void SVC_Status(void)
         return;
     }
 
-    // write the packet header
-    memcpy(buffer, "\xff\xff\xff\xffprint\n", 10);
-    len = 10;
+    check_status_cache();
 
-    len += SV_StatusString(buffer + len);
+    if (sv_status_cache.status_len) {
+        sv_status_cache.hits++;
+    } else {
+        // write the packet header
+        memcpy(buffer, "\xff\xff\xff\xffprint\n", 10);
+        sv_status_cache.status_len = 10 + SV_StatusString(buffer + 10);
+        sv_status_cache.rebuilds++;
+    }
 
     // send the datagram
-    NET_SendPacket(NS_SERVER, buffer, len, &net_from);
+    NET_SendPacket(NS_SERVER, buffer, sv_status_cache.status_len, &net_from);
 }
 
 /*
@@ -531,8 +983,7 @@ The second parameter should be the current protocol version number.
 */
 static void SVC_Info(void)
 {
-    char    buffer[MAX_QPATH+10];
-    size_t  len;
+    char    *buffer = sv_status_cache.info;
     int     version;
 
     if (sv_maxclients->integer == 1)
@@ -542,12 +993,19 @@ static void SVC_Info(void)
     if (version < PROTOCOL_VERSION_DEFAULT || version > PROTOCOL_VERSION_Q2PRO)
         return; // ignore invalid versions
 
-    len = Q_scnprintf(buffer, sizeof(buffer),
-                      "\xff\xff\xff\xffinfo\n%16s %8s %2i/%2i\n",
-                      sv_hostname->string, sv.name, SV_CountClients(),
-                      sv_maxclients->integer - sv_reserved_slots->integer);
+    check_status_cache();
 
-    NET_SendPacket(NS_SERVER, buffer, len, &net_from);
+    if (sv_status_cache.info_len) {
+        sv_status_cache.hits++;
+    } else {
+        sv_status_cache.info_len = Q_scnprintf(buffer, sizeof(sv_status_cache.info),
+                                               "\xff\xff\xff\xffinfo\n%16s %8s %2i/%2i\n",
+                                               sv_hostname->string, sv.name, SV_CountClients(),
+                                               sv_maxclients->integer - sv_reserved_slots->integer);
+        sv_status_cache.rebuilds++;
+    }
+
+    NET_SendPacket(NS_SERVER, buffer, sv_status_cache.info_len, &net_from);
 }
 
 /*
@@ -562,6 +1020,85 @@ static void SVC_Ping(void)
     OOB_PRINT(NS_SERVER, &net_from, "ack");
 }
 
+/*
+==============================================================================
+
+CHALLENGE COOKIES
+
+Challenges are not stored anywhere. Instead, challenge is computed as HMAC of
+client address, port and current time epoch, keyed with a secret generated at
+startup. Verifying it in SVC_DirectConnect only requires recomputing the HMAC,
+so spoofed getchallenge floods cost neither memory nor evict pending
+challenges of legitimate clients.
+
+==============================================================================
+*/
+
+#define CHALLENGE_EPOCH     60000   // challenge is valid for 1-2 epochs
+
+static byte     challenge_key[64];
+
+static void init_challenge_key(void)
+{
+    struct mdfour md;
+    uint64_t seed[4];
+    int i;
+
+    seed[0] = Sys_Microseconds();
+    seed[1] = time(NULL);
+    seed[2] = (uintptr_t)&seed;
+
+    for (i = 0; i < 4; i++) {
+        seed[3] = ((uint64_t)Q_rand() << 32) | Q_rand();
+        mdfour_begin(&md);
+        mdfour_update(&md, (uint8_t *)seed, sizeof(seed));
+        mdfour_update(&md, challenge_key, sizeof(challenge_key));
+        mdfour_result(&md, challenge_key + i * 16);
+    }
+}
+
+static unsigned make_challenge(const netadr_t *adr, unsigned epoch)
+{
+    byte pad[64], data[16 + 2 + 4], hash[16];
+    struct mdfour md;
+    uint32_t e = LittleLong(epoch);
+    size_t len;
+    int i;
+
+    len = adr->type == NA_IP6 ? 16 : 4;
+    memcpy(data, adr->ip.u8, len);
+    memcpy(data + len, &adr->port, 2);
+    len += 2;
+    memcpy(data + len, &e, 4);
+    len += 4;
+
+    // HMAC with the existing MD4 implementation
+    for (i = 0; i < 64; i++)
+        pad[i] = challenge_key[i] ^ 0x36;
+    mdfour_begin(&md);
+    mdfour_update(&md, pad, sizeof(pad));
+    mdfour_update(&md, data, len);
+    mdfour_result(&md, hash);
+
+    for (i = 0; i < 64; i++)
+        pad[i] = challenge_key[i] ^ 0x5c;
+    mdfour_begin(&md);
+    mdfour_update(&md, pad, sizeof(pad));
+    mdfour_update(&md, hash, sizeof(hash));
+    mdfour_result(&md, hash);
+
+    // must survive atoi() on the connect side
+    return LittleLongMem(hash) & 0x7fffffff;
+}
+
+static bool check_challenge(const netadr_t *adr, unsigned challenge)
+{
+    unsigned epoch = com_eventTime / CHALLENGE_EPOCH;
+
+    return challenge == make_challenge(adr, epoch) ||
+           challenge == make_challenge(adr, epoch - 1);
+}
+
 /*
 =================
 SVC_GetChallenge
@@ -575,36 +1112,7 @@ challenge, they must give a valid IP address.
 */
 static void SVC_GetChallenge(void)
 {
-    int         i, oldest;
-    unsigned    challenge;
-    unsigned    oldestTime;
-
-    oldest = 0;
-    oldestTime = 0xffffffff;
-
-    // see if we already have a challenge for this ip
-    for (i = 0; i < MAX_CHALLENGES; i++) {
-        if (NET_IsEqualBaseAdr(&net_from, &svs.challenges[i].adr))
-            break;
-        if (svs.challenges[i].time > com_eventTime) {
-            svs.challenges[i].time = com_eventTime;
-        }
-        if (svs.challenges[i].time < oldestTime) {
-            oldestTime = svs.challenges[i].time;
-            oldest = i;
-        }
-    }
-
-    challenge = Q_rand() & 0x7fffffff;
-    if (i == MAX_CHALLENGES) {
-        // overwrite the oldest
-        svs.challenges[oldest].challenge = challenge;
-        svs.challenges[oldest].adr = net_from;
-        svs.challenges[oldest].time = com_eventTime;
-    } else {
-        svs.challenges[i].challenge = challenge;
-        svs.challenges[i].time = com_eventTime;
-    }
+    unsigned challenge = make_challenge(&net_from, com_eventTime / CHALLENGE_EPOCH);
 
     // send it back
     Netchan_OutOfBand(NS_SERVER, &net_from,
@@ -662,7 +1170,7 @@ static bool parse_basic_params(conn_params_t *p)
 static bool permit_connection(conn_params_t *p)
 {
     addrmatch_t *match;
-    int i, count;
+    int count;
     client_t *cl;
     const char *s;
 
@@ -671,22 +1179,8 @@ static bool permit_connection(conn_params_t *p)
         return true;
 
     // see if the challenge is valid
-    for (i = 0; i < MAX_CHALLENGES; i++) {
-        if (!svs.challenges[i].challenge)
-            continue;
-
-        if (NET_IsEqualBaseAdr(&net_from, &svs.challenges[i].adr)) {
-            if (svs.challenges[i].challenge == p->challenge)
-                break;        // good
-
-            return reject("Bad challenge.\n");
-        }
-    }
-
-    if (i == MAX_CHALLENGES)
-        return reject("No challenge for address.\n");
-
-    svs.challenges[i].challenge = 0;
+    if (!check_challenge(&net_from, p->challenge))
+        return reject("Bad challenge.\n");
 
     // check for banned address
     if ((match = SV_MatchAddress(&sv_banlist, &net_from)) != NULL) {
@@ -1059,12 +1553,67 @@ static void append_extra_userinfo(conn_params_t *params, char *userinfo)
                params->maxlength, params->qport, params->has_zlib);
 }
 
+static void init_new_client(client_t *newcl, const conn_params_t *params)
+{
+    int number = newcl - svs.client_pool;
+
+    // build a new connection
+    // this is the only place a client_t is ever initialized
+    memset(newcl, 0, sizeof(*newcl));
+    newcl->number = newcl->slot = number;
+    newcl->challenge = params->challenge; // save challenge for checksumming
+    newcl->protocol = params->protocol;
+    newcl->version = params->version;
+    newcl->has_zlib = params->has_zlib;
+    newcl->edict = EDICT_NUM(number + 1);
+    newcl->gamedir = fs_game->string;
+    newcl->mapname = sv.name;
+    newcl->configstrings = (char *)sv.configstrings;
+    newcl->pool = (edict_pool_t *)&ge->edicts;
+    newcl->cm = &sv.cm;
+    newcl->spawncount = sv.spawncount;
+    newcl->maxclients = sv_maxclients->integer;
+    strcpy(newcl->reconnect_var, params->reconnect_var);
+    strcpy(newcl->reconnect_val, params->reconnect_val);
+#if USE_FPS
+    newcl->framediv = sv.framediv;
+    newcl->cc.framediv = sv.framediv;
+    newcl->settings[CLS_FPS] = BASE_FRAMERATE;
+#endif
+
+    init_pmove_and_es_flags(newcl);
+}
+
+static void add_new_client(client_t *newcl)
+{
+    SV_RateInit(&newcl->ratelimit_namechange, sv_namechange_limit->string);
+
+    SV_InitClientSend(newcl);
+
+    if (newcl->protocol == PROTOCOL_VERSION_DEFAULT) {
+        newcl->WriteFrame = SV_WriteFrameToClient_Default;
+    } else {
+        newcl->WriteFrame = SV_WriteFrameToClient_Enhanced;
+    }
+
+    // add them to the linked list of connected clients
+    List_SeqAdd(&sv_clientlist, &newcl->entry);
+    SV_InvalidateStatus();
+
+    Com_DPrintf("Going from cs_free to cs_assigned for %s\n", newcl->name);
+    newcl->state = cs_assigned;
+    newcl->framenum = 1; // frame 0 can't be used
+    newcl->lastframe = -1;
+    newcl->lastmessage = svs.realtime;    // don't timeout
+    newcl->lastactivity = svs.realtime;
+    newcl->min_ping = 9999;
+}
+
 static void SVC_DirectConnect(void)
 {
     char            userinfo[MAX_INFO_STRING * 2];
     conn_params_t   params;
     client_t        *newcl;
-    int             number;
     qboolean        allow;
     char            *reason;
 
@@ -1087,33 +1636,7 @@ static void SVC_DirectConnect(void)
     if (!newcl)
         return;
 
-    number = newcl - svs.client_pool;
-
-    // build a new connection
-    // accept the new client
-    // this is the only place a client_t is ever initialized
-    memset(newcl, 0, sizeof(*newcl));
-    newcl->number = newcl->slot = number;
-    newcl->challenge = params.challenge; // save challenge for checksumming
-    newcl->protocol = params.protocol;
-    newcl->version = params.version;
-    newcl->has_zlib = params.has_zlib;
-    newcl->edict = EDICT_NUM(number + 1);
-    newcl->gamedir = fs_game->string;
-    newcl->mapname = sv.name;
-    newcl->configstrings = (char *)sv.configstrings;
-    newcl->pool = (edict_pool_t *)&ge->edicts;
-    newcl->cm = &sv.cm;
-    newcl->spawncount = sv.spawncount;
-    newcl->maxclients = sv_maxclients->integer;
-    strcpy(newcl->reconnect_var, params.reconnect_var);
-    strcpy(newcl->reconnect_val, params.reconnect_val);
-#if USE_FPS
-    newcl->framediv = sv.framediv;
-    newcl->settings[CLS_FPS] = BASE_FRAMERATE;
-#endif
-
-    init_pmove_and_es_flags(newcl);
+    init_new_client(newcl, &params);
 
     append_extra_userinfo(&params, userinfo);
 
@@ -1147,31 +1670,76 @@ static void SVC_DirectConnect(void)
     // send the connect packet to the client
     send_connect_packet(newcl, params.nctype);
 
-    SV_RateInit(&newcl->ratelimit_namechange, sv_namechange_limit->string);
-
-    SV_InitClientSend(newcl);
-
-    if (newcl->protocol == PROTOCOL_VERSION_DEFAULT) {
-        newcl->WriteFrame = SV_WriteFrameToClient_Default;
-    } else {
-        newcl->WriteFrame = SV_WriteFrameToClient_Enhanced;
-    }
-
     // loopback client doesn't need to reconnect
     if (NET_IsLocalAddress(&net_from)) {
         newcl->reconnected = true;
     }
 
-    // add them to the linked list of connected clients
-    List_SeqAdd(&sv_clientlist, &newcl->entry);
+    add_new_client(newcl);
+}
 
-    Com_DPrintf("Going from cs_free to cs_assigned for %s\n", newcl->name);
-    newcl->state = cs_assigned;
-    newcl->framenum = 1; // frame 0 can't be used
-    newcl->lastframe = -1;
-    newcl->lastmessage = svs.realtime;    // don't timeout
-    newcl->lastactivity = svs.realtime;
-    newcl->min_ping = 9999;
+/*
+==================
+SV_AddSyntheticClient
+
+Connects a client that has no network peer, for benchmarking. Its netchan
+has unspecified remote address, so that frames and reliable messages are
+fully built, but then discarded. Returns NULL if no free slot was found or
+the game rejected the connection.
+==================
+*/
+client_t *SV_AddSyntheticClient(const char *info)
+{
+    char            userinfo[MAX_INFO_STRING * 2];
+    conn_params_t   params;
+    client_t        *newcl;
+    netadr_t        adr;
+    int             i;
+
+    for (i = 0; i < sv_maxclients->integer; i++)
+        if (svs.client_pool[i].state == cs_free)
+            break;
+    if (i == sv_maxclients->integer)
+        return NULL;
+
+    newcl = &svs.client_pool[i];
+
+    memset(&params, 0, sizeof(params));
+    params.protocol = PROTOCOL_VERSION_Q2PRO;
+    params.version = PROTOCOL_VERSION_Q2PRO_CURRENT;
+    params.maxlength = MAX_PACKETLEN_WRITABLE_DEFAULT;
+    params.nctype = NETCHAN_OLD;
+    params.has_zlib = true;
+
+    init_new_client(newcl, &params);
+
+    Q_strlcpy(userinfo, info, MAX_INFO_STRING);
+    userinfo[strlen(userinfo) + 1] = 0;
+
+    sv_client = newcl;
+    sv_player = newcl->edict;
+    if (!ge->ClientConnect(newcl->edict, userinfo)) {
+        sv_client = NULL;
+        sv_player = NULL;
+        return NULL;
+    }
+    sv_client = NULL;
+    sv_player = NULL;
+
+    memset(&adr, 0, sizeof(adr));
+    newcl->netchan = Netchan_Setup(NS_SERVER, params.nctype, &adr, 0,
+                                   params.maxlength, params.protocol);
+    newcl->numpackets = 1;
+
+    Q_strlcpy(newcl->userinfo, userinfo, sizeof(newcl->userinfo));
+    SV_UserinfoChanged(newcl);
+
+    // there is nobody to answer version probe or reconnect
+    newcl->version_string = SV_CopyString("synthetic");
+    newcl->reconnected = true;
+
+    add_new_client(newcl);
+    return newcl;
 }
 
 typedef enum {
@@ -1293,6 +1861,11 @@ static void SV_ConnectionlessPacket(void)
         return;
     }
 
+    if (SV_SourceLimited(&net_from)) {
+        Com_DPrintf("ignored rate limited connectionless packet\n");
+        return;
+    }
+
     MSG_BeginReading();
     MSG_ReadLong();        // skip the -1 marker
 
@@ -1434,6 +2007,9 @@ static void SV_CalcPings(void)
 
         // let the game dll know about the ping
         cl->edict->client->ping = cl->ping;
+
+        if (cl->state == cs_spawned)
+            SV_UpdateRateControl(cl);
     }
 }
 
@@ -1531,23 +2107,38 @@ static void SV_PacketEvent(void)
             netchan->remote_address.port = net_from.port;
         }
 
-        if (!netchan->Process(netchan))
-            break;
+        SV_ProcessClientPacket(client);
+        break;
+    }
+}
 
-        if (client->state == cs_zombie)
-            break;
+/*
+=================
+SV_ProcessClientPacket
 
-        // this is a valid, sequenced packet, so process it
-        client->lastmessage = svs.realtime;    // don't timeout
+Runs the packet in msg_read through netchan of the given client and
+executes it if it is valid.
+=================
+*/
+void SV_ProcessClientPacket(client_t *client)
+{
+    netchan_t *netchan = client->netchan;
+
+    if (!netchan->Process(netchan))
+        return;
+
+    if (client->state == cs_zombie)
+        return;
+
+    // this is a valid, sequenced packet, so process it
+    client->lastmessage = svs.realtime;    // don't timeout
 #if USE_ICMP
-        client->unreachable = false; // don't drop
+    client->unreachable = false; // don't drop
 #endif
-        if (netchan->dropped > 0)
-            client->frameflags |= FF_CLIENTDROP;
+    if (netchan->dropped > 0)
+        client->frameflags |= FF_CLIENTDROP;
 
-        SV_ExecuteClientMessage(client);
-        break;
-    }
+    SV_ExecuteClientMessage(client);
 }
 
 #if USE_PMTUDISC
@@ -1760,6 +2351,8 @@ SV_RunGameFrame
 */
 static void SV_RunGameFrame(void)
 {
+    uint64_t start;
+
     // save the entire world state if recording a serverdemo
     SV_MvdBeginFrame();
 
@@ -1768,7 +2361,9 @@ static void SV_RunGameFrame(void)
         time_before_game = Sys_Milliseconds();
 #endif
 
+    start = SV_ProfileGameStart();
     ge->RunFrame();
+    SV_ProfileGameStop(start);
 
 #if USE_CLIENT
     if (host_speeds->integer)
@@ -1882,67 +2477,85 @@ Returns amount of extra frametime available for sleeping on IO.
 */
 unsigned SV_Frame(unsigned msec)
 {
+    uint64_t frame_start = SV_ProfileStart();
+
 #if USE_CLIENT
     time_before_game = time_after_game = 0;
 #endif
 
+    // run server frames back to back when benchmarking
+    if (sv_benchmarking && sv.frameresidual < SV_FRAMETIME)
+        msec = SV_FRAMETIME - sv.frameresidual;
+
     // advance local server time
     svs.realtime += msec;
 
     if (COM_DEDICATED) {
         // process console commands if not running a client
-        Cbuf_Execute(&cmd_buffer);
+        SV_PROFILE(PROF_COMMANDS, Cbuf_Execute(&cmd_buffer));
     }
 
 #if USE_MVD_CLIENT
     // run connections to MVD/GTV servers
-    MVD_Frame();
+    SV_PROFILE(PROF_MVD_CLIENT, MVD_Frame());
 #endif
 
     // read packets from UDP clients
-    NET_GetPackets(NS_SERVER, SV_PacketEvent);
+    SV_PROFILE(PROF_PACKETS, NET_GetPackets(NS_SERVER, SV_PacketEvent));
 
     if (svs.initialized) {
         // run connection to the anticheat server
-        AC_Run();
+        SV_PROFILE(PROF_ANTICHEAT, AC_Run());
 
         // run connections from MVD/GTV clients
-        SV_MvdRunClients();
+        SV_PROFILE(PROF_MVD_SERVER, SV_MvdRunClients());
 
         // deliver fragments and reliable messages for connecting clients
-        SV_SendAsyncPackets();
+        SV_PROFILE(PROF_ASYNC, SV_SendAsyncPackets());
     }
 
     // move autonomous things around if enough time has passed
     sv.frameresidual += msec;
     if (sv.frameresidual < SV_FRAMETIME) {
+        // accounted to the next server frame
+        SV_ProfileStop(PROF_FRAME, frame_start);
         return SV_FRAMETIME - sv.frameresidual;
     }
 
     if (svs.initialized && !check_paused()) {
+        // write or replay captured movement commands
+        if (sv_cmdrecording || sv_benchmarking)
+            SV_BenchmarkFrame();
+
         // check timeouts
-        SV_CheckTimeouts();
+        SV_PROFILE(PROF_TIMEOUTS, SV_CheckTimeouts());
 
         // update ping based on the last known frame from all clients
-        SV_CalcPings();
+        SV_PROFILE(PROF_PINGS, SV_CalcPings());
 
         // give the clients some timeslices
-        SV_GiveMsec();
+        SV_PROFILE(PROF_GIVEMSEC, SV_GiveMsec());
 
         // let everything in the world think and move
         SV_RunGameFrame();
 
         // send messages back to the UDP clients
-        SV_SendClientMessages();
+        SV_PROFILE(PROF_SEND, SV_SendClientMessages());
 
         // send a heartbeat to the master if needed
-        SV_MasterHeartbeat();
+        SV_PROFILE(PROF_HEARTBEAT, SV_MasterHeartbeat());
 
         // clear teleport flags, etc for next frame
-        SV_PrepWorldFrame();
+        SV_PROFILE(PROF_PREPWORLD, SV_PrepWorldFrame());
 
         // advance for next frame
         sv.framenum++;
+
+        // commit profiler statistics for this frame
+        SV_ProfileStop(PROF_FRAME, frame_start);
+        SV_ProfileEndFrame();
+    } else {
+        SV_ProfileSkipFrame();
     }
 
     if (COM_DEDICATED) {
@@ -1955,7 +2568,7 @@ unsigned SV_Frame(unsigned msec)
     // decide how long to sleep next frame
     sv.frameresidual -= SV_FRAMETIME;
     if (sv.frameresidual < SV_FRAMETIME) {
-        return SV_FRAMETIME - sv.frameresidual;
+        return sv_benchmarking ? 0 : SV_FRAMETIME - sv.frameresidual;
     }
 
     // don't accumulate bogus residual
@@ -2013,6 +2626,7 @@ void SV_UserinfoChanged(client_t *cl)
         }
     }
     memcpy(cl->name, name, len + 1);
+    SV_InvalidateStatus();
 
     // rate command
     val = Info_ValueForKey(cl->userinfo, "rate");
@@ -2034,6 +2648,9 @@ void SV_UserinfoChanged(client_t *cl)
         cl->rate = 0;
     }
 
+    // restart rate control from the new value
+    cl->cc.rate = 0;
+
     // msg command
     val = Info_ValueForKey(cl->userinfo, "msg");
     if (*val) {
@@ -2069,11 +2686,19 @@ static void sv_rcon_limit_changed(cvar_t *self)
     SV_RateInit(&svs.ratelimit_rcon, self->string);
 }
 
+static void sv_source_limit_changed(cvar_t *self)
+{
+    SV_RateInit(&svs.ratelimit_source, self->string);
+    SV_ClearSources();
+}
+
 static void init_rate_limits(void)
 {
     SV_RateInit(&svs.ratelimit_status, sv_status_limit->string);
     SV_RateInit(&svs.ratelimit_auth, sv_auth_limit->string);
     SV_RateInit(&svs.ratelimit_rcon, sv_rcon_limit->string);
+    SV_RateInit(&svs.ratelimit_source, sv_source_limit->string);
+    SV_ClearSources();
 }
 
 static void sv_rate_changed(cvar_t *self)
@@ -2130,6 +2755,8 @@ void SV_Init(void)
 {
     SV_InitOperatorCommands();
 
+    init_challenge_key();
+
     SV_MvdRegister();
 
 #if USE_MVD_CLIENT
@@ -2140,6 +2767,9 @@ void SV_Init(void)
 
     SV_RegisterSavegames();
 
+    SV_RegisterProfile();
+    SV_RegisterBenchmark();
+
     Cvar_Get("protocol", STRINGIFY(PROTOCOL_VERSION_DEFAULT), CVAR_SERVERINFO | CVAR_ROM);
 
     Cvar_Get("skill", "1", CVAR_LATCH);
@@ -2188,7 +2818,12 @@ void SV_Init(void)
     sv_reserved_password = Cvar_Get("sv_reserved_password", "", CVAR_PRIVATE);
     sv_locked = Cvar_Get("sv_locked", "0", 0);
     sv_novis = Cvar_Get("sv_novis", "0", 0);
+    sv_threads = Cvar_Get("sv_threads", "0", 0);
     sv_downloadserver = Cvar_Get("sv_downloadserver", "", 0);
+    sv_download_cache_size = Cvar_Get("sv_download_cache_size", "64", 0);
+#if USE_ZLIB
+    sv_zlib_stream = Cvar_Get("sv_zlib_stream", "1", 0);
+#endif
     sv_redirect_address = Cvar_Get("sv_redirect_address", "", 0);
 
 #if USE_DEBUG
@@ -2200,6 +2835,7 @@ void SV_Init(void)
     sv_max_rate = Cvar_Get("sv_max_rate", "15000", CVAR_LATCH);
     sv_max_rate->changed = sv_min_rate->changed = sv_rate_changed;
     sv_max_rate->changed(sv_max_rate);
+    sv_rate_control = Cvar_Get("sv_rate_control", "0", 0);
     sv_calcpings_method = Cvar_Get("sv_calcpings_method", "2", 0);
     sv_changemapcmd = Cvar_Get("sv_changemapcmd", "", 0);
 
@@ -2233,6 +2869,9 @@ void SV_Init(void)
     sv_rcon_limit = Cvar_Get("sv_rcon_limit", "1", 0);
     sv_rcon_limit->changed = sv_rcon_limit_changed;
 
+    sv_source_limit = Cvar_Get("sv_source_limit", "0", 0);
+    sv_source_limit->changed = sv_source_limit_changed;
+
     sv_namechange_limit = Cvar_Get("sv_namechange_limit", "5/min", 0);
     sv_namechange_limit->changed = sv_namechange_limit_changed;
 
@@ -2349,6 +2988,10 @@ void SV_Shutdown(const char *finalmsg, error_type_t type)
     SV_MvdShutdown(type);
 
     SV_FinalMessage(finalmsg, type);
+    SV_FlushDownloadCache();
+    SV_FlushGamestateCache();
+    SV_FlushFrameCache();
+    SV_BenchmarkShutdown();
     SV_MasterShutdown();
     SV_ShutdownGameProgs();
 
@@ -35,7 +35,9 @@ typedef struct {
     clstate_t   state;
     netstream_t stream;
 #if USE_ZLIB
-    z_stream    z;
+    z_stream    z;      // raw deflate for private data
+    uLong       adler;  // of all data sent, for zlib trailer
+    bool        shared; // receiving shared frame stream
 #endif
     unsigned    msglen;
     unsigned    lastmessage;
@@ -76,6 +78,15 @@ typedef struct {
 
     // TCP client pool
     gtv_client_t    *clients; // [sv_mvd_maxclients]
+
+#if USE_ZLIB
+    // frames compressed once for all deflate clients
+    z_stream        z;
+    unsigned        z_frames;   // since last full flush
+    unsigned        z_bufcount; // since last sync flush
+    bool            z_pending;  // input not yet flushed
+    uint64_t        z_bytes_in, z_bytes_out;
+#endif
 } mvd_server_t;
 
 static mvd_server_t     mvd;
@@ -84,8 +95,8 @@ static mvd_server_t     mvd;
 static LIST_DECL(gtv_client_list);
 static LIST_DECL(gtv_active_list);
 
-static LIST_DECL(gtv_white_list);
-static LIST_DECL(gtv_black_list);
+static ADDRLIST_DECL(gtv_white_list);
+static ADDRLIST_DECL(gtv_black_list);
 
 static cvar_t   *sv_mvd_enable;
 static cvar_t   *sv_mvd_maxclients;
@@ -110,10 +121,13 @@ static bool     mvd_enable(void);
 static void     mvd_disable(void);
 static void     mvd_error(const char *reason);
 
+static void     drop_client(gtv_client_t *client, const char *error);
 static void     write_stream(gtv_client_t *client, void *data, size_t len);
 static void     write_message(gtv_client_t *client, gtv_serverop_t op);
 #if USE_ZLIB
 static void     flush_stream(gtv_client_t *client, int flush);
+static void     leave_shared(gtv_client_t *client);
+static void     write_shared(byte *header, size_t total);
 #endif
 
 static void     rec_stop(void);
@@ -1070,6 +1084,10 @@ void SV_MvdEndFrame(void)
 
     // send frame to clients
     FOR_EACH_ACTIVE_GTV(client) {
+#if USE_ZLIB
+        if (client->shared)
+            continue;
+#endif
         write_stream(client, header, sizeof(header));
         write_stream(client, mvd.message.data, mvd.message.cursize);
         write_stream(client, msg_write.data, msg_write.cursize);
@@ -1082,6 +1100,11 @@ void SV_MvdEndFrame(void)
         NET_UpdateStream(&client->stream);
     }
 
+#if USE_ZLIB
+    // compress frame once for clients in shared stream
+    write_shared(header, total + 2);
+#endif
+
     // write frame to demofile
     if (mvd.recording) {
         rec_frame(total - 1);
@@ -1320,6 +1343,14 @@ static void flush_stream(gtv_client_t *client, int flush)
         return;
     }
 
+    if (client->shared) {
+        if (flush != Z_FINISH)
+            return; // shared stream is flushed elsewhere
+        leave_shared(client);
+        if (!z->state)
+            return; // dropped while syncing
+    }
+
     z->next_in = NULL;
     z->avail_in = 0;
 
@@ -1341,6 +1372,174 @@ static void flush_stream(gtv_client_t *client, int flush)
             client->bufcount = 0;
         }
     } while (ret == Z_OK);
+
+    // deflate is raw, write zlib trailer
+    if (ret == Z_STREAM_END) {
+        byte trailer[4];
+
+        trailer[0] = (client->adler >> 24) & 255;
+        trailer[1] = (client->adler >> 16) & 255;
+        trailer[2] = (client->adler >> 8) & 255;
+        trailer[3] = client->adler & 255;
+        FIFO_Write(fifo, trailer, sizeof(trailer));
+    }
+}
+
+/*
+==============================================================================
+
+SHARED FRAME COMPRESSION
+
+Frames are identical for all GTV clients, so they are deflated once into a
+single raw deflate stream and the output is copied to every client that
+joined it. Each client still owns a private raw deflate stream for data
+specific to it, and the zlib header and trailer are written by hand.
+
+Joining is only possible right after a full flush of the shared stream, and
+after a full flush of client private stream, so that neither stream has
+back-references crossing data inserted by the other. Any private write
+first syncs the shared stream and moves client out of it; it rejoins at the
+next full flush, which happens every MVD_SHARED_FRAMES frames.
+
+==============================================================================
+*/
+
+#define MVD_SHARED_FRAMES   50
+
+// writes compressed shared stream data to all clients in it
+static void distribute_shared(byte *data, size_t len)
+{
+    gtv_client_t *client;
+
+    mvd.z_bytes_out += len;
+
+    FOR_EACH_ACTIVE_GTV(client) {
+        if (!client->shared)
+            continue;
+        if (FIFO_Write(&client->stream.send, data, len) != len) {
+            // can't finish zlib stream now, just drop
+            client->shared = false;
+            deflateEnd(&client->z);
+            drop_client(client, "overflowed");
+            continue;
+        }
+        client->bufcount = 0;
+    }
+}
+
+static void deflate_shared(byte *data, size_t len, int flush)
+{
+    z_streamp z = &mvd.z;
+    byte buffer[0x2000];
+    int ret;
+
+    z->next_in = data;
+    z->avail_in = (uInt)len;
+
+    do {
+        z->next_out = buffer;
+        z->avail_out = sizeof(buffer);
+
+        ret = deflate(z, flush);
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            gtv_client_t *client;
+
+            FOR_EACH_ACTIVE_GTV(client)
+                client->shared = false;
+            mvd_error("shared deflate() failed");
+            return;
+        }
+
+        if (z->avail_out < sizeof(buffer))
+            distribute_shared(buffer, sizeof(buffer) - z->avail_out);
+    } while (z->avail_in || !z->avail_out);
+
+    mvd.z_pending = (flush == Z_NO_FLUSH);
+    if (flush != Z_NO_FLUSH)
+        mvd.z_bufcount = 0;
+    if (flush == Z_FULL_FLUSH)
+        mvd.z_frames = 0;
+}
+
+// makes sure client got complete output for data fed so far, and leaves.
+// sync flush is harmless for others remaining in shared stream.
+static void leave_shared(gtv_client_t *client)
+{
+    if (mvd.z_pending)
+        deflate_shared(NULL, 0, Z_SYNC_FLUSH);
+
+    client->shared = false;
+}
+
+static void write_shared(byte *header, size_t total)
+{
+    gtv_client_t *client;
+    unsigned maxbuf = UINT_MAX;
+    uLong adler;
+    int flush;
+
+    FOR_EACH_ACTIVE_GTV(client) {
+        if (client->shared)
+            maxbuf = min(maxbuf, client->maxbuf);
+    }
+
+    if (maxbuf != UINT_MAX) {
+        adler = adler32(1, header, 3);
+        adler = adler32(adler, mvd.message.data, mvd.message.cursize);
+        adler = adler32(adler, msg_write.data, msg_write.cursize);
+        adler = adler32(adler, mvd.datagram.data, mvd.datagram.cursize);
+
+        FOR_EACH_ACTIVE_GTV(client) {
+            if (client->shared)
+                client->adler = adler32_combine(client->adler, adler, total);
+        }
+
+        mvd.z_bytes_in += total;
+        mvd.z_frames++;
+
+        deflate_shared(header, 3, Z_NO_FLUSH);
+        deflate_shared(mvd.message.data, mvd.message.cursize, Z_NO_FLUSH);
+        deflate_shared(msg_write.data, msg_write.cursize, Z_NO_FLUSH);
+
+        if (mvd.z_frames >= MVD_SHARED_FRAMES)
+            flush = Z_FULL_FLUSH;
+        else if (++mvd.z_bufcount > maxbuf)
+            flush = Z_SYNC_FLUSH;
+        else
+            flush = Z_NO_FLUSH;
+
+        deflate_shared(mvd.datagram.data, mvd.datagram.cursize, flush);
+
+        FOR_EACH_ACTIVE_GTV(client) {
+            if (client->shared)
+                NET_UpdateStream(&client->stream);
+        }
+    } else if (mvd.z_frames) {
+        // nobody depends on history
+        deflateReset(&mvd.z);
+        mvd.z_frames = mvd.z_bufcount = 0;
+        mvd.z_pending = false;
+    }
+
+    if (mvd.z_frames)
+        return;
+
+    // at full flush point, other deflate clients can join
+    FOR_EACH_ACTIVE_GTV(client) {
+        if (client->shared || !client->z.state)
+            continue;
+        if (!mvd.z.state) {
+            mvd.z.zalloc = SV_zalloc;
+            mvd.z.zfree = SV_zfree;
+            if (deflateInit2(&mvd.z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                             -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                mvd_error("deflateInit2() failed");
+                return;
+            }
+        }
+        flush_stream(client, Z_FULL_FLUSH);
+        client->shared = true;
+    }
 }
 #endif
 
@@ -1362,6 +1561,12 @@ static void drop_client(gtv_client_t *client, const char *error)
         flush_stream(client, Z_FINISH);
         deflateEnd(&client->z);
     }
+    client->shared = false;
+
+    // could have been dropped recursively
+    if (client->state <= cs_zombie) {
+        return;
+    }
 #endif
 
     List_Remove(&client->active);
@@ -1386,6 +1591,14 @@ static void write_stream(gtv_client_t *client, void *data, size_t len)
     if (client->z.state) {
         z_streamp z = &client->z;
 
+        if (client->shared) {
+            leave_shared(client);
+            if (client->state <= cs_zombie)
+                return; // dropped while syncing
+        }
+
+        client->adler = adler32(client->adler, data, len);
+
         z->next_in = data;
         z->avail_in = (uInt)len;
 
@@ -1509,14 +1722,20 @@ static void parse_hello(gtv_client_t *client)
     SZ_Clear(&msg_write);
 
 #if USE_ZLIB
-    // the rest of the stream will be deflated
+    // the rest of the stream will be deflated. zlib header and trailer are
+    // written by hand, so that output of shared stream can be spliced in.
     if (flags & GTF_DEFLATE) {
+        static const byte header[2] = { 0x78, 0x9c };
+
         client->z.zalloc = SV_zalloc;
         client->z.zfree = SV_zfree;
-        if (deflateInit(&client->z, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        if (deflateInit2(&client->z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
             drop_client(client, "deflateInit failed");
             return;
         }
+        client->adler = adler32(0, NULL, 0);
+        FIFO_Write(&client->stream.send, header, sizeof(header));
     }
 #endif
 
@@ -1874,6 +2093,12 @@ static void dump_clients(void)
             Com_Printf("PRIM ");
             break;
         default:
+#if USE_ZLIB
+            if (client->shared) {
+                Com_Printf("SHRD ");
+                break;
+            }
+#endif
             Com_Printf("SEND ");
             break;
         }
@@ -1911,6 +2136,12 @@ void SV_MvdStatus_f(void)
             dump_clients();
         }
     }
+#if USE_ZLIB
+    if (mvd.z_bytes_in) {
+        Com_Printf("Shared stream: %"PRIu64" KB in, %"PRIu64" KB out\n",
+                   mvd.z_bytes_in / 1024, mvd.z_bytes_out / 1024);
+    }
+#endif
     Com_Printf("\n");
 }
 
@@ -2120,6 +2351,11 @@ void SV_MvdShutdown(error_type_t type)
     // drop all clients
     mvd_drop(type == ERR_RECONNECT ? GTS_RECONNECT : GTS_DISCONNECT);
 
+#if USE_ZLIB
+    if (mvd.z.state)
+        deflateEnd(&mvd.z);
+#endif
+
     // free static data
     Z_Free(mvd.message.data);
     Z_Free(mvd.datagram.data);
@@ -2226,7 +2462,7 @@ void SV_MvdRecord_f(void)
 {
     char buffer[MAX_OSPATH];
     qhandle_t f;
-    unsigned mode = FS_MODE_WRITE;
+    unsigned mode = FS_MODE_WRITE | FS_FLAG_ASYNC;
     int c;
 
     if (sv.state != ss_game) {
@@ -77,6 +77,7 @@ typedef struct gtv_s {
     int             demoloop, demoskip;
     string_entry_t  *demohead, *demoentry;
     int64_t         demosize, demopos;
+    int             demosnaps, demoservercount;
     bool            demowait;
 } gtv_t;
 
@@ -116,9 +117,14 @@ static cvar_t  *mvd_suspend_time;
 static cvar_t  *mvd_wait_delay;
 static cvar_t  *mvd_wait_percent;
 static cvar_t  *mvd_buffer_size;
+static cvar_t  *mvd_buffer_spill;
 static cvar_t  *mvd_username;
 static cvar_t  *mvd_password;
 static cvar_t  *mvd_snaps;
+static cvar_t  *mvd_snapsize;
+static cvar_t  *mvd_demoindex;
+
+static void demo_save_index(gtv_t *gtv);
 
 // ====================================================================
 
@@ -138,12 +144,9 @@ void MVD_StopRecord(mvd_t *mvd)
 
 static void MVD_Free(mvd_t *mvd)
 {
-    mvd_snap_t *snap, *next;
     int i;
 
-    LIST_FOR_EACH_SAFE(mvd_snap_t, snap, next, &mvd->snapshots, entry) {
-        Z_Free(snap);
-    }
+    Demo_FreeSnapshots(&mvd->snapshots);
 
     // stop demo recording
     if (mvd->demorecording) {
@@ -158,7 +161,7 @@ static void MVD_Free(mvd_t *mvd)
 
     CM_FreeMap(&mvd->cm);
 
-    Z_Free(mvd->delay.data);
+    MVD_DelayFree(&mvd->delay);
 
     List_Remove(&mvd->entry);
     Z_Free(mvd);
@@ -180,6 +183,7 @@ static void MVD_Destroy(mvd_t *mvd)
 
     // destroy any existing GTV connection
     if (mvd->gtv) {
+        demo_save_index(mvd->gtv);
         mvd->gtv->mvd = NULL; // don't double destroy
         mvd->gtv->destroy(mvd->gtv);
     }
@@ -328,7 +332,6 @@ static mvd_t *create_channel(gtv_t *gtv)
     mvd->pool.max_edicts = MAX_EDICTS;
     mvd->pm_type = PM_SPECTATOR;
     mvd->min_packets = mvd_wait_delay->integer;
-    List_Init(&mvd->snapshots);
     List_Init(&mvd->clients);
     List_Init(&mvd->entry);
 
@@ -548,7 +551,7 @@ static int demo_read_first(qhandle_t f)
 // state, configstrings and layouts at the given server frame.
 static void demo_emit_snapshot(mvd_t *mvd)
 {
-    mvd_snap_t *snap;
+    demosnap_t *snap;
     gtv_t *gtv;
     int64_t pos;
     char *from, *to;
@@ -558,7 +561,13 @@ static void demo_emit_snapshot(mvd_t *mvd)
     if (mvd_snaps->integer <= 0)
         return;
 
-    if (mvd->framenum < mvd->last_snapshot + mvd_snaps->integer * 10)
+    // never emit snapshots before the most recent one
+    if (mvd->framenum <= mvd->last_snapshot)
+        return;
+
+    // emit early if too much data was parsed since the last snapshot
+    if (mvd->framenum < mvd->last_snapshot + mvd_snaps->integer * 10 &&
+        mvd_snapsize->integer <= 0)
         return;
 
     gtv = mvd->gtv;
@@ -572,6 +581,12 @@ static void demo_emit_snapshot(mvd_t *mvd)
     if (pos < gtv->demopos)
         return;
 
+    if (mvd->framenum < mvd->last_snapshot + mvd_snaps->integer * 10) {
+        snap = Demo_LastSnapshot(&mvd->snapshots);
+        if (snap && pos - snap->filepos < mvd_snapsize->integer * 1024LL)
+            return;
+    }
+
     // write baseline frame
     MSG_WriteByte(mvd_frame);
     emit_base_frame(mvd);
@@ -601,7 +616,7 @@ static void demo_emit_snapshot(mvd_t *mvd)
     snap->filepos = pos;
     snap->msglen = msg_write.cursize;
     memcpy(snap->data, msg_write.data, msg_write.cursize);
-    List_Append(&mvd->snapshots, &snap->entry);
+    Demo_AddSnapshot(&mvd->snapshots, snap, TAG_MVD);
 
     Com_DPrintf("[%d] snaplen %zu\n", mvd->framenum, msg_write.cursize);
 
@@ -610,22 +625,59 @@ static void demo_emit_snapshot(mvd_t *mvd)
     mvd->last_snapshot = mvd->framenum;
 }
 
-static mvd_snap_t *demo_find_snapshot(mvd_t *mvd, int framenum)
+static void demo_load_index(gtv_t *gtv)
 {
-    mvd_snap_t *snap, *prev;
+    mvd_t *mvd = gtv->mvd;
+    demosnap_t *snap;
+    int ret;
 
-    if (LIST_EMPTY(&mvd->snapshots))
-        return NULL;
+    gtv->demosnaps = 0;
+    gtv->demoservercount = mvd->servercount;
 
-    prev = LIST_FIRST(mvd_snap_t, &mvd->snapshots, entry);
+    if (!mvd_demoindex->integer || mvd_snaps->integer <= 0 || !gtv->demosize)
+        return;
 
-    LIST_FOR_EACH(mvd_snap_t, snap, &mvd->snapshots, entry) {
-        if (snap->framenum > framenum)
-            break;
-        prev = snap;
+    ret = Demo_LoadIndex(gtv->demoentry->string, gtv->demoplayback,
+                         &mvd->snapshots, TAG_MVD);
+    if (ret < 0 && ret != Q_ERR_NOENT) {
+        Com_DPrintf("Couldn't load index for %s: %s\n",
+                    gtv->demoentry->string, Q_ErrorString(ret));
     }
+    if (ret <= 0)
+        return;
+
+    // don't emit snapshots already present in index
+    snap = Demo_LastSnapshot(&mvd->snapshots);
+    mvd->last_snapshot = snap->framenum;
+    gtv->demosnaps = ret;
 
-    return prev;
+    Com_DPrintf("Loaded %d snapshots from index\n", ret);
+}
+
+static void demo_save_index(gtv_t *gtv)
+{
+    mvd_t *mvd = gtv->mvd;
+    int ret;
+
+    if (!mvd_demoindex->integer || !mvd || !gtv->demoplayback || !gtv->demosize)
+        return;
+
+    // snapshots of previous maps are lost on map change, only index
+    // single map demos
+    if (mvd->servercount != gtv->demoservercount)
+        return;
+
+    // only write index if some new snapshots were emitted
+    if (mvd->snapshots.numsnaps <= gtv->demosnaps)
+        return;
+
+    ret = Demo_SaveIndex(gtv->demoentry->string, gtv->demoplayback, &mvd->snapshots);
+    if (ret < 0) {
+        Com_DPrintf("Couldn't save index for %s: %s\n",
+                    gtv->demoentry->string, Q_ErrorString(ret));
+    } else {
+        Com_DPrintf("Saved %d snapshots to index\n", ret);
+    }
 }
 
 static void demo_update(gtv_t *gtv)
@@ -707,8 +759,10 @@ static void demo_play_next(gtv_t *gtv, string_entry_t *entry)
 
     // close previous file
     if (gtv->demoplayback) {
+        demo_save_index(gtv);
         FS_FCloseFile(gtv->demoplayback);
         gtv->demoplayback = 0;
+        gtv->demosize = 0;
     }
 
     // open new file
@@ -753,6 +807,7 @@ static void demo_play_next(gtv_t *gtv, string_entry_t *entry)
         gtv->demosize = gtv->demopos = 0;
     }
 
+    demo_load_index(gtv);
     demo_emit_snapshot(gtv->mvd);
 }
 
@@ -772,6 +827,8 @@ static void demo_destroy(gtv_t *gtv)
 {
     mvd_t *mvd = gtv->mvd;
 
+    demo_save_index(gtv);
+
     // destroy any associated MVD channel
     if (mvd) {
         mvd->gtv = NULL;
@@ -840,20 +897,20 @@ static bool gtv_wait_stop(mvd_t *mvd)
 
     // if not connected, flush any data left
     if (!gtv || gtv->state != GTV_READING) {
-        if (!mvd->num_packets) {
+        if (!mvd->delay.num_packets) {
             gtv_oob_kill(mvd);
         }
         min_packets = 1;
     }
 
     // see how many frames are buffered
-    if (mvd->num_packets >= min_packets) {
+    if (mvd->delay.num_packets >= min_packets) {
         Com_Printf("[%s] -=- Waiting finished, reading...\n", mvd->name);
         goto stop;
     }
 
     // see how much data is buffered
-    usage = FIFO_Percent(&mvd->delay);
+    usage = MVD_DelayPercent(&mvd->delay);
     if (usage >= mvd_wait_percent->integer) {
         Com_Printf("[%s] -=- Buffering finished, reading...\n", mvd->name);
         goto stop;
@@ -911,8 +968,6 @@ static void gtv_wait_start(mvd_t *mvd)
 
 static bool gtv_read_frame(mvd_t *mvd)
 {
-    uint16_t msglen;
-
     switch (mvd->state) {
     case MVD_WAITING:
         if (!gtv_wait_stop(mvd)) {
@@ -920,7 +975,7 @@ static bool gtv_read_frame(mvd_t *mvd)
         }
         break;
     case MVD_READING:
-        if (!mvd->num_packets) {
+        if (!mvd->delay.num_packets) {
             gtv_wait_start(mvd);
             return false;
         }
@@ -932,24 +987,11 @@ static bool gtv_read_frame(mvd_t *mvd)
     // NOTE: if we got here, delay buffer MUST contain
     // at least one complete, non-empty packet
 
-    // parse msglen
-    if (FIFO_Read(&mvd->delay, &msglen, 2) != 2) {
-        MVD_Destroyf(mvd, "%s: partial data", __func__);
-    }
-
-    msglen = LittleShort(msglen);
-    if (msglen < 1 || msglen > MAX_MSGLEN) {
-        MVD_Destroyf(mvd, "%s: invalid msglen", __func__);
-    }
-
     // read this message
-    if (!FIFO_ReadMessage(&mvd->delay, msglen)) {
-        MVD_Destroyf(mvd, "%s: partial data", __func__);
+    if (!MVD_DelayRead(&mvd->delay)) {
+        MVD_Destroyf(mvd, "%s: corrupted delay buffer", __func__);
     }
 
-    // decrement buffered packets counter
-    mvd->num_packets--;
-
     // parse it
     MVD_ParseMessage(mvd);
     return true;
@@ -1132,7 +1174,6 @@ static void parse_stream_stop(gtv_t *gtv)
 static void parse_stream_data(gtv_t *gtv)
 {
     mvd_t *mvd = gtv->mvd;
-    size_t size;
 
     if (gtv->state < GTV_WAITING) {
         gtv_destroyf(gtv, "Unexpected stream data packet");
@@ -1163,12 +1204,12 @@ static void parse_stream_data(gtv_t *gtv)
     if (!mvd) {
         mvd = create_channel(gtv);
 
-        Cvar_ClampInteger(mvd_buffer_size, 2, 10);
+        Cvar_ClampInteger(mvd_buffer_size, 1, 1024);
+        Cvar_ClampInteger(mvd_buffer_spill, 0, 1024);
 
         // allocate delay buffer
-        size = mvd_buffer_size->integer * MAX_MSGLEN;
-        mvd->delay.data = MVD_Malloc(size);
-        mvd->delay.size = size;
+        MVD_DelayInit(&mvd->delay, mvd_buffer_size->integer << 20,
+                      mvd_buffer_spill->integer << 20);
         mvd->read_frame = gtv_read_frame;
         mvd->forward_cmd = gtv_forward_cmd;
 
@@ -1181,10 +1222,9 @@ static void parse_stream_data(gtv_t *gtv)
     } else {
         byte *data = msg_read.data + 1;
         size_t len = msg_read.cursize - 1;
-        uint16_t msglen;
 
-        // see if this packet fits
-        if (FIFO_Write(&mvd->delay, NULL, len + 2) != len + 2) {
+        // write it into delay buffer, if it fits
+        if (!MVD_DelayWrite(&mvd->delay, data, len)) {
             if (mvd->state == MVD_WAITING) {
                 // if delay buffer overflowed in waiting state,
                 // something is seriously wrong, disconnect for safety
@@ -1202,9 +1242,8 @@ static void parse_stream_data(gtv_t *gtv)
 
             // clear entire delay buffer
             // minimize the delay
-            FIFO_Clear(&mvd->delay);
+            MVD_DelayClear(&mvd->delay);
             mvd->state = MVD_WAITING;
-            mvd->num_packets = 0;
             mvd->min_packets = 50;
             mvd->overflows++;
 
@@ -1214,14 +1253,6 @@ static void parse_stream_data(gtv_t *gtv)
             return;
         }
 
-        // write it into delay buffer
-        msglen = LittleShort(len);
-        FIFO_Write(&mvd->delay, &msglen, 2);
-        FIFO_Write(&mvd->delay, data, len);
-
-        // increment buffered packets counter
-        mvd->num_packets++;
-
         msg_read.readcount = msg_read.cursize;
     }
 }
@@ -1676,7 +1707,7 @@ static void list_generic(void)
                    mvd->id, mvd->name, mvd->mapname,
                    List_Count(&mvd->clients), mvd->numplayers,
                    mvd_states[mvd->state],
-                   FIFO_Percent(&mvd->delay), mvd->num_packets,
+                   MVD_DelayPercent(&mvd->delay), mvd->delay.num_packets,
                    mvd->gtv ? mvd->gtv->address : "<disconnected>");
     }
 }
@@ -1873,7 +1904,7 @@ void MVD_StreamedRecord_f(void)
     mvd_t *mvd;
     uint32_t magic;
     uint16_t msglen;
-    unsigned mode = FS_MODE_WRITE;
+    unsigned mode = FS_MODE_WRITE | FS_FLAG_ASYNC;
     int ret;
     int c;
 
@@ -2132,7 +2163,7 @@ static void MVD_Seek_f(void)
 {
     mvd_t *mvd;
     gtv_t *gtv;
-    mvd_snap_t *snap;
+    demosnap_t *snap;
     int i, j, ret, index, frames, dest;
     char *from, *to;
     edict_t *ent;
@@ -2197,7 +2228,11 @@ static void MVD_Seek_f(void)
 
     // seek to the previous most recent snapshot
     if (frames < 0 || mvd->last_snapshot > mvd->framenum) {
-        snap = demo_find_snapshot(mvd, dest);
+        snap = Demo_FindSnapshot(&mvd->snapshots, dest);
+
+        // when seeking forward, only use snapshots ahead of current frame
+        if (snap && frames > 0 && snap->framenum <= mvd->framenum)
+            snap = NULL;
 
         if (snap) {
             Com_DPrintf("found snap at %d\n", snap->framenum);
@@ -2498,6 +2533,362 @@ static void MVD_Play_f(void)
 }
 
 
+/*
+====================================================================
+
+DEMO ANALYZER
+
+Parses MVD demos on a detached channel without loading maps or spawning
+the broadcast server, and dumps per frame player and event tables in
+columnar form. Output file layout (all values little endian):
+
+  "MVDA" version
+  segment*:
+    demo and map names (length prefixed)
+    player row count, event row count
+    player columns: frame, clientnum, pm_type, origin[0..2], frags
+    event columns: frame, entnum, event
+
+Each segment covers one gamestate of one demo.
+
+====================================================================
+*/
+
+#define ANALYZE_MAGIC   MakeRawLong('M','V','D','A')
+#define ANALYZE_VERSION 1
+
+typedef struct {
+    byte        *data;
+    size_t      size;
+} anacol_t;
+
+typedef struct {
+    anacol_t    cols[8];
+    int         numcols;
+    size_t      rows, maxrows;
+} anatable_t;
+
+enum { PC_FRAME, PC_CLIENT, PC_PMTYPE, PC_X, PC_Y, PC_Z, PC_FRAGS, PC_NUM };
+enum { EC_FRAME, EC_ENTNUM, EC_EVENT, EC_NUM };
+
+static struct {
+    anatable_t  players;
+    anatable_t  events;
+    char        demoname[MAX_QPATH];
+    char        mapname[MAX_QPATH];
+    qhandle_t   out;
+    int         error;      // first write error, stops analysis
+    int         framenum;
+    unsigned    numframes;
+} ana;
+
+#define ANA_CELL(t, c, type)    (((type *)(t)->cols[c].data)[(t)->rows])
+
+static void ana_init_table(anatable_t *t, const size_t *sizes, int numcols)
+{
+    int i;
+
+    memset(t, 0, sizeof(*t));
+    for (i = 0; i < numcols; i++) {
+        t->cols[i].size = sizes[i];
+    }
+    t->numcols = numcols;
+}
+
+static void ana_free_table(anatable_t *t)
+{
+    int i;
+
+    for (i = 0; i < t->numcols; i++) {
+        Z_Free(t->cols[i].data);
+    }
+    memset(t, 0, sizeof(*t));
+}
+
+static void ana_grow_table(anatable_t *t)
+{
+    int i;
+
+    if (t->rows < t->maxrows) {
+        return;
+    }
+
+    t->maxrows = t->maxrows ? t->maxrows * 2 : 4096;
+    for (i = 0; i < t->numcols; i++) {
+        t->cols[i].data = Z_Realloc(t->cols[i].data, t->maxrows * t->cols[i].size);
+    }
+}
+
+static void ana_write(const void *data, size_t len)
+{
+    int ret;
+
+    if (ana.error || !len) {
+        return;
+    }
+
+    ret = FS_Write(data, len, ana.out);
+    if (ret < 0) {
+        ana.error = ret;
+    }
+}
+
+static void ana_write_string(const char *s)
+{
+    byte len = min(strlen(s), 255);
+
+    ana_write(&len, 1);
+    ana_write(s, len);
+}
+
+static void ana_flush_segment(void)
+{
+    anatable_t *tables[2] = { &ana.players, &ana.events };
+    uint32_t count;
+    int i, j;
+
+    if (!ana.players.rows && !ana.events.rows) {
+        return;
+    }
+
+    ana_write_string(ana.demoname);
+    ana_write_string(ana.mapname);
+    for (i = 0; i < 2; i++) {
+        count = LittleLong(tables[i]->rows);
+        ana_write(&count, 4);
+    }
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < tables[i]->numcols; j++) {
+            ana_write(tables[i]->cols[j].data,
+                      tables[i]->rows * tables[i]->cols[j].size);
+        }
+        tables[i]->rows = 0;
+    }
+}
+
+static void ana_sample_frame(mvd_t *mvd)
+{
+    anatable_t *t;
+    mvd_player_t *player;
+    edict_t *ent;
+    int i;
+
+    t = &ana.players;
+    for (i = 0; i < mvd->maxclients; i++) {
+        player = &mvd->players[i];
+        if (!player->inuse || player == mvd->dummy) {
+            continue;
+        }
+        ana_grow_table(t);
+        ANA_CELL(t, PC_FRAME, int32_t) = LittleLong(ana.framenum - 1);
+        ANA_CELL(t, PC_CLIENT, uint8_t) = i;
+        ANA_CELL(t, PC_PMTYPE, uint8_t) = player->ps.pmove.pm_type;
+        ANA_CELL(t, PC_X, int16_t) = LittleShort(player->ps.pmove.origin[0]);
+        ANA_CELL(t, PC_Y, int16_t) = LittleShort(player->ps.pmove.origin[1]);
+        ANA_CELL(t, PC_Z, int16_t) = LittleShort(player->ps.pmove.origin[2]);
+        ANA_CELL(t, PC_FRAGS, int16_t) = LittleShort(player->ps.stats[STAT_FRAGS]);
+        t->rows++;
+    }
+
+    // events are only valid for a single frame, same as MVD_PrepWorldFrame
+    t = &ana.events;
+    for (i = 1; i < mvd->pool.num_edicts; i++) {
+        ent = &mvd->edicts[i];
+        if (!ent->inuse || !ent->s.event) {
+            continue;
+        }
+        ana_grow_table(t);
+        ANA_CELL(t, EC_FRAME, int32_t) = LittleLong(ana.framenum - 1);
+        ANA_CELL(t, EC_ENTNUM, uint16_t) = LittleShort(i);
+        ANA_CELL(t, EC_EVENT, uint8_t) = ent->s.event;
+        t->rows++;
+        ent->s.event = 0;
+    }
+
+    ana.numframes++;
+}
+
+static mvd_t *ana_create_channel(const char *path)
+{
+    mvd_t *mvd;
+
+    mvd = MVD_Mallocz(sizeof(*mvd));
+    mvd->id = -1;
+    Q_strlcpy(mvd->name, COM_SkipPath(path), sizeof(mvd->name));
+    mvd->pool.edicts = mvd->edicts;
+    mvd->pool.edict_size = sizeof(edict_t);
+    mvd->pool.max_edicts = MAX_EDICTS;
+    mvd->pm_type = PM_SPECTATOR;
+    mvd->demoseeking = true;
+    mvd->headless = true;
+    List_Init(&mvd->clients);
+    List_Init(&mvd->entry);
+
+    return mvd;
+}
+
+static void ana_parse_demo(const char *path)
+{
+    mvd_t *mvd;
+    qhandle_t f;
+    int ret;
+
+    ret = FS_FOpenFile(path, &f, FS_MODE_READ | FS_FLAG_GZIP);
+    if (!f) {
+        Com_EPrintf("Couldn't open %s: %s\n", path, Q_ErrorString(ret));
+        return;
+    }
+
+    ret = demo_read_first(f);
+    if (ret < 0) {
+        Com_EPrintf("Couldn't read %s: %s\n", path, Q_ErrorString(ret));
+        FS_FCloseFile(f);
+        return;
+    }
+
+    Q_strlcpy(ana.demoname, COM_SkipPath(path), sizeof(ana.demoname));
+    ana.mapname[0] = 0;
+    ana.framenum = -1;
+
+    // MVD_Destroyf frees the channel before jumping back here,
+    // keep whatever was parsed up to the error
+    if (setjmp(mvd_jmpbuf)) {
+        goto finish;
+    }
+
+    mvd = ana_create_channel(path);
+
+    while (1) {
+        // start new segment on each gamestate
+        if (MVD_ParseMessage(mvd)) {
+            ana_flush_segment();
+            Q_strlcpy(ana.mapname, mvd->mapname, sizeof(ana.mapname));
+        }
+
+        if (ana.error) {
+            break;
+        }
+
+        if (mvd->framenum != ana.framenum) {
+            ana.framenum = mvd->framenum;
+            ana_sample_frame(mvd);
+        }
+
+        ret = demo_read_message(f);
+        if (ret <= 0) {
+            break;
+        }
+    }
+
+    if (ret < 0) {
+        Com_EPrintf("Couldn't read %s: %s\n", path, Q_ErrorString(ret));
+    }
+
+    MVD_Free(mvd);
+
+finish:
+    ana_flush_segment();
+    FS_FCloseFile(f);
+}
+
+static const cmd_option_t o_mvdanalyze[] = {
+    { "h", "help", "display this message" },
+    { "o:filename", "output", "write tables to <filename> (default is analysis)" },
+    { NULL }
+};
+
+static void MVD_Analyze_c(genctx_t *ctx, int argnum)
+{
+    Cmd_Option_c(o_mvdanalyze, MVD_File_g, ctx, argnum);
+}
+
+static void MVD_Analyze_f(void)
+{
+    static const size_t player_sizes[PC_NUM] = { 4, 1, 1, 2, 2, 2, 2 };
+    static const size_t event_sizes[EC_NUM] = { 4, 2, 1 };
+    char *output = "analysis";
+    char buffer[MAX_OSPATH];
+    uint32_t header[2];
+    unsigned start, numdemos;
+    int c, i, ret;
+    qhandle_t f;
+
+    while ((c = Cmd_ParseOptions(o_mvdanalyze)) != -1) {
+        switch (c) {
+        case 'h':
+            Cmd_PrintUsage(o_mvdanalyze, "[/]<filename> [...]");
+            Com_Printf("Parse MVD demos without playing them back and write\n"
+                       "per frame player positions, frags and entity events\n"
+                       "as columnar tables.\n");
+            Cmd_PrintHelp(o_mvdanalyze);
+            Com_Printf("Final path is formatted as demos/<filename>.mvd2.\n"
+                       "Prepend slash to specify raw path.\n");
+            return;
+        case 'o':
+            output = cmd_optarg;
+            break;
+        default:
+            return;
+        }
+    }
+
+    if (cmd_optind == Cmd_Argc()) {
+        Com_Printf("Missing filename argument.\n");
+        Cmd_PrintHint();
+        return;
+    }
+
+    ana.out = FS_EasyOpenFile(buffer, sizeof(buffer), FS_MODE_WRITE,
+                              "demos/", output, ".mva");
+    if (!ana.out) {
+        return;
+    }
+
+    header[0] = ANALYZE_MAGIC;
+    header[1] = LittleLong(ANALYZE_VERSION);
+    ana.error = 0;
+    ana_write(header, sizeof(header));
+
+    ana_init_table(&ana.players, player_sizes, PC_NUM);
+    ana_init_table(&ana.events, event_sizes, EC_NUM);
+    ana.numframes = 0;
+
+    start = Sys_Milliseconds();
+    numdemos = 0;
+
+    for (i = cmd_optind; i < Cmd_Argc() && !ana.error; i++) {
+        char path[MAX_OSPATH];
+
+        f = FS_EasyOpenFile(path, sizeof(path), FS_MODE_READ,
+                            "demos/", Cmd_Argv(i), ".mvd2");
+        if (!f) {
+            continue;
+        }
+        FS_FCloseFile(f);
+
+        ana_parse_demo(path);
+        numdemos++;
+    }
+
+    ana_free_table(&ana.players);
+    ana_free_table(&ana.events);
+
+    ret = FS_FCloseFile(ana.out);
+    ana.out = 0;
+    if (ana.error) {
+        ret = ana.error;
+    }
+    if (ret) {
+        Com_EPrintf("Couldn't write %s: %s\n", buffer, Q_ErrorString(ret));
+        FS_RemoveFile(buffer);
+        return;
+    }
+
+    Com_Printf("Analyzed %u frames from %u demo%s in %u ms, wrote %s.\n",
+               ana.numframes, numdemos, numdemos == 1 ? "" : "s",
+               Sys_Milliseconds() - start, buffer);
+}
+
 void MVD_Shutdown(void)
 {
     gtv_t *gtv, *gtv_next;
@@ -2511,6 +2902,7 @@ void MVD_Shutdown(void)
     // kill all MVD channels (including demo GTVs)
     LIST_FOR_EACH_SAFE(mvd_t, mvd, mvd_next, &mvd_channel_list, entry) {
         if (mvd->gtv) {
+            demo_save_index(mvd->gtv);
             mvd->gtv->mvd = NULL; // don't double destroy
             mvd->gtv->destroy(mvd->gtv);
         }
@@ -2545,6 +2937,7 @@ static const cmdreg_t c_mvd[] = {
     { "mvdpause", MVD_Pause_f },
     { "mvdskip", MVD_Skip_f },
     { "mvdseek", MVD_Seek_f },
+    { "mvdanalyze", MVD_Analyze_f, MVD_Analyze_c },
 
     { NULL }
 };
@@ -2574,10 +2967,13 @@ void MVD_Register(void)
     mvd_wait_delay->changed = mvd_wait_delay_changed;
     mvd_wait_delay->changed(mvd_wait_delay);
     mvd_wait_percent = Cvar_Get("mvd_wait_percent", "35", 0);
-    mvd_buffer_size = Cvar_Get("mvd_buffer_size", "3", 0);
+    mvd_buffer_size = Cvar_Get("mvd_buffer_size", "4", 0);
+    mvd_buffer_spill = Cvar_Get("mvd_buffer_spill", "64", 0);
     mvd_username = Cvar_Get("mvd_username", "unnamed", 0);
     mvd_password = Cvar_Get("mvd_password", "", CVAR_PRIVATE);
     mvd_snaps = Cvar_Get("mvd_snaps", "10", 0);
+    mvd_snapsize = Cvar_Get("mvd_snapsize", "512", 0);
+    mvd_demoindex = Cvar_Get("mvd_demoindex", "1", 0);
 
     Cmd_Register(c_mvd);
 }
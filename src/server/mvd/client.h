@@ -17,6 +17,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 */
 
 #include "../server.h"
+#include "common/demo.h"
 #include <setjmp.h>
 
 #define MVD_Malloc(size)    Z_TagMalloc(size, TAG_MVD)
@@ -112,15 +113,25 @@ typedef enum {
     MVD_NUM_STATES
 } mvd_state_t;
 
+struct gtv_s;
+
+typedef struct mvd_chunk_s mvd_chunk_t;
+
 typedef struct {
-    list_t entry;
-    int framenum;
-    int64_t filepos;
-    size_t msglen;
-    byte data[1];
-} mvd_snap_t;
+    mvd_chunk_t *head, *tail;   // queued compressed chunks, oldest first
+    unsigned    num_chunks;
+    unsigned    num_packets;    // total messages buffered
 
-struct gtv_s;
+    byte        *write;         // chunk being written
+    size_t      write_len;
+
+    byte        *read;          // chunk being read
+    size_t      read_len, read_pos;
+
+    size_t      memsize, maxmem;
+    FILE        *fp;            // temporary file for spilled chunks
+    size_t      file_used, file_head, file_tail, maxfile;
+} mvd_delay_t;
 
 // FIXME: entire struct is > 500 kB in size!
 // need to eliminate those large static arrays below...
@@ -138,13 +149,14 @@ typedef struct mvd_s {
     qhandle_t   demorecording;
     char        *demoname;
     bool        demoseeking;
+    bool        headless;   // detached analysis channel, no map or clients
     int         last_snapshot;
-    list_t      snapshots;
+    demosnaps_t snapshots;
 
     // delay buffer
-    fifo_t      delay;
+    mvd_delay_t delay;
     size_t      msglen;
-    unsigned    num_packets, min_packets;
+    unsigned    min_packets;
     unsigned    underflows, overflows;
     int         framenum;
 
@@ -219,6 +231,18 @@ bool MVD_ParseMessage(mvd_t *mvd);
 void MVD_ParseEntityString(mvd_t *mvd, const char *data);
 void MVD_ClearState(mvd_t *mvd, bool full);
 
+//
+// mvd_delay.c
+//
+
+void MVD_DelayInit(mvd_delay_t *d, size_t maxmem, size_t maxfile);
+void MVD_DelayFree(mvd_delay_t *d);
+void MVD_DelayClear(mvd_delay_t *d);
+bool MVD_DelayWrite(mvd_delay_t *d, const void *data, size_t len);
+bool MVD_DelayRead(mvd_delay_t *d);
+size_t MVD_DelayUsage(const mvd_delay_t *d);
+int MVD_DelayPercent(const mvd_delay_t *d);
+
 //
 // mvd_game.c
 //
@@ -0,0 +1,349 @@
+/*
+Copyright (C) 2003-2006 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// mvd_delay.c -- GTV delay buffer
+//
+// Incoming messages are collected into fixed size chunks. Once a chunk is
+// full, it is deflated and queued until it is due. Queued chunks are kept
+// in memory up to a limit, past that they are spilled into a temporary file
+// that is used as a ring buffer. Only the chunk currently being read and
+// the chunk currently being written are kept uncompressed.
+//
+
+#include "client.h"
+
+#define DELAY_CHUNK_SIZE    (4 * MAX_MSGLEN)
+
+struct mvd_chunk_s {
+    mvd_chunk_t *next;
+    size_t      rawlen;     // uncompressed length
+    size_t      complen;    // length in memory or on disk
+    size_t      offset;     // offset in temporary file
+    byte        *data;      // NULL if spilled
+};
+
+#if USE_ZLIB
+static byte delay_scratch[DELAY_CHUNK_SIZE + DELAY_CHUNK_SIZE / 1000 + 64];
+#else
+static byte delay_scratch[DELAY_CHUNK_SIZE];
+#endif
+
+void MVD_DelayInit(mvd_delay_t *d, size_t maxmem, size_t maxfile)
+{
+    memset(d, 0, sizeof(*d));
+    d->maxmem = maxmem;
+    d->maxfile = maxfile;
+    d->write = MVD_Malloc(DELAY_CHUNK_SIZE);
+    d->read = MVD_Malloc(DELAY_CHUNK_SIZE);
+}
+
+// find space for a chunk in temporary file
+static bool alloc_file_space(mvd_delay_t *d, size_t len, size_t *offset)
+{
+    if (!d->fp) {
+        d->fp = tmpfile();
+        if (!d->fp) {
+            Com_EPrintf("Couldn't create temporary file for delay buffer: %s\n",
+                        strerror(errno));
+            d->maxfile = 0;
+            return false;
+        }
+    }
+
+    if (d->file_head > d->file_tail || !d->file_used) {
+        // free space is at the end and at the start of file
+        if (d->file_head + len <= d->maxfile) {
+            *offset = d->file_head;
+            return true;
+        }
+        if (len <= d->file_tail) {
+            *offset = 0;
+            return true;
+        }
+    } else {
+        // free space is between head and tail
+        if (d->file_head + len <= d->file_tail) {
+            *offset = d->file_head;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool spill_chunk(mvd_delay_t *d, mvd_chunk_t *chunk, const byte *data)
+{
+    size_t offset;
+
+    if (d->file_used + chunk->complen > d->maxfile)
+        return false;
+
+    if (!alloc_file_space(d, chunk->complen, &offset))
+        return false;
+
+    if (fseek(d->fp, (long)offset, SEEK_SET) ||
+        fwrite(data, 1, chunk->complen, d->fp) != chunk->complen) {
+        Com_EPrintf("Couldn't write delay buffer to temporary file\n");
+        return false;
+    }
+
+    if (!d->file_used)
+        d->file_tail = offset;
+
+    chunk->offset = offset;
+    d->file_head = offset + chunk->complen;
+    d->file_used += chunk->complen;
+    return true;
+}
+
+// compresses the chunk being written and queues it
+static bool seal_chunk(mvd_delay_t *d)
+{
+    mvd_chunk_t *chunk;
+    const byte *data;
+    size_t len;
+
+#if USE_ZLIB
+    uLongf destLen = sizeof(delay_scratch);
+
+    if (compress2(delay_scratch, &destLen, d->write, d->write_len,
+                  Z_DEFAULT_COMPRESSION) != Z_OK) {
+        Com_EPrintf("Couldn't compress delay buffer\n");
+        return false;
+    }
+    data = delay_scratch;
+    len = destLen;
+#else
+    data = d->write;
+    len = d->write_len;
+#endif
+
+    chunk = MVD_Mallocz(sizeof(*chunk));
+    chunk->rawlen = d->write_len;
+    chunk->complen = len;
+
+    if (d->memsize + len > d->maxmem) {
+        if (!spill_chunk(d, chunk, data)) {
+            Z_Free(chunk);
+            return false;
+        }
+    } else {
+        chunk->data = MVD_Malloc(len);
+        memcpy(chunk->data, data, len);
+        d->memsize += len;
+    }
+
+    if (d->tail) {
+        d->tail->next = chunk;
+    } else {
+        d->head = chunk;
+    }
+    d->tail = chunk;
+    d->num_chunks++;
+
+    d->write_len = 0;
+    return true;
+}
+
+/*
+==============
+MVD_DelayWrite
+
+Appends a message to the delay buffer. Returns false if the
+buffer overflowed, in which case it is left unmodified.
+==============
+*/
+bool MVD_DelayWrite(mvd_delay_t *d, const void *data, size_t len)
+{
+    if (len < 1 || len > MAX_MSGLEN)
+        return false;
+
+    if (d->write_len + 2 + len > DELAY_CHUNK_SIZE && !seal_chunk(d))
+        return false;
+
+    d->write[d->write_len + 0] = len & 255;
+    d->write[d->write_len + 1] = (len >> 8) & 255;
+    memcpy(d->write + d->write_len + 2, data, len);
+    d->write_len += 2 + len;
+    d->num_packets++;
+    return true;
+}
+
+static bool load_chunk(mvd_delay_t *d, mvd_chunk_t *chunk)
+{
+    const byte *data = chunk->data;
+    mvd_chunk_t *next;
+
+    if (!data) {
+        if (fseek(d->fp, (long)chunk->offset, SEEK_SET) ||
+            fread(delay_scratch, 1, chunk->complen, d->fp) != chunk->complen) {
+            return false;
+        }
+        data = delay_scratch;
+
+        // advance tail to the next spilled chunk
+        d->file_used -= chunk->complen;
+        for (next = chunk->next; next && next->data; next = next->next)
+            ;
+        if (next) {
+            d->file_tail = next->offset;
+        } else {
+            d->file_head = d->file_tail = 0;
+        }
+    }
+
+#if USE_ZLIB
+    uLongf destLen = DELAY_CHUNK_SIZE;
+
+    if (uncompress(d->read, &destLen, data, chunk->complen) != Z_OK)
+        return false;
+    if (destLen != chunk->rawlen)
+        return false;
+#else
+    memcpy(d->read, data, chunk->rawlen);
+#endif
+
+    d->read_len = chunk->rawlen;
+    return true;
+}
+
+// makes the oldest chunk current for reading
+static bool next_chunk(mvd_delay_t *d)
+{
+    mvd_chunk_t *chunk = d->head;
+    bool ret;
+    byte *tmp;
+
+    d->read_pos = d->read_len = 0;
+
+    if (!chunk) {
+        // reader caught up with writer, take the chunk being written
+        if (!d->write_len)
+            return false;
+        tmp = d->read;
+        d->read = d->write;
+        d->write = tmp;
+        d->read_len = d->write_len;
+        d->write_len = 0;
+        return true;
+    }
+
+    ret = load_chunk(d, chunk);
+
+    d->head = chunk->next;
+    if (!d->head)
+        d->tail = NULL;
+    d->num_chunks--;
+
+    if (chunk->data) {
+        d->memsize -= chunk->complen;
+        Z_Free(chunk->data);
+    }
+    Z_Free(chunk);
+
+    return ret;
+}
+
+/*
+==============
+MVD_DelayRead
+
+Reads the next message from the delay buffer into msg_read.
+Message data is valid until the next call.
+==============
+*/
+bool MVD_DelayRead(mvd_delay_t *d)
+{
+    size_t msglen;
+    byte *data;
+
+    if (d->read_pos == d->read_len && !next_chunk(d))
+        return false;
+
+    if (d->read_len - d->read_pos < 2)
+        return false;
+
+    data = d->read + d->read_pos;
+    msglen = LittleShortMem(data);
+    if (msglen < 1 || msglen > d->read_len - d->read_pos - 2)
+        return false;
+
+    SZ_Init(&msg_read, data + 2, msglen);
+    msg_read.cursize = msglen;
+
+    d->read_pos += 2 + msglen;
+    d->num_packets--;
+    return true;
+}
+
+/*
+==============
+MVD_DelayClear
+
+Discards all buffered messages.
+==============
+*/
+void MVD_DelayClear(mvd_delay_t *d)
+{
+    mvd_chunk_t *chunk, *next;
+
+    for (chunk = d->head; chunk; chunk = next) {
+        next = chunk->next;
+        Z_Free(chunk->data);
+        Z_Free(chunk);
+    }
+
+    d->head = d->tail = NULL;
+    d->num_chunks = 0;
+    d->num_packets = 0;
+    d->write_len = 0;
+    d->read_len = d->read_pos = 0;
+    d->memsize = 0;
+    d->file_used = d->file_head = d->file_tail = 0;
+}
+
+void MVD_DelayFree(mvd_delay_t *d)
+{
+    MVD_DelayClear(d);
+    Z_Free(d->write);
+    Z_Free(d->read);
+    if (d->fp)
+        fclose(d->fp);
+    memset(d, 0, sizeof(*d));
+}
+
+/*
+==============
+MVD_DelayUsage
+
+Returns amount of data buffered, counting queued chunks by their
+compressed size.
+==============
+*/
+size_t MVD_DelayUsage(const mvd_delay_t *d)
+{
+    return d->memsize + d->file_used + d->write_len + d->read_len - d->read_pos;
+}
+
+int MVD_DelayPercent(const mvd_delay_t *d)
+{
+    size_t size = d->maxmem + d->maxfile + DELAY_CHUNK_SIZE;
+
+    return (int)(MVD_DelayUsage(d) * 100 / size);
+}
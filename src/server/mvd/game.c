@@ -36,6 +36,8 @@ static cvar_t   *mvd_chase_prefix;
 
 mvd_client_t    *mvd_clients;
 
+cvar_t          *mvd_shared_frames;
+
 mvd_player_t    mvd_dummy;
 
 static int      mvd_numplayers;
@@ -1724,6 +1726,7 @@ static void MVD_GameInit(void)
     mvd_stats_hack = Cvar_Get("mvd_stats_hack", "0", 0);
     mvd_freeze_hack = Cvar_Get("mvd_freeze_hack", "1", 0);
     mvd_chase_prefix = Cvar_Get("mvd_chase_prefix", "xv 0 yb -64", 0);
+    mvd_shared_frames = Cvar_Get("mvd_shared_frames", "1", 0);
     Cvar_Set("g_features", va("%d", MVD_FEATURES));
 
     mvd_clients = MVD_Mallocz(sizeof(mvd_client_t) * sv_maxclients->integer);
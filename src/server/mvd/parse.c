@@ -839,7 +839,6 @@ static void MVD_ParseFrame(mvd_t *mvd)
 void MVD_ClearState(mvd_t *mvd, bool full)
 {
     mvd_player_t *player;
-    mvd_snap_t *snap, *next;
     int i;
 
     // clear all entities, don't trust num_edicts as it is possible
@@ -860,11 +859,7 @@ void MVD_ClearState(mvd_t *mvd, bool full)
         return;
 
     // free all snapshots
-    LIST_FOR_EACH_SAFE(mvd_snap_t, snap, next, &mvd->snapshots, entry) {
-        Z_Free(snap);
-    }
-
-    List_Init(&mvd->snapshots);
+    Demo_FreeSnapshots(&mvd->snapshots);
 
     // free current map
     CM_FreeMap(&mvd->cm);
@@ -1023,18 +1018,20 @@ static void MVD_ParseServerData(mvd_t *mvd, int extrabits)
     mvd->mapname[len - 9] = 0; // cut off ".bsp"
 
     // load the world model (we are only interesed in visibility info)
-    Com_Printf("[%s] -=- Loading %s...\n", mvd->name, string);
-    ret = CM_LoadMap(&mvd->cm, string);
-    if (ret) {
-        Com_EPrintf("[%s] =!= Couldn't load %s: %s\n", mvd->name, string, BSP_ErrorString(ret));
-        // continue with null visibility
-    }
+    if (!mvd->headless) {
+        Com_Printf("[%s] -=- Loading %s...\n", mvd->name, string);
+        ret = CM_LoadMap(&mvd->cm, string);
+        if (ret) {
+            Com_EPrintf("[%s] =!= Couldn't load %s: %s\n", mvd->name, string, BSP_ErrorString(ret));
+            // continue with null visibility
+        }
 #if USE_MAPCHECKSUM
-    else if (mvd->cm.cache->checksum != atoi(mvd->configstrings[CS_MAPCHECKSUM])) {
-        Com_EPrintf("[%s] =!= Local map version differs from server!\n", mvd->name);
-        CM_FreeMap(&mvd->cm);
-    }
+        else if (mvd->cm.cache->checksum != atoi(mvd->configstrings[CS_MAPCHECKSUM])) {
+            Com_EPrintf("[%s] =!= Local map version differs from server!\n", mvd->name);
+            CM_FreeMap(&mvd->cm);
+        }
 #endif
+    }
 
     // set player names
     MVD_SetPlayerNames(mvd);
@@ -1058,6 +1055,12 @@ static void MVD_ParseServerData(mvd_t *mvd, int extrabits)
     // force inital snapshot
     mvd->last_snapshot = INT_MIN;
 
+    // detached channels are never linked or spawned into
+    if (mvd->headless) {
+        mvd->state = MVD_READING;
+        return;
+    }
+
     // if the channel has been just created, init some things
     if (!mvd->state) {
         mvd_t *cur;
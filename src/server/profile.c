@@ -0,0 +1,689 @@
+/*
+Copyright (C) 2003-2011 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// profile.c -- server frame profiler
+//
+// Each phase of SV_Frame and each hot game import is timed with a
+// microsecond clock. Totals are accumulated over a server frame and then
+// committed into a rolling window of the last sv_profile_frames frames,
+// from which percentiles are computed on demand. Individual events can
+// also be captured for a few frames and exported in Chrome trace format.
+//
+// With sv_profile_callers enabled, game import calls are additionally
+// accounted per call site in the game library, identified by return
+// address relative to GetGameAPI, so that third-party mods can be
+// profiled without source.
+//
+
+#include "server.h"
+
+#define MAX_PROFILE_FRAMES      36000
+#define MAX_TRACE_FRAMES        600
+#define MAX_TRACE_EVENTS        0x40000
+
+#define MAX_CALLSITES           1024
+#define CALLSITE_HASH_SIZE      (MAX_CALLSITES * 2)
+
+typedef struct {
+    intptr_t    caller;
+    uint8_t     phase;
+    unsigned    frame_calls;    // calls during current frame
+    unsigned    peak_calls;     // most calls during a single frame
+    uint64_t    calls;
+    uint64_t    time;
+    uint64_t    nodes;
+    uint64_t    brushes;
+} callsite_t;
+
+typedef struct {
+    uint8_t     phase;
+    uint32_t    start;
+    uint32_t    duration;
+} profevent_t;
+
+static const char *const phase_names[PROF_NUM] = {
+    "frame",
+    "commands",
+    "mvd_client",
+    "packets",
+    "clientthink",
+    "anticheat",
+    "mvd_server",
+    "async",
+    "timeouts",
+    "pings",
+    "givemsec",
+    "game",
+    "game_self",
+    "send",
+    "heartbeat",
+    "prepworld",
+    "trace",
+    "pointcontents",
+    "linkentity",
+    "boxedicts",
+    "multicast",
+    "pmove",
+};
+
+static struct {
+    // current frame accumulators
+    uint64_t    current[PROF_NUM];
+    uint64_t    imports;        // running total of game import time
+    unsigned    import_depth;   // nesting level of import calls in progress
+    uint64_t    game_imports;   // value of the above when game frame started
+
+    // rolling window of committed frames
+    uint32_t    *samples;       // [PROF_NUM][window]
+    unsigned    window;
+    unsigned    head;
+    unsigned    count;
+    uint64_t    calls[PROF_NUM];
+    uint64_t    frames;
+
+    // chrome trace capture
+    profevent_t *events;
+    unsigned    numevents;
+    unsigned    trace_frames;
+    uint64_t    trace_base;
+    char        trace_name[MAX_QPATH];
+
+    // per call site import statistics
+    callsite_t  *callsites;
+    uint16_t    *callsite_hash;
+    unsigned    numcallsites;
+    uint64_t    callsite_overflow;
+
+    // benchmark totals
+    bool        bench;
+    bool        bench_skip;
+    uint64_t    bench_total[PROF_NUM];
+    uint64_t    bench_calls[PROF_NUM];  // value of calls when benchmark started
+    uint32_t    bench_max[PROF_NUM];
+    unsigned    bench_frames;
+} prof;
+
+bool sv_profiling;
+
+static cvar_t   *sv_profile_frames;
+static cvar_t   *sv_profile_callers;
+
+static void update_profiling(void)
+{
+    sv_profiling = prof.samples || prof.events || prof.callsites || prof.bench;
+    cm_stats.enabled = !!prof.callsites;
+}
+
+static void add_event(profphase_t phase, uint64_t start, uint64_t end)
+{
+    profevent_t *ev;
+
+    if (prof.numevents == MAX_TRACE_EVENTS)
+        return;
+    if (start < prof.trace_base)
+        return;
+
+    ev = &prof.events[prof.numevents++];
+    ev->phase = phase;
+    ev->start = start - prof.trace_base;
+    ev->duration = end - start;
+}
+
+static uint64_t add_sample(profphase_t phase, uint64_t start)
+{
+    uint64_t end = Sys_Microseconds();
+
+    prof.current[phase] += end - start;
+    if (phase != PROF_FRAME)
+        prof.calls[phase]++;
+
+    if (prof.events)
+        add_event(phase, start, end);
+
+    return end - start;
+}
+
+void SV_ProfileAdd(profphase_t phase, uint64_t start)
+{
+    add_sample(phase, start);
+}
+
+static callsite_t *find_callsite(profphase_t phase, intptr_t caller)
+{
+    unsigned hash = ((uintptr_t)caller * 2654435761U + phase) & (CALLSITE_HASH_SIZE - 1);
+    callsite_t *site;
+
+    while (prof.callsite_hash[hash]) {
+        site = &prof.callsites[prof.callsite_hash[hash] - 1];
+        if (site->caller == caller && site->phase == phase)
+            return site;
+        hash = (hash + 1) & (CALLSITE_HASH_SIZE - 1);
+    }
+
+    if (prof.numcallsites == MAX_CALLSITES)
+        return NULL;
+
+    site = &prof.callsites[prof.numcallsites++];
+    site->caller = caller;
+    site->phase = phase;
+    prof.callsite_hash[hash] = prof.numcallsites;
+    return site;
+}
+
+/*
+==================
+SV_ProfileImportStart
+SV_ProfileImport
+
+Accounts a game import call started at `start'. `caller' is the return
+address into the game library, relative to its entry point. `cm' holds
+collision model statistics taken before the call, filled in by
+SV_ProfileImportStart when call sites are profiled.
+
+Imports called from within another import (e.g. traces made by the game
+while the server runs Pmove) are accounted to the outermost one only, so
+that no time is counted twice.
+==================
+*/
+uint64_t SV_ProfileImportStart(cmstats_t *cm)
+{
+    if (!sv_profiling)
+        return 0;
+
+    if (prof.callsites && !prof.import_depth)
+        *cm = cm_stats;
+
+    prof.import_depth++;
+    return Sys_Microseconds();
+}
+
+void SV_ProfileImport(profphase_t phase, uint64_t start, intptr_t caller, const cmstats_t *cm)
+{
+    callsite_t *site;
+    uint64_t time;
+
+    if (!start)
+        return;
+
+    if (--prof.import_depth)
+        return;
+
+    time = add_sample(phase, start);
+    prof.imports += time;
+
+    if (!prof.callsites)
+        return;
+
+    site = find_callsite(phase, caller);
+    if (!site) {
+        prof.callsite_overflow++;
+        return;
+    }
+
+    site->frame_calls++;
+    site->calls++;
+    site->time += time;
+    site->nodes += cm_stats.nodes - cm->nodes;
+    site->brushes += cm_stats.brushes - cm->brushes;
+}
+
+/*
+==================
+SV_ProfileGameStart
+SV_ProfileGameStop
+
+Times ge->RunFrame and attributes the part of it that was not spent
+inside game imports to the game library itself.
+==================
+*/
+uint64_t SV_ProfileGameStart(void)
+{
+    if (!sv_profiling)
+        return 0;
+
+    prof.game_imports = prof.imports;
+    return Sys_Microseconds();
+}
+
+void SV_ProfileGameStop(uint64_t start)
+{
+    uint64_t total;
+
+    if (!start)
+        return;
+
+    total = add_sample(PROF_GAME, start);
+    prof.current[PROF_GAME_SELF] += total - (prof.imports - prof.game_imports);
+    prof.calls[PROF_GAME_SELF]++;
+}
+
+static void write_trace(void)
+{
+    char buffer[MAX_OSPATH];
+    qhandle_t f;
+    unsigned i;
+
+    f = FS_EasyOpenFile(buffer, sizeof(buffer), FS_MODE_WRITE | FS_FLAG_TEXT,
+                        "profiles/", prof.trace_name, ".json");
+    if (!f)
+        return;
+
+    FS_FPrintf(f, "{\"traceEvents\":[\n");
+    for (i = 0; i < prof.numevents; i++) {
+        profevent_t *ev = &prof.events[i];
+
+        FS_FPrintf(f, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                   "\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":1}%s\n",
+                   phase_names[ev->phase],
+                   ev->phase >= PROF_FIRST_IMPORT ? "import" : "server",
+                   ev->start, ev->duration,
+                   i == prof.numevents - 1 ? "" : ",");
+    }
+    FS_FPrintf(f, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    if (FS_FCloseFile(f))
+        Com_EPrintf("Error writing %s\n", buffer);
+    else
+        Com_Printf("Wrote %u trace events to %s.\n", prof.numevents, buffer);
+}
+
+static void stop_trace(void)
+{
+    Z_Free(prof.events);
+    prof.events = NULL;
+    prof.numevents = 0;
+    prof.trace_frames = 0;
+    update_profiling();
+}
+
+/*
+==================
+SV_ProfileEndFrame
+
+Commits the current frame accumulators into the rolling window. Time spent
+in SV_Frame calls that didn't run a server frame is part of the next one.
+==================
+*/
+void SV_ProfileEndFrame(void)
+{
+    unsigned i;
+
+    if (!sv_profiling)
+        return;
+
+    prof.calls[PROF_FRAME]++;
+
+    if (prof.samples) {
+        for (i = 0; i < PROF_NUM; i++)
+            prof.samples[i * prof.window + prof.head] = min(prof.current[i], UINT32_MAX);
+        prof.head = (prof.head + 1) % prof.window;
+        if (prof.count < prof.window)
+            prof.count++;
+    }
+
+    if (prof.bench_skip) {
+        // frame in progress started before benchmark
+        memcpy(prof.bench_calls, prof.calls, sizeof(prof.bench_calls));
+        prof.bench_skip = false;
+    } else if (prof.bench) {
+        for (i = 0; i < PROF_NUM; i++) {
+            prof.bench_total[i] += prof.current[i];
+            prof.bench_max[i] = max(prof.bench_max[i], min(prof.current[i], UINT32_MAX));
+        }
+        prof.bench_frames++;
+    }
+
+    for (i = 0; i < prof.numcallsites; i++) {
+        callsite_t *site = &prof.callsites[i];
+
+        site->peak_calls = max(site->peak_calls, site->frame_calls);
+        site->frame_calls = 0;
+    }
+
+    memset(prof.current, 0, sizeof(prof.current));
+    prof.import_depth = 0;
+    prof.frames++;
+
+    if (prof.events && --prof.trace_frames == 0) {
+        write_trace();
+        stop_trace();
+    }
+}
+
+/*
+==================
+SV_ProfileSkipFrame
+
+Discards the current frame accumulators when no server frame was run,
+e.g. while paused, instead of piling them onto the next frame.
+==================
+*/
+void SV_ProfileSkipFrame(void)
+{
+    if (!sv_profiling)
+        return;
+
+    memset(prof.current, 0, sizeof(prof.current));
+    prof.import_depth = 0;
+}
+
+/*
+==================
+SV_ProfileBenchStart
+SV_ProfileBenchStop
+
+Accumulate per phase totals over a benchmark run, independently of the
+rolling window, starting with the next frame.
+==================
+*/
+void SV_ProfileBenchStart(void)
+{
+    memset(prof.bench_total, 0, sizeof(prof.bench_total));
+    memset(prof.bench_max, 0, sizeof(prof.bench_max));
+    prof.bench_frames = 0;
+    prof.bench_skip = true;
+    prof.bench = true;
+    update_profiling();
+}
+
+void SV_ProfileBenchStop(bool report)
+{
+    unsigned i, frames = prof.bench_frames;
+
+    prof.bench = false;
+    update_profiling();
+
+    if (!report || !frames)
+        return;
+
+    Com_Printf("phase           avg     max  calls/frame\n"
+               "------------- ------- ------- -----------\n");
+    for (i = 0; i < PROF_NUM; i++) {
+        if (!prof.bench_total[i])
+            continue;
+        Com_Printf("%-13s %7"PRIu64" %7u %11.1f\n", phase_names[i],
+                   prof.bench_total[i] / frames, prof.bench_max[i],
+                   (double)(prof.calls[i] - prof.bench_calls[i]) / frames);
+    }
+}
+
+static void reset_stats(void)
+{
+    memset(prof.current, 0, sizeof(prof.current));
+    memset(prof.calls, 0, sizeof(prof.calls));
+    memset(prof.bench_calls, 0, sizeof(prof.bench_calls));
+    prof.head = prof.count = 0;
+    prof.frames = 0;
+
+    if (prof.callsites) {
+        memset(prof.callsites, 0, sizeof(prof.callsites[0]) * MAX_CALLSITES);
+        memset(prof.callsite_hash, 0, sizeof(prof.callsite_hash[0]) * CALLSITE_HASH_SIZE);
+    }
+    prof.numcallsites = 0;
+    prof.callsite_overflow = 0;
+}
+
+static void sv_profile_frames_changed(cvar_t *self)
+{
+    unsigned window = Cvar_ClampInteger(self, 0, MAX_PROFILE_FRAMES);
+
+    if (window == prof.window)
+        return;
+
+    Z_Free(prof.samples);
+    prof.samples = NULL;
+    if (window)
+        prof.samples = Z_Malloc(sizeof(prof.samples[0]) * PROF_NUM * window);
+    prof.window = window;
+
+    reset_stats();
+    update_profiling();
+}
+
+static void sv_profile_callers_changed(cvar_t *self)
+{
+    if (self->integer && !prof.callsites) {
+        prof.callsites = Z_Malloc(sizeof(prof.callsites[0]) * MAX_CALLSITES);
+        prof.callsite_hash = Z_Malloc(sizeof(prof.callsite_hash[0]) * CALLSITE_HASH_SIZE);
+    } else if (!self->integer && prof.callsites) {
+        Z_Free(prof.callsites);
+        Z_Free(prof.callsite_hash);
+        prof.callsites = NULL;
+        prof.callsite_hash = NULL;
+    } else {
+        return;
+    }
+
+    reset_stats();
+    update_profiling();
+}
+
+static int sample_cmp(const void *p1, const void *p2)
+{
+    uint32_t a = *(const uint32_t *)p1;
+    uint32_t b = *(const uint32_t *)p2;
+
+    return a < b ? -1 : a > b;
+}
+
+static void dump_stats(void)
+{
+    uint32_t *sorted;
+    uint64_t total;
+    unsigned i, j, count = prof.count;
+
+    if (!prof.samples) {
+        Com_Printf("Profiling is disabled. Set sv_profile_frames to enable.\n");
+        return;
+    }
+
+    if (!count) {
+        Com_Printf("No frames profiled yet.\n");
+        return;
+    }
+
+    Com_Printf("Last %u frames, times in microseconds:\n"
+               "phase           avg     p50     p90     p99     max  calls/frame\n"
+               "------------- ------- ------- ------- ------- ------- -----------\n",
+               count);
+
+    sorted = Z_Malloc(sizeof(sorted[0]) * count);
+    for (i = 0; i < PROF_NUM; i++) {
+        memcpy(sorted, prof.samples + i * prof.window, sizeof(sorted[0]) * count);
+        qsort(sorted, count, sizeof(sorted[0]), sample_cmp);
+
+        for (j = 0, total = 0; j < count; j++)
+            total += sorted[j];
+        if (!total)
+            continue;
+
+        Com_Printf("%-13s %7"PRIu64" %7u %7u %7u %7u %11.1f\n", phase_names[i],
+                   total / count, sorted[count * 50 / 100], sorted[count * 90 / 100],
+                   sorted[count * 99 / 100], sorted[count - 1],
+                   prof.frames ? (double)prof.calls[i] / prof.frames : 0.0);
+    }
+    Z_Free(sorted);
+}
+
+static int callsite_key;
+
+static uint64_t callsite_value(const callsite_t *site)
+{
+    switch (callsite_key) {
+    case 1:
+        return site->calls;
+    case 2:
+        return site->nodes;
+    default:
+        return site->time;
+    }
+}
+
+static int callsite_cmp(const void *p1, const void *p2)
+{
+    uint64_t a = callsite_value(*(const callsite_t **)p1);
+    uint64_t b = callsite_value(*(const callsite_t **)p2);
+
+    return a > b ? -1 : a < b;
+}
+
+static void dump_callers(void)
+{
+    static const char *const keys[] = { "time", "calls", "nodes" };
+    callsite_t **sorted;
+    char *s = Cmd_Argv(2);
+    unsigned i, count = 20;
+    uint64_t frames = max(prof.frames, 1);
+
+    if (!prof.callsites) {
+        Com_Printf("Call site profiling is disabled. Set sv_profile_callers to enable.\n");
+        return;
+    }
+
+    if (!prof.numcallsites) {
+        Com_Printf("No game import calls recorded yet.\n");
+        return;
+    }
+
+    callsite_key = 0;
+    for (i = 0; i < q_countof(keys); i++) {
+        if (!strcmp(s, keys[i])) {
+            callsite_key = i;
+            s = Cmd_Argv(3);
+            break;
+        }
+    }
+    if (*s)
+        count = max(atoi(s), 1);
+
+    sorted = Z_Malloc(sizeof(sorted[0]) * prof.numcallsites);
+    for (i = 0; i < prof.numcallsites; i++)
+        sorted[i] = &prof.callsites[i];
+    qsort(sorted, prof.numcallsites, sizeof(sorted[0]), callsite_cmp);
+
+    Com_Printf("Top game import call sites by %s over %"PRIu64" frames:\n"
+               "caller               import        calls/frame  peak  usec/frame nodes/call brushes/call\n"
+               "-------------------- ------------- ----------- ----- ---------- ---------- ------------\n",
+               keys[callsite_key], prof.frames);
+
+    count = min(count, prof.numcallsites);
+    for (i = 0; i < count; i++) {
+        callsite_t *site = sorted[i];
+        intptr_t ofs = site->caller;
+
+        Com_Printf("GetGameAPI%c%#-9"PRIxPTR" %-13s %11.1f %5u %10.1f %10.1f %12.1f\n",
+                   ofs < 0 ? '-' : '+', (uintptr_t)(ofs < 0 ? -ofs : ofs),
+                   phase_names[site->phase],
+                   (double)site->calls / frames, site->peak_calls,
+                   (double)site->time / frames,
+                   (double)site->nodes / site->calls,
+                   (double)site->brushes / site->calls);
+    }
+    Z_Free(sorted);
+
+    if (prof.callsite_overflow)
+        Com_Printf("%"PRIu64" calls from untracked call sites.\n", prof.callsite_overflow);
+}
+
+static void start_trace(void)
+{
+    int frames = 20;
+
+    if (Cmd_Argc() < 3) {
+        Com_Printf("Usage: %s trace <filename> [frames]\n", Cmd_Argv(0));
+        return;
+    }
+
+    if (prof.events) {
+        Com_Printf("Already capturing a trace.\n");
+        return;
+    }
+
+    if (Cmd_Argc() > 3) {
+        frames = atoi(Cmd_Argv(3));
+        clamp(frames, 1, MAX_TRACE_FRAMES);
+    }
+
+    Q_strlcpy(prof.trace_name, Cmd_Argv(2), sizeof(prof.trace_name));
+    prof.events = Z_Malloc(sizeof(prof.events[0]) * MAX_TRACE_EVENTS);
+    prof.numevents = 0;
+    prof.trace_frames = frames;
+    prof.trace_base = Sys_Microseconds();
+    update_profiling();
+
+    Com_Printf("Capturing trace of the next %d frames.\n", frames);
+}
+
+static void SV_Profile_f(void)
+{
+    char *s = Cmd_Argv(1);
+
+    if (!strcmp(s, "reset")) {
+        reset_stats();
+        Com_Printf("Profiler statistics reset.\n");
+        return;
+    }
+
+    if (!strcmp(s, "trace")) {
+        start_trace();
+        return;
+    }
+
+    if (!strcmp(s, "callers")) {
+        dump_callers();
+        return;
+    }
+
+    if (!strcmp(s, "stop")) {
+        if (!prof.events) {
+            Com_Printf("Not capturing a trace.\n");
+            return;
+        }
+        write_trace();
+        stop_trace();
+        return;
+    }
+
+    if (*s) {
+        Com_Printf("Usage: %s [reset|callers [time|calls|nodes] [count]|"
+                   "trace <filename> [frames]|stop]\n", Cmd_Argv(0));
+        return;
+    }
+
+    dump_stats();
+}
+
+static const cmdreg_t c_profile[] = {
+    { "sv_profile", SV_Profile_f },
+
+    { NULL }
+};
+
+void SV_RegisterProfile(void)
+{
+    Cmd_Register(c_profile);
+
+    sv_profile_frames = Cvar_Get("sv_profile_frames", "0", 0);
+    sv_profile_frames->changed = sv_profile_frames_changed;
+    sv_profile_frames_changed(sv_profile_frames);
+
+    sv_profile_callers = Cvar_Get("sv_profile_callers", "0", 0);
+    sv_profile_callers->changed = sv_profile_callers_changed;
+    sv_profile_callers_changed(sv_profile_callers);
+}
@@ -25,6 +25,30 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #define SAVE_CURRENT    ".current"
 #define SAVE_AUTO       "save0"
 
+typedef struct {
+    char        dir[MAX_QPATH];
+    char        src[MAX_OSPATH];    // full path to SAVE_CURRENT directory
+    char        path[MAX_OSPATH];   // full path to destination directory
+    void        **files;            // files found in SAVE_CURRENT
+    int         numfiles;
+    void        **stale;            // files found in destination before save
+    int         numstale;
+    int         status;
+    char        *failed;            // name of the file that caused error
+    bool        autosave;
+    bool        async;
+} savejob_t;
+
+static cvar_t   *sv_savegame_async;
+static int      save_pending;
+
+// SAVE_CURRENT is read by pending jobs, finish them before changing it
+static void finish_save_jobs(void)
+{
+    if (save_pending)
+        Sys_WaitAsyncWork(&save_pending);
+}
+
 static int write_server_file(bool autosave)
 {
     char        name[MAX_OSPATH];
@@ -32,6 +56,8 @@ static int write_server_file(bool autosave)
     int         ret;
     uint64_t    timestamp;
 
+    finish_save_jobs();
+
     // write magic
     MSG_WriteLong(SAVE_MAGIC1);
     MSG_WriteLong(SAVE_VERSION);
@@ -84,6 +110,8 @@ static int write_level_file(void)
     size_t      len;
     byte        portalbits[MAX_MAP_PORTAL_BYTES];
 
+    finish_save_jobs();
+
     // write magic
     MSG_WriteLong(SAVE_MAGIC2);
     MSG_WriteLong(SAVE_VERSION);
@@ -217,6 +245,167 @@ static int copy_save_dir(const char *src, const char *dst)
     return ret;
 }
 
+/*
+==============================================================================
+
+ASYNCHRONOUS SAVEGAME WRITING
+
+Game DLL writes SAVE_CURRENT synchronously, since it serializes live game
+state. Files are then copied off to destination directory by async worker
+thread. Each file is written under temporary name, synced to disk and
+renamed into place, so that destination directory never contains partially
+written savegame. SAVE_CURRENT is not modified until pending jobs are
+finished. Worker thread must not touch zone memory or filesystem module.
+
+==============================================================================
+*/
+
+static int write_save_file(savejob_t *job, const char *name)
+{
+    char    path[MAX_OSPATH], temp[MAX_OSPATH];
+    byte    buf[0x10000];
+    FILE    *ifp, *ofp;
+    size_t  len;
+    int     ret = 0;
+
+    if (Q_snprintf(path, MAX_OSPATH, "%s%s", job->src, name) >= MAX_OSPATH)
+        return Q_ERR(ENAMETOOLONG);
+
+    ifp = fopen(path, "rb");
+    if (!ifp)
+        return Q_ERRNO;
+
+    if (Q_snprintf(path, MAX_OSPATH, "%s%s", job->path, name) >= MAX_OSPATH ||
+        Q_snprintf(temp, MAX_OSPATH, "%s.tmp", path) >= MAX_OSPATH) {
+        fclose(ifp);
+        return Q_ERR(ENAMETOOLONG);
+    }
+
+    ofp = fopen(temp, "wb");
+    if (!ofp) {
+        ret = Q_ERRNO;
+        fclose(ifp);
+        return ret;
+    }
+
+    do {
+        len = fread(buf, 1, sizeof(buf), ifp);
+        if (fwrite(buf, 1, len, ofp) != len) {
+            ret = Q_ERRNO;
+            break;
+        }
+    } while (len == sizeof(buf));
+
+    if (!ret && ferror(ifp))
+        ret = Q_ERR_FAILURE;
+    else if (!ret && (fflush(ofp) || os_fsync(os_fileno(ofp))))
+        ret = Q_ERRNO;
+
+    fclose(ifp);
+    if (fclose(ofp) && !ret)
+        ret = Q_ERRNO;
+
+    if (!ret)
+        ret = Sys_ReplaceFile(temp, path);
+
+    if (ret)
+        remove(temp);
+
+    return ret;
+}
+
+static bool is_save_file(const savejob_t *job, const char *name)
+{
+    int i;
+
+    for (i = 0; i < job->numfiles; i++)
+        if (!Q_stricmp(job->files[i], name))
+            return true;
+
+    return false;
+}
+
+static void save_work_cb(void *arg)
+{
+    savejob_t *job = arg;
+    char path[MAX_OSPATH];
+    int i;
+
+    for (i = 0; i < job->numfiles; i++) {
+        job->status = write_save_file(job, job->files[i]);
+        if (job->status) {
+            job->failed = job->files[i];
+            return;
+        }
+    }
+
+    // remove leftovers of previous savegame only after new one is complete
+    for (i = 0; i < job->numstale; i++) {
+        if (is_save_file(job, job->stale[i]))
+            continue;
+        if (Q_snprintf(path, MAX_OSPATH, "%s%s", job->path, (char *)job->stale[i]) < MAX_OSPATH)
+            remove(path);
+    }
+}
+
+static void save_done_cb(void *arg)
+{
+    savejob_t *job = arg;
+
+    if (job->status)
+        Com_EPrintf("Couldn't write '%s' directory: %s: %s\n",
+                    job->dir, job->failed, Q_ErrorString(job->status));
+    else if (!job->autosave)
+        Com_Printf("Game saved.\n");
+
+    FS_FreeList(job->files);
+    FS_FreeList(job->stale);
+
+    if (job->async) {
+        save_pending--;
+        Z_Free(job);
+    }
+}
+
+static int queue_save_dir(const char *src, const char *dst, bool autosave)
+{
+    savejob_t job;
+
+    memset(&job, 0, sizeof(job));
+    Q_strlcpy(job.dir, dst, sizeof(job.dir));
+    job.autosave = autosave;
+    job.async = sv_savegame_async->integer;
+
+    if (Q_snprintf(job.src, MAX_OSPATH, "%s/save/%s/", fs_gamedir, src) >= MAX_OSPATH)
+        return -1;
+
+    if (Q_snprintf(job.path, MAX_OSPATH, "%s/save/%s/", fs_gamedir, dst) >= MAX_OSPATH)
+        return -1;
+
+    if (FS_CreatePath(job.path))
+        return -1;
+
+    if ((job.files = list_save_dir(src, &job.numfiles)) == NULL)
+        return -1;
+
+    job.stale = list_save_dir(dst, &job.numstale);
+
+    if (job.async) {
+        asyncwork_t work = {
+            .work_cb = save_work_cb,
+            .done_cb = save_done_cb,
+            .cb_arg = Z_CopyStruct(&job),
+        };
+        Sys_QueueAsyncWork(&work);
+        save_pending++;
+    } else {
+        save_work_cb(&job);
+        save_done_cb(&job);
+    }
+
+    return 0;
+}
+
 static int read_binary_file(const char *name)
 {
     qhandle_t f;
@@ -452,6 +641,7 @@ void SV_AutoSaveBegin(mapcmd_t *cmd)
 
     // check for clearing the current savegame
     if (cmd->endofunit) {
+        finish_save_jobs();
         wipe_save_dir(SAVE_CURRENT);
         return;
     }
@@ -500,14 +690,8 @@ void SV_AutoSaveEnd(void)
         return;
     }
 
-    // clear whatever savegames are there
-    if (wipe_save_dir(SAVE_AUTO)) {
-        Com_EPrintf("Couldn't wipe '%s' directory.\n", SAVE_AUTO);
-        return;
-    }
-
     // copy off the level to the autosave slot
-    if (copy_save_dir(SAVE_CURRENT, SAVE_AUTO)) {
+    if (queue_save_dir(SAVE_CURRENT, SAVE_AUTO, true)) {
         Com_EPrintf("Couldn't write '%s' directory.\n", SAVE_AUTO);
         return;
     }
@@ -589,6 +773,11 @@ static void SV_Loadgame_f(void)
         return;
     }
 
+    if (save_pending) {
+        Com_Printf("Savegame is still being written.\n");
+        return;
+    }
+
     // make sure the server files exist
     if (!FS_FileExistsEx(va("save/%s/server.ssv", dir), FS_TYPE_REAL | FS_PATH_GAME) ||
         !FS_FileExistsEx(va("save/%s/game.ssv", dir), FS_TYPE_REAL | FS_PATH_GAME)) {
@@ -670,19 +859,11 @@ static void SV_Savegame_f(void)
         return;
     }
 
-    // clear whatever savegames are there
-    if (wipe_save_dir(dir)) {
-        Com_Printf("Couldn't wipe '%s' directory.\n", dir);
-        return;
-    }
-
-    // copy it off
-    if (copy_save_dir(SAVE_CURRENT, dir)) {
+    // copy it off, completion is reported by save_done_cb
+    if (queue_save_dir(SAVE_CURRENT, dir, false)) {
         Com_Printf("Couldn't write '%s' directory.\n", dir);
         return;
     }
-
-    Com_Printf("Game saved.\n");
 }
 
 static const cmdreg_t c_savegames[] = {
@@ -694,4 +875,6 @@ static const cmdreg_t c_savegames[] = {
 void SV_RegisterSavegames(void)
 {
     Cmd_Register(c_savegames);
+
+    sv_savegame_async = Cvar_Get("sv_savegame_async", "1", 0);
 }
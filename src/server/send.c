@@ -46,6 +46,15 @@ void SV_FlushRedirect(int redirected, char *outputbuf, size_t len)
     }
 }
 
+// returns bandwidth budget for the client, 0 if not limited
+static unsigned client_rate(client_t *client)
+{
+    if (client->rate && sv_rate_control->integer && client->cc.rate)
+        return client->cc.rate;
+
+    return client->rate;
+}
+
 /*
 =======================
 SV_RateDrop
@@ -57,10 +66,11 @@ bandwidth estimation and should not be sent another packet
 static bool SV_RateDrop(client_t *client)
 {
     size_t  total;
+    unsigned rate = client_rate(client);
     int     i;
 
     // never drop over the loopback
-    if (!client->rate) {
+    if (!rate) {
         return false;
     }
 
@@ -73,7 +83,7 @@ static bool SV_RateDrop(client_t *client)
     total = total * sv.framediv / client->framediv;
 #endif
 
-    if (total > client->rate) {
+    if (total > rate) {
         SV_DPrintf(0, "Frame %d suppressed for %s (total = %zu)\n",
                    client->framenum, client->name, total);
         client->frameflags |= FF_SUPPRESSED;
@@ -87,18 +97,168 @@ static bool SV_RateDrop(client_t *client)
 
 static void SV_CalcSendTime(client_t *client, size_t size)
 {
+    unsigned rate = client_rate(client);
+
+    client->bytes_sent += size;
+
     // never drop over the loopback
-    if (!client->rate) {
+    if (!rate) {
         client->send_time = svs.realtime;
         client->send_delta = 0;
         return;
     }
 
-    if (client->state == cs_spawned)
+    if (client->state == cs_spawned) {
         client->message_size[client->framenum % RATE_MESSAGES] = size;
+        client->cc.frame_size = (client->cc.frame_size * 7 + size) / 8;
+    }
 
     client->send_time = svs.realtime;
-    client->send_delta = size * 1000 / client->rate;
+    client->send_delta = size * 1000 / rate;
+}
+
+/*
+=============================================================================
+
+ADAPTIVE RATE CONTROL
+
+When sv_rate_control is enabled, the budget enforced by SV_RateDrop is not
+the fixed userinfo rate, but an estimate adjusted twice a second from frame
+acknowledgements. Growing frame latency above the observed minimum (queueing
+delay) or a drop in acked/sent ratio cut the rate multiplicatively, otherwise
+it grows additively while the client is actually limited by it. For Q2PRO
+clients, packet rate is lowered by raising framediv when the estimate can't
+carry average frame size at the current rate, and restored once it can.
+
+=============================================================================
+*/
+
+#define CC_INTERVAL     500     // msec between updates
+#define CC_MIN_QUEUE    30      // msec of queueing delay always tolerated
+
+// packets per second sent to the client
+#if USE_FPS
+#define CC_FRAMERATE(cl)    (sv.framerate / (cl)->framediv)
+#else
+#define CC_FRAMERATE(cl)    BASE_FRAMERATE
+#endif
+
+#if USE_FPS
+static void adapt_framediv(client_t *client, unsigned rate)
+{
+    unsigned size = client->cc.frame_size;
+    int div = client->framediv, up, down;
+
+    if (client->protocol != PROTOCOL_VERSION_Q2PRO || sv.framediv == 1 || !size)
+        return;
+
+    // framediv must be a divisor of sv.framediv to keep key frames aligned
+    for (up = div + 1; up <= sv.framediv && sv.framediv % up; up++)
+        ;
+    for (down = div - 1; down >= client->cc.framediv && sv.framediv % down; down--)
+        ;
+
+    if (up <= sv.framediv && size * sv.framerate / div > rate * 9 / 10) {
+        SV_DPrintf(0, "%s: framediv %d -> %d (rate %u)\n", client->name, div, up, rate);
+        SV_SetClientFrameDiv(client, up);
+    } else if (down >= client->cc.framediv && size * sv.framerate / down < rate * 6 / 10) {
+        SV_DPrintf(0, "%s: framediv %d -> %d (rate %u)\n", client->name, div, down, rate);
+        SV_SetClientFrameDiv(client, down);
+    }
+}
+#endif
+
+/*
+=======================
+SV_UpdateRateControl
+
+Called each frame for spawned clients after pings have been calculated.
+=======================
+*/
+void SV_UpdateRateControl(client_t *client)
+{
+    client_frame_t *frame;
+    unsigned sent, acked, rate, step;
+    int i, j, latency, count, ratio, queue;
+    bool limited;
+
+    if (!sv_rate_control->integer || !client->rate) {
+        // go back to rate and packet rate set by userinfo
+        client->cc.rate = 0;
+#if USE_FPS
+        if (client->framediv > client->cc.framediv)
+            SV_SetClientFrameDiv(client, client->cc.framediv);
+#endif
+        return;
+    }
+
+    if (!client->cc.rate) {
+        client->cc.rate = client->rate;
+        client->cc.time = svs.realtime;
+        client->cc.frames_sent = client->frames_sent;
+        client->cc.frames_acked = client->frames_acked;
+        client->cc.suppress_count = client->suppress_count;
+        client->cc.srtt = client->cc.base_rtt = 0;
+        client->cc.ack_ratio = 100;
+        client->cc.loss = 0;
+        return;
+    }
+
+    if (svs.realtime - client->cc.time < CC_INTERVAL)
+        return;
+
+    // average latency of recently acked frames
+    latency = count = 0;
+    for (i = 0; i < UPDATE_BACKUP; i++) {
+        j = client->framenum - i - 1;
+        frame = &client->frames[j & UPDATE_MASK];
+        if (frame->number != j || frame->latency == -1)
+            continue;
+        latency += frame->latency;
+        count++;
+    }
+    if (!count)
+        return;     // nothing acked yet, wait
+    latency /= count;
+
+    if (!client->cc.srtt) {
+        client->cc.srtt = client->cc.base_rtt = latency;
+    } else {
+        client->cc.srtt = (client->cc.srtt * 7 + latency) / 8;
+        // let minimum slowly drift up to follow route changes
+        client->cc.base_rtt = min(client->cc.base_rtt + 1, latency);
+    }
+
+    // acked/sent ratio is below 100 even without loss if client sends
+    // fewer packets than it receives frames, so compare against average
+    sent = client->frames_sent - client->cc.frames_sent;
+    acked = client->frames_acked - client->cc.frames_acked;
+    ratio = sent ? min(acked, sent) * 100 / sent : 100;
+    client->cc.loss = max(client->cc.ack_ratio - ratio, 0);
+    client->cc.ack_ratio = (client->cc.ack_ratio * 7 + ratio) / 8;
+
+    limited = client->suppress_count != client->cc.suppress_count ||
+        client->cc.frame_size * CC_FRAMERATE(client) > client->cc.rate * 3 / 4;
+
+    client->cc.time = svs.realtime;
+    client->cc.frames_sent = client->frames_sent;
+    client->cc.frames_acked = client->frames_acked;
+    client->cc.suppress_count = client->suppress_count;
+
+    rate = client->cc.rate;
+    queue = client->cc.srtt - client->cc.base_rtt;
+    if (client->cc.loss >= 10 || queue > max(CC_MIN_QUEUE, client->cc.base_rtt / 2)) {
+        rate = rate * 7 / 8;
+    } else if (limited) {
+        step = max(rate / 16, 500);
+        rate += step;
+    }
+    clamp(rate, sv_min_rate->integer, sv_max_rate->integer);
+    client->cc.rate = rate;
+
+#if USE_FPS
+    adapt_framediv(client, rate);
+#endif
 }
 
 /*
@@ -329,11 +489,67 @@ static size_t max_compressed_len(client_t *client)
     return client->netchan->maxpacketlen - ZPACKET_HEADER;
 }
 
-static bool can_compress_message(client_t *client)
+#define ZSTREAM_MIN_SIZE    64
+
+/*
+=======================
+SV_ResetClientStream
+
+Sets up persistent deflate stream for clients that support svc_zstream.
+Called when serverdata is sent, client resets its inflate stream then.
+=======================
+*/
+void SV_ResetClientStream(client_t *client)
+{
+    z_streamp z = client->zstream;
+
+    if (!z) {
+        if (!client->has_zlib || !sv_zlib_stream->integer)
+            return;
+        if (client->protocol != PROTOCOL_VERSION_Q2PRO)
+            return;
+        if (client->version < PROTOCOL_VERSION_Q2PRO_ZLIB_STREAM)
+            return;
+
+        z = SV_Mallocz(sizeof(*z));
+        z->zalloc = SV_zalloc;
+        z->zfree = SV_zfree;
+        if (deflateInit2(z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            Com_EPrintf("%s: deflateInit2() failed\n", __func__);
+            Z_Free(z);
+            return;
+        }
+        client->zstream = z;
+        return;
+    }
+
+    deflateReset(z);
+}
+
+void SV_FreeClientStream(client_t *client)
+{
+    if (client->zstream) {
+        deflateEnd(client->zstream);
+        Z_Free(client->zstream);
+        client->zstream = NULL;
+    }
+}
+
+// reliable layouts are streamed, preserving dictionary between them
+static bool can_stream_message(client_t *client, int flags)
+{
+    return client->zstream && (flags & MSG_RELIABLE) && (flags & MSG_COMPRESS_AUTO);
+}
+
+static bool can_compress_message(client_t *client, int flags)
 {
     if (!client->has_zlib)
         return false;
 
+    if (can_stream_message(client, flags))
+        return msg_write.cursize >= ZSTREAM_MIN_SIZE;
+
     // older clients have problems seamlessly writing svc_zpackets
     if (client->settings[CLS_RECORDING]) {
         if (client->protocol != PROTOCOL_VERSION_Q2PRO)
@@ -349,14 +565,74 @@ static bool can_compress_message(client_t *client)
     return true;
 }
 
+static void write_zpacket_header(byte *buffer, int cmd, int len)
+{
+    buffer[0] = cmd;
+    buffer[1] = len & 255;
+    buffer[2] = (len >> 8) & 255;
+    buffer[3] = msg_write.cursize & 255;
+    buffer[4] = (msg_write.cursize >> 8) & 255;
+}
+
+static bool stream_message(client_t *client)
+{
+    byte        buffer[MAX_MSGLEN];
+    z_streamp   z = client->zstream;
+    size_t      maxlen = max_compressed_len(client);
+    uint64_t    start = Sys_Microseconds();
+    uLong       total_out = z->total_out;
+    int         ret, len;
+
+    // stream can't be rewound, make sure output always fits
+    if (deflateBound(z, msg_write.cursize) + 16 > maxlen)
+        return false;
+
+    z->next_in = msg_write.data;
+    z->avail_in = msg_write.cursize;
+    z->next_out = buffer + ZPACKET_HEADER;
+    z->avail_out = maxlen;
+
+    ret = deflate(z, Z_SYNC_FLUSH);
+    len = z->total_out - total_out;
+
+    if (ret != Z_OK || z->avail_in || !z->avail_out) {
+        // nothing was sent yet, so client is still in sync if
+        // streaming is abandoned for good
+        Com_WPrintf("Error %d streaming %zu bytes message for %s\n",
+                    ret, msg_write.cursize, client->name);
+        SV_FreeClientStream(client);
+        return false;
+    }
+
+    write_zpacket_header(buffer, svc_zstream, len);
+    len += ZPACKET_HEADER;
+
+    client->zmessages++;
+    client->zbytes_in += msg_write.cursize;
+    client->zbytes_out += len;
+    client->zusec += Sys_Microseconds() - start;
+
+    SV_DPrintf(0, "%s: stream: %zu into %d\n",
+               client->name, msg_write.cursize, len);
+
+    client->AddMessage(client, buffer, len, true);
+    return true;
+}
+
 static bool compress_message(client_t *client, int flags)
 {
     byte    buffer[MAX_MSGLEN];
     int     ret, len;
+    uint64_t start;
 
     if (!client->has_zlib)
         return false;
 
+    if (can_stream_message(client, flags) && stream_message(client))
+        return true;
+
+    start = Sys_Microseconds();
+
     svs.z.next_in = msg_write.data;
     svs.z.avail_in = msg_write.cursize;
     svs.z.next_out = buffer + ZPACKET_HEADER;
@@ -374,26 +650,27 @@ static bool compress_message(client_t *client, int flags)
         return false;
     }
 
-    buffer[0] = svc_zpacket;
-    buffer[1] = len & 255;
-    buffer[2] = (len >> 8) & 255;
-    buffer[3] = msg_write.cursize & 255;
-    buffer[4] = (msg_write.cursize >> 8) & 255;
-
+    write_zpacket_header(buffer, svc_zpacket, len);
     len += ZPACKET_HEADER;
 
     SV_DPrintf(0, "%s: comp: %zu into %d\n",
                client->name, msg_write.cursize, len);
 
+    client->zusec += Sys_Microseconds() - start;
+
     // did it compress good enough?
     if (len >= msg_write.cursize)
         return false;
 
+    client->zmessages++;
+    client->zbytes_in += msg_write.cursize;
+    client->zbytes_out += len;
+
     client->AddMessage(client, buffer, len, flags & MSG_RELIABLE);
     return true;
 }
 #else
-#define can_compress_message(client)    false
+#define can_compress_message(client, flags)    false
 #define compress_message(client, flags) false
 #endif
 
@@ -415,7 +692,7 @@ void SV_ClientAddMessage(client_t *client, int flags)
         return;
     }
 
-    if ((flags & MSG_COMPRESS_AUTO) && can_compress_message(client)) {
+    if ((flags & MSG_COMPRESS_AUTO) && can_compress_message(client, flags)) {
         flags |= MSG_COMPRESS;
     }
 
@@ -879,6 +1156,41 @@ static void check_key_sync(client_t *client)
 }
 #endif
 
+static void cull_client_cb(void *arg, int index)
+{
+    client_t **clients = arg;
+
+    SV_CullClientFrame(clients[index]);
+}
+
+// spectators seeing the same view share a single frame, and culling
+// entities is the most expensive part of building the rest, so do
+// it upfront on worker threads (it only reads world state)
+static void prepare_client_frames(void)
+{
+    client_t    *clients[MAX_CLIENTS];
+    client_t    *client;
+    int         count;
+
+    count = 0;
+    FOR_EACH_CLIENT(client) {
+        if (!CLIENT_ACTIVE(client))
+            continue;
+        if (!SV_CLIENTSYNC(client))
+            continue;
+        if (client->netchan->message.overflowed)
+            continue;
+        if (client->netchan->fragment_pending)
+            continue;
+        clients[count++] = client;
+    }
+
+    count = SV_GroupClientFrames(clients, count);
+
+    if (sv_threads->integer > 1)
+        Sys_ParallelFor(sv_threads->integer, count, cull_client_cb, clients);
+}
+
 /*
 =======================
 SV_SendClientMessages
@@ -892,6 +1204,8 @@ void SV_SendClientMessages(void)
     client_t    *client;
     size_t      cursize;
 
+    prepare_client_frames();
+
     // send a message to each connected client
     FOR_EACH_CLIENT(client) {
         if (!CLIENT_ACTIVE(client))
@@ -932,6 +1246,7 @@ void SV_SendClientMessages(void)
 advance:
         // advance for next frame
         client->framenum++;
+        client->frame_culled = false;
 
 finish:
         // clear all unreliable messages still left
@@ -106,6 +106,7 @@ typedef struct {
     byte        areabits[MAX_MAP_AREA_BYTES];  // portalarea visibility bits
     unsigned    sentTime;                   // for ping calculations
     int         latency;
+    unsigned    shareid;                    // nonzero if shared by several clients
 } client_frame_t;
 
 typedef struct {
@@ -317,18 +318,42 @@ typedef struct client_s {
     // frame encoding
     client_frame_t  frames[UPDATE_BACKUP];    // updates can be delta'd from here
     unsigned        frames_sent, frames_acked, frames_nodelta;
+    uint64_t        bytes_sent;     // total size of transmitted packets
     int             framenum;
 #if USE_FPS
     int             framediv;
 #endif
     unsigned        frameflags;
 
+    // entities found visible by SV_CullClientFrame for the frame being built
+    bool            frame_culled;
+    int             num_visible;
+    uint16_t        visible[MAX_PACKET_ENTITIES];
+#if USE_MVD_CLIENT
+    struct framegroup_s *framegroup;    // spectators sharing the same view
+#endif
+
     // rate dropping
     unsigned        message_size[RATE_MESSAGES];    // used to rate drop normal packets
     int             suppress_count;                 // number of messages rate suppressed
     unsigned        send_time, send_delta;          // used to rate drop async packets
 
+    // adaptive rate control
+    struct {
+        unsigned    rate;           // current estimate, 0 if not started
+        unsigned    time;           // svs.realtime of last update
+        unsigned    frames_sent, frames_acked, suppress_count;
+        unsigned    frame_size;     // smoothed size of frame messages
+        int         srtt, base_rtt; // smoothed and minimum frame latency
+        int         ack_ratio;      // smoothed acked/sent ratio, percent
+        int         loss;           // estimated loss in last interval, percent
+#if USE_FPS
+        int         framediv;       // framediv requested by client
+#endif
+    } cc;
+
     // current download
+    struct dlcache_s *downloadcache; // shared copy of the file
     byte            *download;      // file being downloaded
     int             downloadsize;   // total bytes (can't use EOF because of paks)
     int             downloadcount;  // bytes sent
@@ -336,6 +361,15 @@ typedef struct client_s {
     int             downloadcmd;    // svc_(z)download
     bool            downloadpending;
 
+#if USE_ZLIB
+    // message compression
+    z_streamp       zstream;        // persistent stream for svc_zstream
+    unsigned        zmessages;      // messages compressed
+    uint64_t        zbytes_in;      // bytes before compression
+    uint64_t        zbytes_out;     // bytes after compression
+    uint64_t        zusec;          // time spent compressing
+#endif
+
     // protocol stuff
     int             challenge;  // challenge of this user, randomly generated
     int             protocol;   // major version
@@ -397,26 +431,25 @@ typedef struct client_s {
 
 //=============================================================================
 
-// MAX_CHALLENGES is made large to prevent a denial
-// of service attack that could cycle all of them
-// out before legitimate users connected
-#define    MAX_CHALLENGES    1024
-
-typedef struct {
-    netadr_t    adr;
-    unsigned    challenge;
-    unsigned    time;
-} challenge_t;
-
 typedef struct {
     list_t      entry;
     netadr_t    addr;
     netadr_t    mask;
+    int         bits;   // prefix length of mask
     unsigned    hits;
     time_t      time;   // time of the last hit
     char        comment[1];
 } addrmatch_t;
 
+typedef struct addrnode_s addrnode_t;
+
+typedef struct {
+    list_t      list;       // addrmatch_t entries in order of addition
+    addrnode_t  *tries[2];  // longest prefix match tries for IPv4 and IPv6
+} addrlist_t;
+
+#define ADDRLIST_DECL(x)    addrlist_t x = { { &x.list, &x.list } }
+
 typedef struct {
     list_t  entry;
     char    string[1];
@@ -489,16 +522,15 @@ typedef struct server_static_s {
     ratelimit_t     ratelimit_status;
     ratelimit_t     ratelimit_auth;
     ratelimit_t     ratelimit_rcon;
-
-    challenge_t     challenges[MAX_CHALLENGES]; // to prevent invalid IPs from connecting
+    ratelimit_t     ratelimit_source;   // template for per-source buckets
 } server_static_t;
 
 //=============================================================================
 
 extern master_t     sv_masters[MAX_MASTERS];    // address of the master server
 
-extern list_t       sv_banlist;
-extern list_t       sv_blacklist;
+extern addrlist_t   sv_banlist;
+extern addrlist_t   sv_blacklist;
 extern list_t       sv_cmdlist_connect;
 extern list_t       sv_cmdlist_begin;
 extern list_t       sv_lrconlist;
@@ -530,7 +562,11 @@ extern cvar_t       *sv_debug;
 extern cvar_t       *sv_pad_packets;
 #endif
 extern cvar_t       *sv_novis;
+extern cvar_t       *sv_threads;
 extern cvar_t       *sv_lan_force_rate;
+extern cvar_t       *sv_min_rate;
+extern cvar_t       *sv_max_rate;
+extern cvar_t       *sv_rate_control;
 extern cvar_t       *sv_calcpings_method;
 extern cvar_t       *sv_changemapcmd;
 
@@ -548,10 +584,16 @@ extern cvar_t       *sv_status_limit;
 extern cvar_t       *sv_status_show;
 extern cvar_t       *sv_auth_limit;
 extern cvar_t       *sv_rcon_limit;
+extern cvar_t       *sv_source_limit;
 extern cvar_t       *sv_uptime;
 
 extern cvar_t       *sv_allow_unconnected_cmds;
 
+extern cvar_t       *sv_download_cache_size;
+#if USE_ZLIB
+extern cvar_t       *sv_zlib_stream;
+#endif
+
 extern cvar_t       *g_features;
 
 extern cvar_t       *map_override_path;
@@ -572,6 +614,8 @@ extern edict_t      *sv_player;
 void SV_DropClient(client_t *drop, const char *reason);
 void SV_RemoveClient(client_t *client);
 void SV_CleanClient(client_t *client);
+void SV_ProcessClientPacket(client_t *client);
+client_t *SV_AddSyntheticClient(const char *info);
 
 void SV_InitOperatorCommands(void);
 
@@ -580,8 +624,16 @@ void SV_UserinfoChanged(client_t *cl);
 bool SV_RateLimited(ratelimit_t *r);
 void SV_RateRecharge(ratelimit_t *r);
 void SV_RateInit(ratelimit_t *r, const char *s);
+bool SV_SourceLimited(const netadr_t *addr);
+void SV_ClearSources(void);
+void SV_ListSources_f(void);
+void SV_InvalidateStatus(void);
+void SV_StatusCacheInfo(void);
 
-addrmatch_t *SV_MatchAddress(list_t *list, netadr_t *address);
+addrmatch_t *SV_MatchAddress(addrlist_t *list, const netadr_t *address);
+addrmatch_t *SV_AddAddress(addrlist_t *list, addrmatch_t *match);
+void SV_RemoveAddress(addrlist_t *list, addrmatch_t *match);
+void SV_ClearAddresses(addrlist_t *list);
 
 int SV_CountClients(void);
 
@@ -626,8 +678,16 @@ void SV_BroadcastPrintf(int level, const char *fmt, ...) q_printf(2, 3);
 void SV_ClientCommand(client_t *cl, const char *fmt, ...) q_printf(2, 3);
 void SV_BroadcastCommand(const char *fmt, ...) q_printf(1, 2);
 void SV_ClientAddMessage(client_t *client, int flags);
+#if USE_ZLIB
+void SV_ResetClientStream(client_t *client);
+void SV_FreeClientStream(client_t *client);
+#else
+#define SV_ResetClientStream(client)    (void)0
+#define SV_FreeClientStream(client)     (void)0
+#endif
 void SV_ShutdownClientSend(client_t *client);
 void SV_InitClientSend(client_t *newcl);
+void SV_UpdateRateControl(client_t *client);
 
 //
 // sv_mvd.c
@@ -718,8 +778,11 @@ void SV_New_f(void);
 void SV_Begin_f(void);
 void SV_ExecuteClientMessage(client_t *cl);
 void SV_CloseDownload(client_t *client);
+void SV_FlushDownloadCache(void);
+void SV_FlushGamestateCache(void);
 #if USE_FPS
 void SV_AlignKeyFrames(client_t *client);
+void SV_SetClientFrameDiv(client_t *client, int framediv);
 #else
 #define SV_AlignKeyFrames(client) (void)0
 #endif
@@ -732,9 +795,9 @@ cvarban_t *SV_CheckInfoBans(const char *info, bool match_only);
 extern const cmd_option_t o_record[];
 #endif
 
-void SV_AddMatch_f(list_t *list);
-void SV_DelMatch_f(list_t *list);
-void SV_ListMatches_f(list_t *list);
+void SV_AddMatch_f(addrlist_t *list);
+void SV_DelMatch_f(addrlist_t *list);
+void SV_ListMatches_f(addrlist_t *list);
 client_t *SV_GetPlayer(const char *s, bool partial);
 void SV_PrintMiscInfo(void);
 
@@ -745,9 +808,17 @@ void SV_PrintMiscInfo(void);
 #define ES_INUSE(s) \
     ((s)->modelindex || (s)->effects || (s)->sound || (s)->event)
 
+void SV_CullClientFrame(client_t *client);
 void SV_BuildClientFrame(client_t *client);
 void SV_WriteFrameToClient_Default(client_t *client);
 void SV_WriteFrameToClient_Enhanced(client_t *client);
+#if USE_MVD_CLIENT
+int SV_GroupClientFrames(client_t **clients, int count);
+void SV_FlushFrameCache(void);
+#else
+#define SV_GroupClientFrames(clients, count)    (count)
+#define SV_FlushFrameCache()                    (void)0
+#endif
 
 //
 // sv_game.c
@@ -777,6 +848,82 @@ void SV_RegisterSavegames(void);
 #define SV_RegisterSavegames()          (void)0
 #endif
 
+//
+// sv_profile.c
+//
+typedef enum {
+    PROF_FRAME,
+    PROF_COMMANDS,
+    PROF_MVD_CLIENT,
+    PROF_PACKETS,
+    PROF_CLIENTTHINK,
+    PROF_ANTICHEAT,
+    PROF_MVD_SERVER,
+    PROF_ASYNC,
+    PROF_TIMEOUTS,
+    PROF_PINGS,
+    PROF_GIVEMSEC,
+    PROF_GAME,
+    PROF_GAME_SELF,
+    PROF_SEND,
+    PROF_HEARTBEAT,
+    PROF_PREPWORLD,
+
+    // game imports, nested inside the phases above
+    PROF_TRACE,
+    PROF_POINTCONTENTS,
+    PROF_LINKENTITY,
+    PROF_AREAEDICTS,
+    PROF_MULTICAST,
+    PROF_PMOVE,
+
+    PROF_NUM
+} profphase_t;
+
+#define PROF_FIRST_IMPORT   PROF_TRACE
+
+extern bool sv_profiling;
+
+void SV_ProfileAdd(profphase_t phase, uint64_t start);
+uint64_t SV_ProfileImportStart(cmstats_t *cm);
+void SV_ProfileImport(profphase_t phase, uint64_t start, intptr_t caller, const cmstats_t *cm);
+uint64_t SV_ProfileGameStart(void);
+void SV_ProfileGameStop(uint64_t start);
+void SV_ProfileEndFrame(void);
+void SV_ProfileSkipFrame(void);
+void SV_ProfileBenchStart(void);
+void SV_ProfileBenchStop(bool report);
+void SV_RegisterProfile(void);
+
+static inline uint64_t SV_ProfileStart(void)
+{
+    return sv_profiling ? Sys_Microseconds() : 0;
+}
+
+static inline void SV_ProfileStop(profphase_t phase, uint64_t start)
+{
+    if (start)
+        SV_ProfileAdd(phase, start);
+}
+
+#define SV_PROFILE(phase, call) \
+    do { \
+        uint64_t prof_start = SV_ProfileStart(); \
+        call; \
+        SV_ProfileStop(phase, prof_start); \
+    } while (0)
+
+//
+// sv_bench.c
+//
+extern bool sv_cmdrecording;
+extern bool sv_benchmarking;
+
+void SV_BenchmarkRecordCmd(const usercmd_t *cmd);
+void SV_BenchmarkFrame(void);
+void SV_BenchmarkShutdown(void);
+void SV_RegisterBenchmark(void);
+
 //============================================================
 
 //
@@ -213,6 +213,215 @@ static void write_gamestate(void)
     SV_ClientAddMessage(sv_client, MSG_GAMESTATE);
 }
 
+/*
+============================================================
+
+GAMESTATE CACHE
+
+Encoded and compressed gamestate messages are kept along with the
+baselines they were encoded from, and replayed to other clients with
+identical protocol settings. This avoids re-encoding and deflating the
+entire gamestate for each client in a reconnect storm after map change.
+
+============================================================
+*/
+
+#define GAMESTATE_CACHE_SIZE    8
+#define GAMESTATE_CACHE_TIME    10000   // msec
+
+typedef struct {
+    // cache key
+    int             protocol;
+    int             version;
+    msgEsFlags_t    esFlags;
+    netchan_type_t  nctype;
+    size_t          maxpacketlen;
+    bool            has_zlib;
+
+    unsigned        time;
+    size_t          size, maxsize;
+    byte            *data;      // 16-bit length prefixed messages
+    entity_packed_t *baselines[SV_BASELINES_CHUNKS];
+} gamestate_t;
+
+static gamestate_t  *sv_gamestates[GAMESTATE_CACHE_SIZE];
+static gamestate_t  *sv_gamestate_capture;
+
+static void free_gamestate(gamestate_t *gs)
+{
+    int i;
+
+    for (i = 0; i < SV_BASELINES_CHUNKS; i++)
+        Z_Free(gs->baselines[i]);
+    Z_Free(gs->data);
+    Z_Free(gs);
+}
+
+/*
+==================
+SV_FlushGamestateCache
+
+Called whenever a configstring changes.
+==================
+*/
+void SV_FlushGamestateCache(void)
+{
+    int i;
+
+    for (i = 0; i < GAMESTATE_CACHE_SIZE; i++) {
+        if (sv_gamestates[i]) {
+            free_gamestate(sv_gamestates[i]);
+            sv_gamestates[i] = NULL;
+        }
+    }
+}
+
+static bool gamestate_matches(const gamestate_t *gs)
+{
+    return gs->protocol == sv_client->protocol
+        && gs->version == sv_client->version
+        && gs->esFlags == sv_client->esFlags
+        && gs->nctype == sv_client->netchan->type
+        && gs->maxpacketlen == sv_client->netchan->maxpacketlen
+        && gs->has_zlib == sv_client->has_zlib;
+}
+
+static gamestate_t *find_gamestate(void)
+{
+    gamestate_t *gs;
+    int i;
+
+    for (i = 0; i < GAMESTATE_CACHE_SIZE; i++) {
+        gs = sv_gamestates[i];
+        if (!gs)
+            continue;
+
+        // let baselines catch up with the world every once in a while
+        if (svs.realtime - gs->time > GAMESTATE_CACHE_TIME) {
+            free_gamestate(gs);
+            sv_gamestates[i] = NULL;
+            continue;
+        }
+
+        if (gamestate_matches(gs))
+            return gs;
+    }
+
+    return NULL;
+}
+
+static void capture_message(client_t *client, byte *data, size_t len, bool reliable)
+{
+    gamestate_t *gs = sv_gamestate_capture;
+
+    if (gs->size + 2 + len > gs->maxsize) {
+        gs->maxsize = max(gs->maxsize * 2, gs->size + 2 + len);
+        gs->data = Z_Realloc(gs->data, gs->maxsize);
+    }
+
+    gs->data[gs->size + 0] = len & 255;
+    gs->data[gs->size + 1] = (len >> 8) & 255;
+    memcpy(gs->data + gs->size + 2, data, len);
+    gs->size += 2 + len;
+}
+
+static void write_gamestate_messages(void)
+{
+    if (sv_client->netchan->type == NETCHAN_NEW) {
+        write_gamestate();
+    } else {
+        write_configstrings();
+        write_baselines();
+    }
+}
+
+static gamestate_t *create_gamestate(void)
+{
+    void (*add)(client_t *, byte *, size_t, bool);
+    gamestate_t *gs;
+    int i;
+
+    gs = Z_Mallocz(sizeof(*gs));
+    gs->protocol = sv_client->protocol;
+    gs->version = sv_client->version;
+    gs->esFlags = sv_client->esFlags;
+    gs->nctype = sv_client->netchan->type;
+    gs->maxpacketlen = sv_client->netchan->maxpacketlen;
+    gs->has_zlib = sv_client->has_zlib;
+    gs->time = svs.realtime;
+
+    // capture messages instead of queueing them
+    add = sv_client->AddMessage;
+    sv_client->AddMessage = capture_message;
+    sv_gamestate_capture = gs;
+    write_gamestate_messages();
+    sv_client->AddMessage = add;
+    sv_gamestate_capture = NULL;
+
+    for (i = 0; i < SV_BASELINES_CHUNKS; i++) {
+        if (sv_client->baselines[i]) {
+            gs->baselines[i] = Z_Malloc(sizeof(entity_packed_t) * SV_BASELINES_PER_CHUNK);
+            memcpy(gs->baselines[i], sv_client->baselines[i],
+                   sizeof(entity_packed_t) * SV_BASELINES_PER_CHUNK);
+        }
+    }
+
+    // replace the oldest entry
+    for (i = 0; i < GAMESTATE_CACHE_SIZE - 1; i++) {
+        if (!sv_gamestates[i])
+            break;
+    }
+    if (sv_gamestates[i])
+        free_gamestate(sv_gamestates[i]);
+    memmove(sv_gamestates + 1, sv_gamestates, sizeof(sv_gamestates[0]) * i);
+    sv_gamestates[0] = gs;
+
+    return gs;
+}
+
+static void use_gamestate(const gamestate_t *gs)
+{
+    entity_packed_t **chunk;
+    int i;
+
+    // client must delta from exactly the baselines that were encoded
+    for (i = 0; i < SV_BASELINES_CHUNKS; i++) {
+        chunk = &sv_client->baselines[i];
+        if (gs->baselines[i]) {
+            if (*chunk == NULL)
+                *chunk = SV_Malloc(sizeof(entity_packed_t) * SV_BASELINES_PER_CHUNK);
+            memcpy(*chunk, gs->baselines[i], sizeof(entity_packed_t) * SV_BASELINES_PER_CHUNK);
+        } else if (*chunk) {
+            memset(*chunk, 0, sizeof(entity_packed_t) * SV_BASELINES_PER_CHUNK);
+        }
+    }
+}
+
+static void send_gamestate(void)
+{
+    gamestate_t *gs;
+    size_t ofs, len;
+
+    // MVD channels have their own configstrings
+    if (sv.state != ss_game) {
+        write_gamestate_messages();
+        return;
+    }
+
+    gs = find_gamestate();
+    if (gs) {
+        Com_DPrintf("Sending cached gamestate to %s\n", sv_client->name);
+        use_gamestate(gs);
+    } else {
+        gs = create_gamestate();
+    }
+
+    for (ofs = 0; ofs < gs->size; ofs += 2 + len) {
+        len = gs->data[ofs] | (gs->data[ofs + 1] << 8);
+        sv_client->AddMessage(sv_client, gs->data + ofs + 2, len, true);
+    }
+}
+
 static void stuff_cmds(list_t *list)
 {
     stuffcmd_t *stuff;
@@ -314,6 +523,9 @@ void SV_New_f(void)
     // create baselines for this client
     SV_CreateBaselines();
 
+    // client restarts its svc_zstream decompressor on serverdata
+    SV_ResetClientStream(sv_client);
+
     // send the serverdata
     MSG_WriteByte(svc_serverdata);
     MSG_WriteLong(sv_client->protocol);
@@ -380,12 +592,7 @@ void SV_New_f(void)
         return;
 
     // send gamestate
-    if (sv_client->netchan->type == NETCHAN_NEW) {
-        write_gamestate();
-    } else {
-        write_configstrings();
-        write_baselines();
-    }
+    send_gamestate();
 
     // send next command
     SV_ClientCommand(sv_client, "precache %i\n", sv_client->spawncount);
@@ -444,13 +651,110 @@ void SV_Begin_f(void)
     AC_ClientAnnounce(sv_client);
 }
 
-//=============================================================================
+/*
+==============================================================================
+
+DOWNLOAD CACHE
+
+Files being downloaded are loaded once and shared between all clients
+downloading them. Unreferenced files are kept around for future requests,
+least recently used are evicted once total size of the cache exceeds
+sv_download_cache_size megabytes.
+
+==============================================================================
+*/
+
+typedef struct dlcache_s {
+    list_t      entry;
+    int         refcount;
+    int         cmd;        // svc_download or svc_zdownload
+    int         size;
+    time_t      mtime;      // 0 if file is in a pack
+    byte        *data;
+    char        name[1];
+} dlcache_t;
+
+static LIST_DECL(sv_dlcache);
+static size_t sv_dlcache_bytes;
+
+static void free_download(dlcache_t *cache)
+{
+    List_Remove(&cache->entry);
+    sv_dlcache_bytes -= cache->size;
+    Z_Free(cache);
+}
+
+static void trim_download_cache(void)
+{
+    size_t limit = Cvar_ClampInteger(sv_download_cache_size, 0, 1024) << 20;
+    dlcache_t *cache, *next;
+
+    LIST_FOR_EACH_SAFE(dlcache_t, cache, next, &sv_dlcache, entry) {
+        if (sv_dlcache_bytes <= limit)
+            break;
+        if (!cache->refcount)
+            free_download(cache);
+    }
+}
+
+static dlcache_t *find_download(const char *name, int cmd, int size, time_t mtime)
+{
+    dlcache_t *cache;
+
+    LIST_FOR_EACH(dlcache_t, cache, &sv_dlcache, entry) {
+        // size or time mismatch means the file has changed on disk
+        if (cache->cmd == cmd && cache->size == size && cache->mtime == mtime &&
+            !strcmp(cache->name, name)) {
+            // move to the most recently used end
+            List_Remove(&cache->entry);
+            List_Append(&sv_dlcache, &cache->entry);
+            return cache;
+        }
+    }
+
+    return NULL;
+}
+
+static dlcache_t *load_download(const char *name, int cmd, int size, time_t mtime, qhandle_t f)
+{
+    size_t len = strlen(name);
+    dlcache_t *cache;
+
+    cache = SV_Malloc(sizeof(*cache) + len + size);
+    cache->refcount = 0;
+    cache->cmd = cmd;
+    cache->size = size;
+    cache->mtime = mtime;
+    cache->data = (byte *)cache->name + len + 1;
+    memcpy(cache->name, name, len + 1);
+
+    if (FS_Read(cache->data, size, f) != size) {
+        Z_Free(cache);
+        return NULL;
+    }
+
+    List_Append(&sv_dlcache, &cache->entry);
+    sv_dlcache_bytes += size;
+    return cache;
+}
+
+void SV_FlushDownloadCache(void)
+{
+    dlcache_t *cache, *next;
+
+    LIST_FOR_EACH_SAFE(dlcache_t, cache, next, &sv_dlcache, entry) {
+        if (!cache->refcount)
+            free_download(cache);
+    }
+}
 
 void SV_CloseDownload(client_t *client)
 {
-    if (client->download) {
-        Z_Free(client->download);
+    if (client->downloadcache) {
+        client->downloadcache->refcount--;
+        client->downloadcache = NULL;
         client->download = NULL;
+        trim_download_cache();
     }
     if (client->downloadname) {
         Z_Free(client->downloadname);
@@ -483,10 +787,11 @@ SV_BeginDownload_f
 static void SV_BeginDownload_f(void)
 {
     char    name[MAX_QPATH];
-    byte    *download;
+    dlcache_t *cache;
+    file_info_t info;
     int     downloadcmd;
     int64_t downloadsize;
-    int     maxdownloadsize, result, offset = 0;
+    int     maxdownloadsize, offset = 0;
     cvar_t  *allow;
     size_t  len;
     qhandle_t f;
@@ -613,16 +918,28 @@ static void SV_BeginDownload_f(void)
         return;
     }
 
-    download = SV_Malloc(downloadsize);
-    result = FS_Read(download, downloadsize, f);
-    if (result != downloadsize) {
-        Com_DPrintf("Couldn't download %s to %s\n", name, sv_client->name);
-        goto fail3;
+    // files in packs have no modification time
+    if (FS_GetFileInfo(f, &info))
+        info.mtime = 0;
+
+    cache = find_download(name, downloadcmd, downloadsize, info.mtime);
+    if (cache) {
+        Com_DPrintf("Serving cached copy of %s\n", name);
+    } else {
+        cache = load_download(name, downloadcmd, downloadsize, info.mtime, f);
+        if (!cache) {
+            Com_DPrintf("Couldn't download %s to %s\n", name, sv_client->name);
+            goto fail2;
+        }
     }
 
     FS_FCloseFile(f);
 
-    sv_client->download = download;
+    cache->refcount++;
+    trim_download_cache();
+
+    sv_client->downloadcache = cache;
+    sv_client->download = cache->data;
     sv_client->downloadsize = downloadsize;
     sv_client->downloadcount = offset;
     sv_client->downloadname = SV_CopyString(name);
@@ -632,8 +949,6 @@ static void SV_BeginDownload_f(void)
     Com_DPrintf("Downloading %s to %s\n", name, sv_client->name);
     return;
 
-fail3:
-    Z_Free(download);
 fail2:
     FS_FCloseFile(f);
 fail1:
@@ -1032,7 +1347,10 @@ static inline void SV_ClientThink(usercmd_t *cmd)
         sv_client->lastactivity = svs.realtime;
     }
 
-    ge->ClientThink(sv_player, cmd);
+    if (sv_cmdrecording)
+        SV_BenchmarkRecordCmd(cmd);
+
+    SV_PROFILE(PROF_CLIENTTHINK, ge->ClientThink(sv_player, cmd));
 }
 
 static void SV_SetLastFrame(int lastframe)
@@ -1402,9 +1720,29 @@ void SV_AlignKeyFrames(client_t *client)
     client->framenum = newnum;
 }
 
+void SV_SetClientFrameDiv(client_t *client, int framediv)
+{
+    int framerate = sv.framerate / framediv;
+
+    Com_DPrintf("[%d] client div=%d, server div=%d, rate=%d\n",
+                sv.framenum, framediv, sv.framediv, framerate);
+
+    client->framediv = framediv;
+
+    SV_AlignKeyFrames(client);
+
+    // save for status inspection
+    client->settings[CLS_FPS] = framerate;
+
+    MSG_WriteByte(svc_setting);
+    MSG_WriteLong(SVS_FPS);
+    MSG_WriteLong(framerate);
+    SV_ClientAddMessage(client, MSG_RELIABLE | MSG_CLEAR);
+}
+
 static void set_client_fps(int value)
 {
-    int framediv, framerate;
+    int framediv;
 
     // 0 means highest
     if (!value)
@@ -1415,22 +1753,11 @@ static void set_client_fps(int value)
     clamp(framediv, 1, MAX_FRAMEDIV);
 
     framediv = sv.framediv / Q_gcd(sv.framediv, framediv);
-    framerate = sv.framerate / framediv;
 
-    Com_DPrintf("[%d] client div=%d, server div=%d, rate=%d\n",
-                sv.framenum, framediv, sv.framediv, framerate);
+    // rate control may lower packet rate, but never below this
+    sv_client->cc.framediv = framediv;
 
-    sv_client->framediv = framediv;
-
-    SV_AlignKeyFrames(sv_client);
-
-    // save for status inspection
-    sv_client->settings[CLS_FPS] = framerate;
-
-    MSG_WriteByte(svc_setting);
-    MSG_WriteLong(SVS_FPS);
-    MSG_WriteLong(framerate);
-    SV_ClientAddMessage(sv_client, MSG_RELIABLE | MSG_CLEAR);
+    SV_SetClientFrameDiv(sv_client, framediv);
 }
 #endif
 
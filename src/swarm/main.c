@@ -0,0 +1,634 @@
+/*
+Copyright (C) 2003-2011 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// sw_main.c -- headless client swarm
+//
+// Drives a number of simulated players connected to a single server from
+// one process. Each player has its own UDP socket and netchan, parses every
+// server message the way the real client does, predicts own movement with
+// pmove and sends scripted usercmds. Ping, frame loss and message parsing
+// cost are collected per player.
+//
+// Only the original protocol 34 is spoken. Every server supports it, and
+// it keeps the message parser small.
+//
+// The swarm takes the place of the server in the dedicated main loop, hence
+// SV_Init, SV_Frame and friends are implemented here.
+//
+
+#include "swarm.h"
+
+swarm_t     sw;
+jmp_buf     sw_jmpbuf;
+
+cvar_t  *sw_fps;
+cvar_t  *sw_script;
+cvar_t  *sw_predict;
+
+static cvar_t   *sw_name;
+static cvar_t   *sw_rate;
+static cvar_t   *sw_stagger;
+static cvar_t   *sw_timeout;
+static cvar_t   *sw_reconnect;
+
+// client whose socket is being read
+static sw_client_t  *sw_current;
+
+#define RETRY_MSEC      3000
+#define KEEPALIVE_MSEC  100
+
+/*
+==================================================================
+
+CONNECTION
+
+==================================================================
+*/
+
+static void send_oob(sw_client_t *cl, const char *fmt, ...) q_printf(2, 3);
+static void send_oob(sw_client_t *cl, const char *fmt, ...)
+{
+    va_list     argptr;
+    char        data[MAX_PACKETLEN_DEFAULT];
+    size_t      len;
+
+    memset(data, 0xff, 4);
+
+    va_start(argptr, fmt);
+    len = Q_vsnprintf(data + 4, sizeof(data) - 4, fmt, argptr);
+    va_end(argptr);
+
+    if (len >= sizeof(data) - 4) {
+        Com_WPrintf("%s: overflow\n", __func__);
+        return;
+    }
+
+    NET_SendSocketPacket(cl->socket, data, len + 4, &sw.address);
+}
+
+static void send_connect(sw_client_t *cl)
+{
+    char    userinfo[MAX_INFO_STRING];
+
+    Q_snprintf(userinfo, sizeof(userinfo),
+               "\\name\\%s\\skin\\male/grunt\\hand\\2\\rate\\%d",
+               cl->name, sw_rate->integer);
+
+    send_oob(cl, "connect %d %d %d \"%s\"\n", PROTOCOL_VERSION_DEFAULT,
+             cl->qport, cl->challenge, userinfo);
+}
+
+static void check_connect(sw_client_t *cl)
+{
+    if (com_localTime - cl->retry_time < RETRY_MSEC)
+        return;
+
+    cl->retry_time = com_localTime;
+    cl->retries++;
+
+    switch (cl->state) {
+    case sw_dead:
+        if (!sw_reconnect->integer)
+            return;
+        Com_Printf("%s: reconnecting...\n", cl->name);
+        cl->state = sw_challenging;
+        // fall through
+    case sw_challenging:
+        send_oob(cl, "getchallenge\n");
+        break;
+    case sw_connecting:
+        send_connect(cl);
+        break;
+    default:
+        break;
+    }
+}
+
+void SW_ClientCommand(sw_client_t *cl, const char *s)
+{
+    MSG_WriteByte(clc_stringcmd);
+    MSG_WriteString(s);
+    MSG_FlushTo(&cl->netchan->message);
+}
+
+static void drop_client(sw_client_t *cl)
+{
+    netchan_t *netchan = cl->netchan;
+    int i;
+
+    if (netchan) {
+        // send a disconnect message, three times to be sure
+        MSG_WriteByte(clc_stringcmd);
+        MSG_WriteData("disconnect", 11);
+        for (i = 0; i < 3; i++)
+            netchan->Transmit(netchan, msg_write.cursize, msg_write.data, 1);
+        SZ_Clear(&msg_write);
+
+        Netchan_Close(netchan);
+        cl->netchan = NULL;
+    }
+
+    if (cl->state > sw_connecting)
+        cl->stats.drops++;
+
+    cl->state = sw_dead;
+    cl->retry_time = com_localTime;
+    cl->retries = 0;
+}
+
+/*
+==================
+SW_Dropf
+
+Drops the client and jumps back to the packet loop.
+==================
+*/
+void SW_Dropf(sw_client_t *cl, const char *fmt, ...)
+{
+    va_list     argptr;
+    char        text[MAXERRORMSG];
+
+    va_start(argptr, fmt);
+    Q_vsnprintf(text, sizeof(text), fmt, argptr);
+    va_end(argptr);
+
+    Com_Printf("%s: %s\n", cl->name, text);
+
+    drop_client(cl);
+
+    longjmp(sw_jmpbuf, -1);
+}
+
+static void free_client(sw_client_t *cl)
+{
+    drop_client(cl);
+    NET_CloseSocket(cl->socket);
+    Z_Free(cl->entityStates);
+    Z_Free(cl->baselines);
+    Z_Free(cl);
+}
+
+static void spawn_client(void)
+{
+    sw_client_t *cl;
+    qsocket_t s;
+
+    s = NET_OpenSocket();
+    if (s == -1) {
+        Com_EPrintf("Couldn't open swarm UDP socket: %s\n", NET_ErrorString());
+        sw.pending = 0;
+        return;
+    }
+
+    cl = SW_Mallocz(sizeof(*cl));
+    cl->number = sw.numclients;
+    cl->socket = s;
+    cl->qport = (Q_rand() & 0xff00) | cl->number;  // unique within the swarm
+    cl->entityStates = SW_Malloc(sizeof(cl->entityStates[0]) * MAX_PARSE_ENTITIES);
+    cl->baselines = SW_Malloc(sizeof(cl->baselines[0]) * MAX_EDICTS);
+    cl->state = sw_challenging;
+    cl->retry_time = com_localTime - RETRY_MSEC;
+    Q_snprintf(cl->name, sizeof(cl->name), "%s%d", sw_name->string, cl->number);
+
+    sw.clients[sw.numclients++] = cl;
+    sw.pending--;
+}
+
+/*
+==================================================================
+
+PACKET PROCESSING
+
+==================================================================
+*/
+
+static void connectionless_packet(sw_client_t *cl)
+{
+    char    string[MAX_STRING_CHARS];
+    char    *c;
+
+    MSG_BeginReading();
+    MSG_ReadLong();        // skip the -1 marker
+
+    if (MSG_ReadStringLine(string, sizeof(string)) >= sizeof(string))
+        return;
+
+    Cmd_TokenizeString(string, false);
+    c = Cmd_Argv(0);
+
+    if (!strcmp(c, "challenge")) {
+        if (cl->state != sw_challenging)
+            return;
+        cl->challenge = atoi(Cmd_Argv(1));
+        cl->state = sw_connecting;
+        cl->retry_time = com_localTime;
+        send_connect(cl);
+        return;
+    }
+
+    if (!strcmp(c, "client_connect")) {
+        if (cl->state != sw_connecting)
+            return;
+        cl->netchan = Netchan_Setup(NS_CLIENT, NETCHAN_OLD, &sw.address,
+                                    cl->qport, MAX_PACKETLEN_DEFAULT,
+                                    PROTOCOL_VERSION_DEFAULT);
+        cl->netchan->socket = cl->socket;
+        cl->state = sw_connected;
+        SW_ClientCommand(cl, "new");
+        return;
+    }
+
+    if (!strcmp(c, "print")) {
+        if (cl->state != sw_challenging && cl->state != sw_connecting)
+            return;
+        if (MSG_ReadString(string, sizeof(string)) >= sizeof(string))
+            return;
+        Com_Printf("%s: %s", cl->name, string);
+        // server refused us, start over later
+        cl->state = sw_challenging;
+        cl->retry_time = com_localTime;
+        return;
+    }
+}
+
+static void calc_ping(sw_client_t *cl)
+{
+    sw_history_t *h = &cl->history[cl->netchan->incoming_acknowledged & CMD_MASK];
+    unsigned rtt;
+
+    if (cl->state != sw_active || h->rcvd || !h->sent)
+        return;
+
+    h->rcvd = true;
+    rtt = Sys_Milliseconds() - h->sent;
+
+    cl->stats.ping_sum += rtt;
+    if (!cl->stats.ping_count++ || rtt < cl->stats.ping_min)
+        cl->stats.ping_min = rtt;
+    if (rtt > cl->stats.ping_max)
+        cl->stats.ping_max = rtt;
+}
+
+static void packet_event(void)
+{
+    sw_client_t *cl = sw_current;
+    uint64_t start;
+    unsigned usec;
+
+    if (msg_read.cursize < 4)
+        return;
+
+    if (!NET_IsEqualAdr(&net_from, &sw.address))
+        return;
+
+    if (*(int *)msg_read.data == -1) {
+        connectionless_packet(cl);
+        return;
+    }
+
+    if (!cl->netchan || msg_read.cursize < 8)
+        return;
+
+    if (!cl->netchan->Process(cl->netchan))
+        return;     // wasn't accepted for some reason
+
+    calc_ping(cl);
+
+    cl->stats.messages++;
+    cl->stats.bytes += msg_read.cursize;
+
+    if (setjmp(sw_jmpbuf))
+        return;
+
+    start = Sys_Microseconds();
+    SW_ParseServerMessage(cl);
+    usec = Sys_Microseconds() - start;
+
+    cl->stats.parse_us += usec;
+    if (usec > cl->stats.parse_max)
+        cl->stats.parse_max = usec;
+}
+
+static void run_client(sw_client_t *cl)
+{
+    netchan_t *netchan;
+
+    sw_current = cl;
+    NET_GetSocketPackets(cl->socket, packet_event);
+    sw_current = NULL;
+
+    netchan = cl->netchan;
+    if (!netchan) {
+        check_connect(cl);
+        return;
+    }
+
+    if (com_localTime - netchan->last_received > sw_timeout->value * 1000) {
+        Com_Printf("%s: server connection timed out\n", cl->name);
+        drop_client(cl);
+        return;
+    }
+
+    if (cl->state == sw_active) {
+        if (com_localTime - cl->cmd_time >= 1000 / sw_fps->integer)
+            SW_SendCmd(cl);
+        return;
+    }
+
+    // keep acknowledging gamestate while loading
+    if (netchan->message.cursize || netchan->reliable_ack_pending ||
+        com_localTime - netchan->last_sent > KEEPALIVE_MSEC) {
+        netchan->Transmit(netchan, 0, "", 1);
+    }
+}
+
+/*
+==================================================================
+
+COMMANDS
+
+==================================================================
+*/
+
+static void disconnect_all(void)
+{
+    int i;
+
+    for (i = 0; i < sw.numclients; i++)
+        free_client(sw.clients[i]);
+
+    sw.numclients = 0;
+    sw.pending = 0;
+
+    SW_FreeCollisionMap();
+}
+
+static void SW_Connect_f(void)
+{
+    netadr_t adr;
+    int count;
+
+    if (Cmd_Argc() < 2) {
+        Com_Printf("Usage: %s <address> [count]\n", Cmd_Argv(0));
+        return;
+    }
+
+    if (!NET_StringToAdr(Cmd_Argv(1), &adr, PORT_SERVER) || adr.type != NA_IP) {
+        Com_Printf("Bad IPv4 address: %s\n", Cmd_Argv(1));
+        return;
+    }
+
+    if (sw.numclients && !NET_IsEqualAdr(&adr, &sw.address)) {
+        Com_Printf("Swarm is connected to %s, disconnect first.\n",
+                   NET_AdrToString(&sw.address));
+        return;
+    }
+
+    count = 1;
+    if (Cmd_Argc() > 2)
+        count = atoi(Cmd_Argv(2));
+
+    count = min(count, SW_MAX_CLIENTS - sw.numclients - sw.pending);
+    if (count < 1) {
+        Com_Printf("Can't spawn more than %d clients.\n", SW_MAX_CLIENTS);
+        return;
+    }
+
+    if (!sw.numclients && !sw.pending)
+        sw.start_us = Sys_Microseconds();
+
+    sw.address = adr;
+    sw.pending += count;
+
+    Com_Printf("Connecting %d client%s to %s...\n", count,
+               count == 1 ? "" : "s", NET_AdrToString(&adr));
+}
+
+static void SW_Disconnect_f(void)
+{
+    if (!sw.numclients && !sw.pending) {
+        Com_Printf("Swarm is not running.\n");
+        return;
+    }
+
+    Com_Printf("Disconnecting %d clients.\n", sw.numclients);
+    disconnect_all();
+}
+
+static const char *state_string(sw_state_t state)
+{
+    switch (state) {
+    case sw_dead:           return "dead";
+    case sw_challenging:    return "chal";
+    case sw_connecting:     return "conn";
+    case sw_connected:      return "load";
+    case sw_primed:         return "prim";
+    case sw_active:         return "actv";
+    }
+    return "????";
+}
+
+static void SW_Status_f(void)
+{
+    sw_client_t *cl;
+    sw_stats_t  *s, total;
+    unsigned    sec, dropped, received;
+    int         i, active;
+
+    if (!sw.numclients) {
+        Com_Printf("Swarm is not running.\n");
+        return;
+    }
+
+    sec = max((Sys_Microseconds() - sw.start_us) / 1000000, 1);
+
+    Com_Printf(
+        "num name            stat ping  min  max frames lost  inv drop%% parse/msg pred  kB/s\n"
+        "--- --------------- ---- ---- ---- ---- ------ ---- ---- ----- --------- ---- -----\n");
+
+    memset(&total, 0, sizeof(total));
+    dropped = received = 0;
+    active = 0;
+
+    for (i = 0; i < sw.numclients; i++) {
+        cl = sw.clients[i];
+        s = &cl->stats;
+
+        Com_Printf("%3d %-15.15s %s %4u %4u %4u %6u %4u %4u %5.1f %9.1f %4.1f %5.1f\n",
+                   cl->number, cl->name, state_string(cl->state),
+                   s->ping_count ? (unsigned)(s->ping_sum / s->ping_count) : 0,
+                   s->ping_min, s->ping_max, s->frames, s->lost, s->invalid,
+                   cl->netchan && cl->netchan->total_received ?
+                   cl->netchan->total_dropped * 100.0f / cl->netchan->total_received : 0.0f,
+                   s->messages ? (float)s->parse_us / s->messages : 0.0f,
+                   s->predicts ? (float)s->predict_us / s->predicts : 0.0f,
+                   s->bytes / 1024.0f / sec);
+
+        if (cl->state == sw_active)
+            active++;
+
+        if (cl->netchan) {
+            dropped += cl->netchan->total_dropped;
+            received += cl->netchan->total_received;
+        }
+
+        total.frames += s->frames;
+        total.lost += s->lost;
+        total.invalid += s->invalid;
+        total.messages += s->messages;
+        total.bytes += s->bytes;
+        total.parse_us += s->parse_us;
+        total.parse_max = max(total.parse_max, s->parse_max);
+        total.predict_us += s->predict_us;
+        total.predicts += s->predicts;
+        total.ping_sum += s->ping_sum;
+        total.ping_count += s->ping_count;
+        total.ping_max = max(total.ping_max, s->ping_max);
+        total.drops += s->drops;
+    }
+
+    Com_Printf("\n%d of %d clients active, %u seconds\n", active, sw.numclients, sec);
+    Com_Printf("ping:   %u msec average, %u msec max\n",
+               total.ping_count ? (unsigned)(total.ping_sum / total.ping_count) : 0,
+               total.ping_max);
+    Com_Printf("frames: %u received, %u lost (%.1f%%), %u invalid\n",
+               total.frames, total.lost,
+               total.frames + total.lost ? total.lost * 100.0f / (total.frames + total.lost) : 0.0f,
+               total.invalid);
+    Com_Printf("packets: %u received, %u dropped (%.1f%%), %u disconnects\n",
+               received, dropped, received ? dropped * 100.0f / received : 0.0f,
+               total.drops);
+    Com_Printf("parse:  %.1f usec/msg average, %u usec max, %.1f%% of one core\n",
+               total.messages ? (float)total.parse_us / total.messages : 0.0f,
+               total.parse_max, total.parse_us / 10000.0f / sec);
+    Com_Printf("predict: %.1f usec/cmd average\n",
+               total.predicts ? (float)total.predict_us / total.predicts : 0.0f);
+    Com_Printf("rate:   %.1f kB/s in total\n", total.bytes / 1024.0f / sec);
+}
+
+static void SW_Reset_f(void)
+{
+    sw_client_t *cl;
+    int i;
+
+    for (i = 0; i < sw.numclients; i++) {
+        cl = sw.clients[i];
+        memset(&cl->stats, 0, sizeof(cl->stats));
+        if (cl->netchan)
+            cl->netchan->total_dropped = cl->netchan->total_received = 0;
+    }
+
+    sw.start_us = Sys_Microseconds();
+}
+
+static const cmdreg_t c_swarm[] = {
+    { "sw_connect", SW_Connect_f },
+    { "sw_disconnect", SW_Disconnect_f },
+    { "sw_status", SW_Status_f },
+    { "sw_reset", SW_Reset_f },
+
+    { NULL }
+};
+
+/*
+==================================================================
+
+MAIN LOOP INTERFACE
+
+==================================================================
+*/
+
+/*
+==================
+SV_Frame
+
+Receives and sends packets for all clients. Returns number of
+milliseconds until the next client command is due.
+==================
+*/
+unsigned SV_Frame(unsigned msec)
+{
+    sw_client_t *cl;
+    unsigned delta, remaining;
+    int i;
+
+    // process console commands
+    Cbuf_Execute(&cmd_buffer);
+
+    if (sw.pending && com_localTime - sw.connect_time >= sw_stagger->integer) {
+        sw.connect_time = com_localTime;
+        spawn_client();
+    }
+
+    Cvar_ClampInteger(sw_fps, 1, 125);
+    delta = 1000 / sw_fps->integer;
+    remaining = KEEPALIVE_MSEC;
+
+    for (i = 0; i < sw.numclients; i++) {
+        cl = sw.clients[i];
+        run_client(cl);
+
+        if (cl->state == sw_active)
+            remaining = min(remaining, delta - min(com_localTime - cl->cmd_time, delta));
+    }
+
+    if (sw.pending)
+        remaining = min(remaining, sw_stagger->integer);
+
+    if (cmd_buffer.waitCount > 0)
+        cmd_buffer.waitCount--;
+
+    return remaining;
+}
+
+#if USE_ICMP
+void SV_ErrorEvent(netadr_t *from, int ee_errno, int ee_info)
+{
+}
+#endif
+
+#if USE_SYSCON
+void SV_SetConsoleTitle(void)
+{
+    Sys_SetConsoleTitle(PRODUCT " swarm");
+}
+#endif
+
+void SV_Init(void)
+{
+    Cmd_Register(c_swarm);
+
+    sw_name = Cvar_Get("sw_name", "swarm", 0);
+    sw_rate = Cvar_Get("sw_rate", "25000", 0);
+    sw_fps = Cvar_Get("sw_fps", "30", 0);
+    sw_script = Cvar_Get("sw_script", "1", 0);
+    sw_predict = Cvar_Get("sw_predict", "1", 0);
+    sw_stagger = Cvar_Get("sw_stagger", "20", 0);
+    sw_timeout = Cvar_Get("sw_timeout", "30", 0);
+    sw_reconnect = Cvar_Get("sw_reconnect", "1", 0);
+
+#if USE_SYSCON
+    SV_SetConsoleTitle();
+#endif
+}
+
+void SV_Shutdown(const char *finalmsg, error_type_t type)
+{
+    disconnect_all();
+}
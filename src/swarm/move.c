@@ -0,0 +1,258 @@
+/*
+Copyright (C) 2003-2011 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// sw_move.c -- scripted movement and prediction
+//
+
+#include "swarm.h"
+
+#define STUCK_SPEED     50      // units per second
+#define STUCK_MSEC      300
+
+/*
+=================================================================
+
+PREDICTION
+
+Collision map is shared by all clients and only traced against
+the world, solid entities are ignored.
+
+=================================================================
+*/
+
+static trace_t q_gameabi sw_trace(vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end)
+{
+    trace_t t;
+
+    CM_BoxTrace(&t, start, end, mins, maxs, sw.cm.cache->nodes, MASK_PLAYERSOLID);
+    if (t.fraction < 1.0f)
+        t.ent = (struct edict_s *)1;
+
+    return t;
+}
+
+static int sw_pointcontents(vec3_t point)
+{
+    return CM_PointContents(point, sw.cm.cache->nodes);
+}
+
+void SW_FreeCollisionMap(void)
+{
+    CM_FreeMap(&sw.cm);
+    sw.cm_name[0] = 0;
+    sw.cm_failed = false;
+}
+
+static bool load_collision_map(const char *name)
+{
+    int ret;
+
+    if (!*name)
+        return false;
+
+    if (!strcmp(sw.cm_name, name))
+        return !sw.cm_failed;
+
+    SW_FreeCollisionMap();
+    Q_strlcpy(sw.cm_name, name, sizeof(sw.cm_name));
+
+    ret = CM_LoadMap(&sw.cm, name);
+    if (ret) {
+        Com_WPrintf("Couldn't load %s: %s. Prediction disabled.\n",
+                    name, Q_ErrorString(ret));
+        sw.cm_failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+static bool predict_move(sw_client_t *cl)
+{
+    unsigned    ack, current;
+    uint64_t    start;
+    pmove_t     pm;
+
+    if (!sw_predict->integer)
+        return false;
+
+    if (cl->frame.ps.pmove.pm_flags & PMF_NO_PREDICTION)
+        return false;
+
+    if (!load_collision_map(cl->mapname))
+        return false;
+
+    ack = cl->history[cl->netchan->incoming_acknowledged & CMD_MASK].cmdNumber;
+    current = cl->cmdNumber;
+
+    // if we are too far out of date, just freeze
+    if (current - ack > CMD_BACKUP - 1)
+        return false;
+
+    start = Sys_Microseconds();
+
+    memset(&pm, 0, sizeof(pm));
+    pm.trace = sw_trace;
+    pm.pointcontents = sw_pointcontents;
+    pm.s = cl->frame.ps.pmove;
+
+    while (++ack <= current) {
+        pm.cmd = cl->cmds[ack & CMD_MASK];
+        Pmove(&pm, &cl->pmp);
+    }
+
+    VectorScale(pm.s.origin, 0.125f, cl->predicted_origin);
+
+    cl->stats.predict_us += Sys_Microseconds() - start;
+    cl->stats.predicts++;
+    return true;
+}
+
+/*
+=================================================================
+
+SCRIPTS
+
+=================================================================
+*/
+
+void SW_ClearMove(sw_client_t *cl)
+{
+    memset(cl->cmds, 0, sizeof(cl->cmds));
+    memset(cl->history, 0, sizeof(cl->history));
+    cl->cmdNumber = 0;
+    cl->yaw = Q_rand_uniform(360);
+    cl->turning = 0;
+    cl->stuck = 0;
+    VectorClear(cl->predicted_origin);
+    VectorClear(cl->last_origin);
+}
+
+// runs forward and turns away when blocked
+static void script_run(sw_client_t *cl, usercmd_t *cmd)
+{
+    float   dist;
+
+    dist = Distance(cl->predicted_origin, cl->last_origin);
+    VectorCopy(cl->predicted_origin, cl->last_origin);
+
+    if (dist * 1000 < STUCK_SPEED * cmd->msec)
+        cl->stuck += cmd->msec;
+    else
+        cl->stuck = 0;
+
+    if (cl->stuck > STUCK_MSEC) {
+        cl->turning = 90 + Q_rand_uniform(180);
+        cl->stuck = 0;
+    }
+
+    // turn smoothly, 360 degrees per second
+    if (cl->turning > 0) {
+        dist = min(cl->turning, 0.36f * cmd->msec);
+        cl->yaw = anglemod(cl->yaw + dist);
+        cl->turning -= dist;
+    }
+
+    cmd->forwardmove = 400;
+}
+
+// runs around, strafes, jumps and shoots
+static void script_fight(sw_client_t *cl, usercmd_t *cmd)
+{
+    unsigned n = cl->cmdNumber + cl->number * 7;
+
+    script_run(cl, cmd);
+
+    cmd->sidemove = (n / 40) & 1 ? 200 : -200;
+    if (n % 50 < 2)
+        cmd->upmove = 200;
+    if (n % 30 < 3)
+        cmd->buttons |= BUTTON_ATTACK;
+}
+
+static void run_script(sw_client_t *cl, usercmd_t *cmd)
+{
+    switch (sw_script->integer) {
+    case 1:
+        script_run(cl, cmd);
+        break;
+    case 2:
+        script_fight(cl, cmd);
+        break;
+    }
+
+    cmd->angles[PITCH] = -cl->frame.ps.pmove.delta_angles[PITCH];
+    cmd->angles[YAW] = ANGLE2SHORT(cl->yaw) - cl->frame.ps.pmove.delta_angles[YAW];
+    cmd->angles[ROLL] = -cl->frame.ps.pmove.delta_angles[ROLL];
+}
+
+/*
+=================
+SW_SendCmd
+
+Builds a new usercmd and sends it along with two previous ones.
+=================
+*/
+void SW_SendCmd(sw_client_t *cl)
+{
+    netchan_t       *netchan = cl->netchan;
+    sw_history_t    *history;
+    usercmd_t       *cmd, *oldcmd;
+    unsigned        msec;
+    int             i;
+
+    msec = com_localTime - cl->cmd_time;
+    clamp(msec, 1, 250);
+    cl->cmd_time = com_localTime;
+
+    // predict pending commands first, scripts steer by predicted origin
+    if (!predict_move(cl))
+        VectorScale(cl->frame.ps.pmove.origin, 0.125f, cl->predicted_origin);
+
+    cmd = &cl->cmds[++cl->cmdNumber & CMD_MASK];
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->msec = msec;
+    run_script(cl, cmd);
+
+    // archive this packet
+    history = &cl->history[netchan->outgoing_sequence & CMD_MASK];
+    history->cmdNumber = cl->cmdNumber;
+    history->sent = Sys_Milliseconds();
+    history->rcvd = false;
+
+    MSG_WriteByte(clc_move);
+
+    // checksum byte is not verified by q2pro servers
+    MSG_WriteByte(0);
+
+    // let the server know what the last frame we
+    // got was, so the next message can be delta compressed
+    MSG_WriteLong(cl->frame.valid ? cl->frame.number : -1);
+
+    oldcmd = NULL;
+    for (i = 2; i >= 0; i--) {
+        cmd = &cl->cmds[(cl->cmdNumber - i) & CMD_MASK];
+        MSG_WriteDeltaUsercmd(oldcmd, cmd, 0);
+        MSG_WriteByte(128);    // lightlevel
+        oldcmd = cmd;
+    }
+
+    netchan->Transmit(netchan, msg_write.cursize, msg_write.data, 1);
+    SZ_Clear(&msg_write);
+}
@@ -0,0 +1,565 @@
+/*
+Copyright (C) 2003-2011 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// sw_parse.c -- parse a message received from the server
+//
+// Mirrors the client parser for protocol 34. Frames and entities are fully
+// delta decoded, everything else is read and thrown away.
+//
+
+#include "swarm.h"
+
+/*
+=====================================================================
+
+  DELTA FRAME PARSING
+
+=====================================================================
+*/
+
+static void parse_delta_entity(sw_client_t *cl, sw_frame_t *frame,
+                               int newnum, entity_state_t *old, int bits)
+{
+    entity_state_t *state;
+
+    if (frame->numEntities >= MAX_EDICTS)
+        SW_Dropf(cl, "%s: MAX_EDICTS exceeded", __func__);
+
+    state = &cl->entityStates[cl->numEntityStates & PARSE_ENTITIES_MASK];
+    cl->numEntityStates++;
+    frame->numEntities++;
+
+    MSG_ParseDeltaEntity(old, state, newnum, bits, 0);
+
+    // shuffle previous origin to old
+    if (!(bits & U_OLDORIGIN) && !(state->renderfx & RF_BEAM))
+        VectorCopy(old->origin, state->old_origin);
+}
+
+static entity_state_t *old_entity(sw_client_t *cl, sw_frame_t *oldframe,
+                                  int oldindex, int *oldnum)
+{
+    entity_state_t *oldstate;
+
+    if (!oldframe || oldindex >= oldframe->numEntities) {
+        *oldnum = 99999;
+        return NULL;
+    }
+
+    oldstate = &cl->entityStates[(oldframe->firstEntity + oldindex) & PARSE_ENTITIES_MASK];
+    *oldnum = oldstate->number;
+    return oldstate;
+}
+
+static void parse_packet_entities(sw_client_t *cl, sw_frame_t *oldframe,
+                                  sw_frame_t *frame)
+{
+    entity_state_t *oldstate;
+    int newnum, bits, oldindex, oldnum;
+
+    frame->firstEntity = cl->numEntityStates;
+    frame->numEntities = 0;
+
+    // delta from the entities present in oldframe
+    oldindex = 0;
+    oldstate = old_entity(cl, oldframe, oldindex, &oldnum);
+
+    while (1) {
+        newnum = MSG_ParseEntityBits(&bits);
+        if (newnum < 0 || newnum >= MAX_EDICTS)
+            SW_Dropf(cl, "%s: bad number: %d", __func__, newnum);
+
+        if (msg_read.readcount > msg_read.cursize)
+            SW_Dropf(cl, "%s: read past end of message", __func__);
+
+        if (!newnum)
+            break;
+
+        while (oldnum < newnum) {
+            // one or more entities from the old packet are unchanged
+            parse_delta_entity(cl, frame, oldnum, oldstate, 0);
+            oldstate = old_entity(cl, oldframe, ++oldindex, &oldnum);
+        }
+
+        if (bits & U_REMOVE) {
+            // the entity present in oldframe is not in the current frame
+            if (!oldframe)
+                SW_Dropf(cl, "%s: U_REMOVE with NULL oldframe", __func__);
+            oldstate = old_entity(cl, oldframe, ++oldindex, &oldnum);
+            continue;
+        }
+
+        if (oldnum == newnum) {
+            // delta from previous state
+            parse_delta_entity(cl, frame, newnum, oldstate, bits);
+            oldstate = old_entity(cl, oldframe, ++oldindex, &oldnum);
+            continue;
+        }
+
+        // delta from baseline
+        parse_delta_entity(cl, frame, newnum, &cl->baselines[newnum], bits);
+    }
+
+    // any remaining entities in the old frame are copied over
+    while (oldnum != 99999) {
+        parse_delta_entity(cl, frame, oldnum, oldstate, 0);
+        oldstate = old_entity(cl, oldframe, ++oldindex, &oldnum);
+    }
+}
+
+static void parse_frame(sw_client_t *cl)
+{
+    sw_frame_t      frame, *oldframe;
+    player_state_t  *from;
+    int             bits, length;
+
+    memset(&frame, 0, sizeof(frame));
+
+    frame.number = MSG_ReadLong();
+    frame.delta = MSG_ReadLong();
+    MSG_ReadByte();     // suppress count
+
+    // if the frame is delta compressed from data that we no longer have
+    // available, we must suck up the rest of the frame, but not use it, then
+    // ask for a non-compressed message
+    if (frame.delta > 0) {
+        oldframe = &cl->frames[frame.delta & UPDATE_MASK];
+        from = &oldframe->ps;
+        if (frame.delta == frame.number) {
+            Com_DPrintf("%s: %s: delta from current frame\n", cl->name, __func__);
+        } else if (oldframe->number != frame.delta) {
+            Com_DPrintf("%s: %s: delta frame was never received or too old\n", cl->name, __func__);
+        } else if (!oldframe->valid) {
+            Com_DPrintf("%s: %s: delta from invalid frame\n", cl->name, __func__);
+        } else if (cl->numEntityStates - oldframe->firstEntity >
+                   MAX_PARSE_ENTITIES - MAX_PACKET_ENTITIES) {
+            Com_DPrintf("%s: %s: delta entities too old\n", cl->name, __func__);
+        } else {
+            frame.valid = true; // valid delta parse
+        }
+    } else {
+        oldframe = NULL;
+        from = NULL;
+        frame.valid = true; // uncompressed frame
+    }
+
+    // skip areabits
+    length = MSG_ReadByte();
+    if (length < 0 || msg_read.readcount + length > msg_read.cursize)
+        SW_Dropf(cl, "%s: read past end of message", __func__);
+    msg_read.readcount += length;
+
+    if (MSG_ReadByte() != svc_playerinfo)
+        SW_Dropf(cl, "%s: not playerinfo", __func__);
+
+    bits = MSG_ReadWord();
+    MSG_ParseDeltaPlayerstate_Default(from, &frame.ps, bits);
+
+    if (MSG_ReadByte() != svc_packetentities)
+        SW_Dropf(cl, "%s: not packetentities", __func__);
+
+    parse_packet_entities(cl, oldframe, &frame);
+
+    // save the frame off in the backup array for later delta comparisons
+    cl->frames[frame.number & UPDATE_MASK] = frame;
+
+    if (cl->state < sw_primed)
+        return;
+
+    // count server frames that never made it here
+    if (cl->serverframe > 0 && frame.number > cl->serverframe + 1)
+        cl->stats.lost += frame.number - cl->serverframe - 1;
+    cl->serverframe = max(cl->serverframe, frame.number);
+
+    if (!frame.valid) {
+        cl->stats.invalid++;
+        cl->frame.valid = false;
+        return; // do not change anything
+    }
+
+    cl->stats.frames++;
+    cl->frame = frame;
+
+    if (cl->state == sw_primed) {
+        Com_DPrintf("%s: entered the game\n", cl->name);
+        cl->state = sw_active;
+        cl->cmd_time = com_localTime - 1000;
+    }
+}
+
+/*
+=====================================================================
+
+  SERVER CONNECTING MESSAGES
+
+=====================================================================
+*/
+
+static void parse_serverdata(sw_client_t *cl)
+{
+    char    string[MAX_QPATH];
+    int     protocol;
+
+    protocol = MSG_ReadLong();
+    if (protocol != PROTOCOL_VERSION_DEFAULT)
+        SW_Dropf(cl, "Requested protocol version %d, but server returned %d.",
+                 PROTOCOL_VERSION_DEFAULT, protocol);
+
+    cl->servercount = MSG_ReadLong();
+    MSG_ReadByte();     // attractloop
+    MSG_ReadString(string, sizeof(string));     // gamedir
+    cl->clientNum = MSG_ReadShort();
+    MSG_ReadString(string, sizeof(string));     // levelname
+
+    // wipe the state from the previous level
+    memset(cl->frames, 0, sizeof(cl->frames));
+    memset(&cl->frame, 0, sizeof(cl->frame));
+    memset(cl->baselines, 0, sizeof(cl->baselines[0]) * MAX_EDICTS);
+    cl->numEntityStates = 0;
+    cl->serverframe = 0;
+    cl->mapname[0] = 0;
+    PmoveInit(&cl->pmp);
+    SW_ClearMove(cl);
+
+    cl->state = sw_connected;
+}
+
+static void parse_configstring(sw_client_t *cl)
+{
+    char    string[MAX_QPATH];
+    int     index;
+
+    index = MSG_ReadShort();
+    if (index < 0 || index >= MAX_CONFIGSTRINGS)
+        SW_Dropf(cl, "%s: bad index: %d", __func__, index);
+
+    // only short strings are of any interest
+    if (index == CS_AIRACCEL) {
+        MSG_ReadString(string, sizeof(string));
+        cl->pmp.airaccelerate = atoi(string);
+    } else if (index == CS_MODELS + 1) {
+        MSG_ReadString(cl->mapname, sizeof(cl->mapname));
+    } else {
+        MSG_ReadString(NULL, 0);
+    }
+}
+
+static void parse_baseline(sw_client_t *cl)
+{
+    int index, bits;
+
+    index = MSG_ParseEntityBits(&bits);
+    if (index < 1 || index >= MAX_EDICTS)
+        SW_Dropf(cl, "%s: bad index: %d", __func__, index);
+
+    MSG_ParseDeltaEntity(NULL, &cl->baselines[index], index, bits, 0);
+}
+
+static void reconnect(sw_client_t *cl)
+{
+    if (cl->state < sw_connected)
+        return;
+
+    // keep the netchan, but request the new gamestate
+    cl->state = sw_connected;
+    cl->frame.valid = false;
+    SW_ClientCommand(cl, "new");
+}
+
+static void parse_stufftext(sw_client_t *cl)
+{
+    char    string[MAX_STRING_CHARS];
+    char    *line, *next, *c;
+
+    MSG_ReadString(string, sizeof(string));
+
+    for (line = string; line; line = next) {
+        next = strchr(line, '\n');
+        if (next)
+            *next++ = 0;
+
+        Cmd_TokenizeString(line, true);
+        c = Cmd_Argv(0);
+
+        if (!strcmp(c, "precache")) {
+            if (cl->state == sw_connected) {
+                SW_ClientCommand(cl, va("begin %s", Cmd_Argv(1)));
+                cl->state = sw_primed;
+            }
+        } else if (!strcmp(c, "cmd")) {
+            // forward to server, like the real client does
+            if (Cmd_Argc() > 1)
+                SW_ClientCommand(cl, Cmd_ArgsFrom(1));
+        } else if (!strcmp(c, "changing")) {
+            if (cl->state > sw_connected) {
+                cl->state = sw_connected;
+                cl->frame.valid = false;
+            }
+        } else if (!strcmp(c, "reconnect")) {
+            reconnect(cl);
+        }
+    }
+}
+
+/*
+=====================================================================
+
+ACTION MESSAGES
+
+=====================================================================
+*/
+
+static void parse_tent(sw_client_t *cl)
+{
+    vec3_t  pos;
+    int     type, entity;
+
+    type = MSG_ReadByte();
+
+    switch (type) {
+    case TE_BLOOD:
+    case TE_GUNSHOT:
+    case TE_SPARKS:
+    case TE_BULLET_SPARKS:
+    case TE_SCREEN_SPARKS:
+    case TE_SHIELD_SPARKS:
+    case TE_SHOTGUN:
+    case TE_BLASTER:
+    case TE_GREENBLOOD:
+    case TE_BLASTER2:
+    case TE_FLECHETTE:
+    case TE_HEATBEAM_SPARKS:
+    case TE_HEATBEAM_STEAM:
+    case TE_MOREBLOOD:
+    case TE_ELECTRIC_SPARKS:
+        MSG_ReadPos(pos);
+        MSG_ReadByte();
+        break;
+
+    case TE_SPLASH:
+    case TE_LASER_SPARKS:
+    case TE_WELDING_SPARKS:
+    case TE_TUNNEL_SPARKS:
+        MSG_ReadByte();
+        MSG_ReadPos(pos);
+        MSG_ReadByte();
+        MSG_ReadByte();
+        break;
+
+    case TE_BLUEHYPERBLASTER:
+    case TE_RAILTRAIL:
+    case TE_BUBBLETRAIL:
+    case TE_DEBUGTRAIL:
+    case TE_BUBBLETRAIL2:
+    case TE_BFG_LASER:
+        MSG_ReadPos(pos);
+        MSG_ReadPos(pos);
+        break;
+
+    case TE_GRENADE_EXPLOSION:
+    case TE_GRENADE_EXPLOSION_WATER:
+    case TE_EXPLOSION2:
+    case TE_PLASMA_EXPLOSION:
+    case TE_ROCKET_EXPLOSION:
+    case TE_ROCKET_EXPLOSION_WATER:
+    case TE_EXPLOSION1:
+    case TE_EXPLOSION1_NP:
+    case TE_EXPLOSION1_BIG:
+    case TE_BFG_EXPLOSION:
+    case TE_BFG_BIGEXPLOSION:
+    case TE_BOSSTPORT:
+    case TE_PLAIN_EXPLOSION:
+    case TE_CHAINFIST_SMOKE:
+    case TE_TRACKER_EXPLOSION:
+    case TE_TELEPORT_EFFECT:
+    case TE_DBALL_GOAL:
+    case TE_WIDOWSPLASH:
+    case TE_NUKEBLAST:
+        MSG_ReadPos(pos);
+        break;
+
+    case TE_PARASITE_ATTACK:
+    case TE_MEDIC_CABLE_ATTACK:
+    case TE_HEATBEAM:
+    case TE_MONSTER_HEATBEAM:
+        MSG_ReadShort();
+        MSG_ReadPos(pos);
+        MSG_ReadPos(pos);
+        break;
+
+    case TE_GRAPPLE_CABLE:
+        MSG_ReadShort();
+        MSG_ReadPos(pos);
+        MSG_ReadPos(pos);
+        MSG_ReadPos(pos);
+        break;
+
+    case TE_LIGHTNING:
+        MSG_ReadShort();
+        MSG_ReadShort();
+        MSG_ReadPos(pos);
+        MSG_ReadPos(pos);
+        break;
+
+    case TE_FLASHLIGHT:
+        MSG_ReadPos(pos);
+        MSG_ReadShort();
+        break;
+
+    case TE_FORCEWALL:
+        MSG_ReadPos(pos);
+        MSG_ReadPos(pos);
+        MSG_ReadByte();
+        break;
+
+    case TE_STEAM:
+        entity = MSG_ReadShort();
+        MSG_ReadByte();
+        MSG_ReadPos(pos);
+        MSG_ReadByte();
+        MSG_ReadByte();
+        MSG_ReadShort();
+        if (entity != -1)
+            MSG_ReadLong();
+        break;
+
+    case TE_WIDOWBEAMOUT:
+        MSG_ReadShort();
+        MSG_ReadPos(pos);
+        break;
+
+    default:
+        SW_Dropf(cl, "%s: bad type", __func__);
+    }
+}
+
+static void parse_muzzleflash(sw_client_t *cl)
+{
+    int entity;
+
+    entity = MSG_ReadShort();
+    if (entity < 1 || entity >= MAX_EDICTS)
+        SW_Dropf(cl, "%s: bad entity", __func__);
+
+    MSG_ReadByte();
+}
+
+static void parse_sound(sw_client_t *cl)
+{
+    vec3_t  pos;
+    int     flags;
+
+    flags = MSG_ReadByte();
+    if ((flags & (SND_ENT | SND_POS)) == 0)
+        SW_Dropf(cl, "%s: neither SND_ENT nor SND_POS set", __func__);
+
+    MSG_ReadByte();     // sound index
+
+    if (flags & SND_VOLUME)
+        MSG_ReadByte();
+    if (flags & SND_ATTENUATION)
+        MSG_ReadByte();
+    if (flags & SND_OFFSET)
+        MSG_ReadByte();
+    if (flags & SND_ENT)
+        MSG_ReadShort();
+    if (flags & SND_POS)
+        MSG_ReadPos(pos);
+}
+
+/*
+=====================
+SW_ParseServerMessage
+=====================
+*/
+void SW_ParseServerMessage(sw_client_t *cl)
+{
+    int     i, cmd;
+
+    while (1) {
+        if (msg_read.readcount > msg_read.cursize)
+            SW_Dropf(cl, "%s: read past end of server message", __func__);
+
+        if ((cmd = MSG_ReadByte()) == -1)
+            break;
+
+        switch (cmd) {
+        default:
+            SW_Dropf(cl, "%s: illegible server message: %d", __func__, cmd);
+            break;
+
+        case svc_nop:
+            break;
+
+        case svc_disconnect:
+            SW_Dropf(cl, "Server disconnected");
+            break;
+
+        case svc_reconnect:
+            reconnect(cl);
+            break;
+
+        case svc_print:
+            MSG_ReadByte();
+            // fall through
+        case svc_centerprint:
+        case svc_layout:
+            MSG_ReadString(NULL, 0);
+            break;
+
+        case svc_stufftext:
+            parse_stufftext(cl);
+            break;
+
+        case svc_serverdata:
+            parse_serverdata(cl);
+            break;
+
+        case svc_configstring:
+            parse_configstring(cl);
+            break;
+
+        case svc_sound:
+            parse_sound(cl);
+            break;
+
+        case svc_spawnbaseline:
+            parse_baseline(cl);
+            break;
+
+        case svc_temp_entity:
+            parse_tent(cl);
+            break;
+
+        case svc_muzzleflash:
+        case svc_muzzleflash2:
+            parse_muzzleflash(cl);
+            break;
+
+        case svc_frame:
+            parse_frame(cl);
+            break;
+
+        case svc_inventory:
+            for (i = 0; i < MAX_ITEMS; i++)
+                MSG_ReadShort();
+            break;
+        }
+    }
+}
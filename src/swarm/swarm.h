@@ -0,0 +1,160 @@
+/*
+Copyright (C) 2003-2011 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include "shared/shared.h"
+
+#include "common/cmd.h"
+#include "common/cmodel.h"
+#include "common/common.h"
+#include "common/cvar.h"
+#include "common/msg.h"
+#include "common/net/chan.h"
+#include "common/net/net.h"
+#include "common/pmove.h"
+#include "common/protocol.h"
+#include "common/sizebuf.h"
+#include "common/zone.h"
+
+#include "server/server.h"
+#include "system/system.h"
+
+#include <setjmp.h>
+
+#define SW_Malloc(size)     Z_TagMalloc(size, TAG_GENERAL)
+#define SW_Mallocz(size)    Z_TagMallocz(size, TAG_GENERAL)
+
+#define SW_MAX_CLIENTS      256
+
+typedef enum {
+    sw_dead,            // dropped, waiting to be reconnected or freed
+    sw_challenging,     // sending getchallenge packets
+    sw_connecting,      // sending connect packets
+    sw_connected,       // netchan is up, receiving gamestate
+    sw_primed,          // sent begin, waiting for the first valid frame
+    sw_active           // receiving frames and sending moves
+} sw_state_t;
+
+typedef struct {
+    bool            valid;
+    int             number;
+    int             delta;
+    unsigned        firstEntity;
+    int             numEntities;
+    player_state_t  ps;
+} sw_frame_t;
+
+typedef struct {
+    unsigned    cmdNumber;
+    unsigned    sent;       // Sys_Milliseconds() when sent
+    bool        rcvd;
+} sw_history_t;
+
+typedef struct {
+    unsigned    frames;         // valid frames parsed
+    unsigned    lost;           // server frames never received
+    unsigned    invalid;        // frames with unusable delta
+    unsigned    messages;       // server packets parsed
+    uint64_t    bytes;
+    uint64_t    parse_us;       // time spent parsing messages
+    unsigned    parse_max;
+    uint64_t    predict_us;     // time spent in prediction
+    unsigned    predicts;
+    uint64_t    ping_sum;
+    unsigned    ping_count;
+    unsigned    ping_min;
+    unsigned    ping_max;
+    unsigned    drops;          // times dropped by server or timed out
+} sw_stats_t;
+
+typedef struct {
+    int         number;
+    sw_state_t  state;
+    char        name[16];
+    unsigned    retry_time;     // for connectionless packets and reconnects
+    int         retries;
+
+    qsocket_t   socket;
+    netchan_t   *netchan;
+    int         qport;
+    int         challenge;
+
+    int         servercount;
+    int         clientNum;
+    char        mapname[MAX_QPATH];
+    pmoveParams_t   pmp;
+
+    sw_frame_t      frames[UPDATE_BACKUP];
+    sw_frame_t      frame;      // last valid frame
+    int             serverframe;    // last frame number parsed
+    entity_state_t  *entityStates;  // MAX_PARSE_ENTITIES
+    unsigned        numEntityStates;
+    entity_state_t  *baselines;     // MAX_EDICTS
+
+    usercmd_t       cmds[CMD_BACKUP];
+    unsigned        cmdNumber;
+    unsigned        cmd_time;       // com_localTime of the last cmd
+    sw_history_t    history[CMD_BACKUP];
+
+    // scripted movement
+    float       yaw;
+    int         turning;
+    unsigned    stuck;
+    vec3_t      predicted_origin;
+    vec3_t      last_origin;
+
+    sw_stats_t  stats;
+} sw_client_t;
+
+typedef struct {
+    netadr_t        address;
+    sw_client_t     *clients[SW_MAX_CLIENTS];
+    int             numclients;
+    unsigned        connect_time;   // when the last client was spawned
+    int             pending;        // clients left to spawn
+
+    cm_t            cm;             // collision map for prediction
+    char            cm_name[MAX_QPATH];
+    bool            cm_failed;
+
+    uint64_t        start_us;
+} swarm_t;
+
+extern swarm_t      sw;
+extern jmp_buf      sw_jmpbuf;
+
+extern cvar_t   *sw_fps;
+extern cvar_t   *sw_script;
+extern cvar_t   *sw_predict;
+
+//
+// main.c
+//
+void SW_Dropf(sw_client_t *cl, const char *fmt, ...) q_noreturn q_printf(2, 3);
+void SW_ClientCommand(sw_client_t *cl, const char *s);
+
+//
+// parse.c
+//
+void SW_ParseServerMessage(sw_client_t *cl);
+
+//
+// move.c
+//
+void SW_ClearMove(sw_client_t *cl);
+void SW_SendCmd(sw_client_t *cl);
+void SW_FreeCollisionMap(void);
@@ -37,10 +37,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include <dirent.h>
 #include <dlfcn.h>
 #include <errno.h>
-
-#if USE_CLIENT
 #include <pthread.h>
-#endif
+#include <setjmp.h>
 
 #if USE_SDL
 #include <SDL.h>
@@ -62,12 +60,11 @@ ASYNC WORK QUEUE
 ===============================================================================
 */
 
-#if USE_CLIENT
-
 static bool work_initialized;
 static bool work_terminate;
 static pthread_mutex_t work_lock;
 static pthread_cond_t work_cond;
+static pthread_cond_t work_done_cond;
 static pthread_t work_thread;
 static asyncwork_t *pend_head;
 static asyncwork_t *done_head;
@@ -80,14 +77,11 @@ static void append_work(asyncwork_t **head, asyncwork_t *work)
     *p = work;
 }
 
-static void complete_work(void)
+// must be called with work_lock held
+static void run_done_work(void)
 {
     asyncwork_t *work, *next;
 
-    if (!work_initialized)
-        return;
-    if (pthread_mutex_trylock(&work_lock))
-        return;
     if (q_unlikely(done_head)) {
         for (work = done_head; work; work = next) {
             next = work->next;
@@ -97,6 +91,15 @@ static void complete_work(void)
         }
         done_head = NULL;
     }
+}
+
+static void complete_work(void)
+{
+    if (!work_initialized)
+        return;
+    if (pthread_mutex_trylock(&work_lock))
+        return;
+    run_done_work();
     pthread_mutex_unlock(&work_lock);
 }
 
@@ -117,6 +120,7 @@ static void *thread_func(void *arg)
         pthread_mutex_lock(&work_lock);
 
         append_work(&done_head, work);
+        pthread_cond_broadcast(&work_done_cond);
     }
     pthread_mutex_unlock(&work_lock);
 
@@ -138,6 +142,7 @@ static void shutdown_work(void)
 
     pthread_mutex_destroy(&work_lock);
     pthread_cond_destroy(&work_cond);
+    pthread_cond_destroy(&work_done_cond);
     work_initialized = false;
 }
 
@@ -146,6 +151,7 @@ void Sys_QueueAsyncWork(asyncwork_t *work)
     if (!work_initialized) {
         pthread_mutex_init(&work_lock, NULL);
         pthread_cond_init(&work_cond, NULL);
+        pthread_cond_init(&work_done_cond, NULL);
         if (pthread_create(&work_thread, NULL, thread_func, NULL))
             Sys_Error("Couldn't create async work thread");
         work_initialized = true;
@@ -157,10 +163,232 @@ void Sys_QueueAsyncWork(asyncwork_t *work)
     pthread_mutex_unlock(&work_lock);
 }
 
-#else
-#define shutdown_work() (void)0
-#define complete_work() (void)0
-#endif
+/*
+=================
+Sys_WaitAsyncWork
+
+Blocks until the given counter, decremented by completion callbacks of
+caller's work, drops to zero. Other work is not waited for.
+=================
+*/
+void Sys_WaitAsyncWork(const int *count)
+{
+    if (!work_initialized)
+        return;
+
+    pthread_mutex_lock(&work_lock);
+    run_done_work();
+    while (*count > 0) {
+        pthread_cond_wait(&work_done_cond, &work_lock);
+        run_done_work();
+    }
+    pthread_mutex_unlock(&work_lock);
+}
+
+/*
+===============================================================================
+
+PARALLEL LOOPS
+
+===============================================================================
+*/
+
+#define MAX_LOOP_THREADS    32
+
+static struct {
+    pthread_t       threads[MAX_LOOP_THREADS];
+    int             numthreads;
+    pthread_mutex_t lock;
+    pthread_cond_t  start_cond;
+    pthread_cond_t  done_cond;
+    unsigned        generation;
+    int             active;
+    bool            terminate;
+
+    void            (*func)(void *, int);
+    void            *arg;
+    int             count;
+    int             next;
+
+    // errors raised by func are caught here and rethrown by caller
+    pthread_t       caller;
+    bool            running;
+    jmp_buf         abort[MAX_LOOP_THREADS + 1];
+    bool            failed;
+    error_type_t    error_code;
+    char            error_msg[MAXERRORMSG];
+} loop;
+
+// number of threads that couldn't be started, not retried until changed
+static int loop_failed;
+
+static void run_loop_items(int slot)
+{
+    int i;
+
+    if (setjmp(loop.abort[slot]))
+        return;
+
+    while ((i = __atomic_fetch_add(&loop.next, 1, __ATOMIC_RELAXED)) < loop.count)
+        loop.func(loop.arg, i);
+}
+
+static void *loop_thread_func(void *arg)
+{
+    unsigned generation = 0;
+    int slot = (intptr_t)arg;
+
+    pthread_mutex_lock(&loop.lock);
+    while (1) {
+        while (loop.generation == generation && !loop.terminate)
+            pthread_cond_wait(&loop.start_cond, &loop.lock);
+        if (loop.terminate)
+            break;
+        generation = loop.generation;
+
+        pthread_mutex_unlock(&loop.lock);
+        run_loop_items(slot);
+        pthread_mutex_lock(&loop.lock);
+
+        if (!--loop.active)
+            pthread_cond_signal(&loop.done_cond);
+    }
+    pthread_mutex_unlock(&loop.lock);
+
+    return NULL;
+}
+
+static void shutdown_loop_threads(void)
+{
+    int i;
+
+    if (!loop.numthreads)
+        return;
+
+    pthread_mutex_lock(&loop.lock);
+    loop.terminate = true;
+    pthread_cond_broadcast(&loop.start_cond);
+    pthread_mutex_unlock(&loop.lock);
+
+    for (i = 0; i < loop.numthreads; i++)
+        pthread_join(loop.threads[i], NULL);
+
+    pthread_mutex_destroy(&loop.lock);
+    pthread_cond_destroy(&loop.start_cond);
+    pthread_cond_destroy(&loop.done_cond);
+    memset(&loop, 0, sizeof(loop));
+}
+
+static bool start_loop_threads(int numthreads)
+{
+    pthread_mutex_init(&loop.lock, NULL);
+    pthread_cond_init(&loop.start_cond, NULL);
+    pthread_cond_init(&loop.done_cond, NULL);
+
+    for (loop.numthreads = 0; loop.numthreads < numthreads; loop.numthreads++) {
+        if (pthread_create(&loop.threads[loop.numthreads], NULL, loop_thread_func,
+                           (void *)(intptr_t)loop.numthreads)) {
+            Com_EPrintf("Couldn't create worker thread\n");
+            shutdown_loop_threads();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+=================
+Sys_AbortParallelFor
+
+Called by Com_Error. If the calling thread is running items of a parallel
+loop, saves the error, stops the loop and jumps back to the loop so that
+Sys_ParallelFor can raise the error on the calling thread once all threads
+are done. Returns otherwise.
+=================
+*/
+void Sys_AbortParallelFor(error_type_t code, const char *msg)
+{
+    pthread_t self;
+    int slot;
+
+    if (!__atomic_load_n(&loop.running, __ATOMIC_ACQUIRE))
+        return;
+
+    self = pthread_self();
+    if (pthread_equal(self, loop.caller)) {
+        slot = loop.numthreads;
+    } else {
+        for (slot = 0; slot < loop.numthreads; slot++)
+            if (pthread_equal(self, loop.threads[slot]))
+                break;
+        if (slot == loop.numthreads)
+            return;
+    }
+
+    pthread_mutex_lock(&loop.lock);
+    if (!loop.failed) {
+        loop.failed = true;
+        loop.error_code = code;
+        Q_strlcpy(loop.error_msg, msg, sizeof(loop.error_msg));
+    }
+    pthread_mutex_unlock(&loop.lock);
+
+    __atomic_store_n(&loop.next, loop.count, __ATOMIC_RELAXED);
+    longjmp(loop.abort[slot], 1);
+}
+
+/*
+=================
+Sys_ParallelFor
+
+Calls func(arg, i) for each i in [0, count) using up to numthreads threads,
+including the calling one, and waits for all calls to complete. Worker
+threads are created on first use and kept around until the number of
+threads changes. Errors raised by func on any thread are rethrown on the
+calling thread after the loop is stopped.
+=================
+*/
+void Sys_ParallelFor(int numthreads, int count, void (*func)(void *, int), void *arg)
+{
+    int i;
+
+    numthreads = min(numthreads, MAX_LOOP_THREADS + 1) - 1;
+    if (numthreads > 0 && numthreads != loop.numthreads && numthreads != loop_failed) {
+        shutdown_loop_threads();
+        loop_failed = start_loop_threads(numthreads) ? 0 : numthreads;
+    }
+
+    if (numthreads <= 0 || !loop.numthreads || count < 2) {
+        for (i = 0; i < count; i++)
+            func(arg, i);
+        return;
+    }
+
+    pthread_mutex_lock(&loop.lock);
+    loop.func = func;
+    loop.arg = arg;
+    loop.count = count;
+    loop.next = 0;
+    loop.active = loop.numthreads;
+    loop.caller = pthread_self();
+    loop.failed = false;
+    __atomic_store_n(&loop.running, true, __ATOMIC_RELEASE);
+    loop.generation++;
+    pthread_cond_broadcast(&loop.start_cond);
+    pthread_mutex_unlock(&loop.lock);
+
+    run_loop_items(loop.numthreads);
+
+    pthread_mutex_lock(&loop.lock);
+    while (loop.active)
+        pthread_cond_wait(&loop.done_cond, &loop.lock);
+    __atomic_store_n(&loop.running, false, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&loop.lock);
+
+    if (loop.failed)
+        Com_Error(loop.error_code, "%s", loop.error_msg);
+}
 
 /*
 ===============================================================================
@@ -182,6 +410,13 @@ unsigned Sys_Milliseconds(void)
     return ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL;
 }
 
+uint64_t Sys_Microseconds(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
+}
+
 /*
 =================
 Sys_Quit
@@ -192,6 +427,7 @@ This function never returns.
 void Sys_Quit(void)
 {
     shutdown_work();
+    shutdown_loop_threads();
     tty_shutdown_input();
 #if USE_SDL
     SDL_Quit();
@@ -428,6 +664,18 @@ MISC
 ===============================================================================
 */
 
+/*
+=================
+Sys_ReplaceFile
+
+Atomically renames `from' to `to', replacing existing file.
+=================
+*/
+int Sys_ReplaceFile(const char *from, const char *to)
+{
+    return rename(from, to) ? Q_ERRNO : Q_ERR_SUCCESS;
+}
+
 /*
 =================
 Sys_ListFiles_r
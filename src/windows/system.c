@@ -796,12 +796,11 @@ ASYNC WORK QUEUE
 ===============================================================================
 */
 
-#if USE_CLIENT
-
 static bool work_initialized;
 static bool work_terminate;
 static CRITICAL_SECTION work_crit;
 static HANDLE work_event;
+static HANDLE work_done_event;
 static HANDLE work_thread;
 static asyncwork_t *pend_head;
 static asyncwork_t *done_head;
@@ -814,14 +813,11 @@ static void append_work(asyncwork_t **head, asyncwork_t *work)
     *p = work;
 }
 
-static void complete_work(void)
+// must be called with work_crit held
+static void run_done_work(void)
 {
     asyncwork_t *work, *next;
 
-    if (!work_initialized)
-        return;
-    if (!TryEnterCriticalSection(&work_crit))
-        return;
     if (q_unlikely(done_head)) {
         for (work = done_head; work; work = next) {
             next = work->next;
@@ -831,6 +827,15 @@ static void complete_work(void)
         }
         done_head = NULL;
     }
+}
+
+static void complete_work(void)
+{
+    if (!work_initialized)
+        return;
+    if (!TryEnterCriticalSection(&work_crit))
+        return;
+    run_done_work();
     LeaveCriticalSection(&work_crit);
 }
 
@@ -855,6 +860,7 @@ static DWORD WINAPI thread_func(LPVOID arg)
         EnterCriticalSection(&work_crit);
 
         append_work(&done_head, work);
+        SetEvent(work_done_event);
     }
     LeaveCriticalSection(&work_crit);
 
@@ -877,6 +883,7 @@ static void shutdown_work(void)
 
     DeleteCriticalSection(&work_crit);
     CloseHandle(work_event);
+    CloseHandle(work_done_event);
     CloseHandle(work_thread);
     work_initialized = false;
 }
@@ -888,6 +895,9 @@ void Sys_QueueAsyncWork(asyncwork_t *work)
         work_event = CreateEvent(NULL, FALSE, FALSE, NULL);
         if (!work_event)
             Sys_Error("Couldn't create async work event");
+        work_done_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (!work_done_event)
+            Sys_Error("Couldn't create async work event");
         work_thread = CreateThread(NULL, 0, thread_func, NULL, 0, NULL);
         if (!work_thread)
             Sys_Error("Couldn't create async work thread");
@@ -901,10 +911,234 @@ void Sys_QueueAsyncWork(asyncwork_t *work)
     SetEvent(work_event);
 }
 
-#else
-#define shutdown_work() (void)0
-#define complete_work() (void)0
-#endif
+/*
+=================
+Sys_WaitAsyncWork
+
+Blocks until the given counter, decremented by completion callbacks of
+caller's work, drops to zero. Other work is not waited for.
+=================
+*/
+void Sys_WaitAsyncWork(const int *count)
+{
+    if (!work_initialized)
+        return;
+
+    EnterCriticalSection(&work_crit);
+    run_done_work();
+    while (*count > 0) {
+        LeaveCriticalSection(&work_crit);
+        WaitForSingleObject(work_done_event, INFINITE);
+        EnterCriticalSection(&work_crit);
+        run_done_work();
+    }
+    LeaveCriticalSection(&work_crit);
+}
+
+/*
+===============================================================================
+
+PARALLEL LOOPS
+
+===============================================================================
+*/
+
+#define MAX_LOOP_THREADS    32
+
+static struct {
+    HANDLE          threads[MAX_LOOP_THREADS];
+    DWORD           thread_ids[MAX_LOOP_THREADS];
+    int             numthreads;
+    HANDLE          start_sem;
+    HANDLE          done_event;
+    volatile LONG   active;
+    volatile LONG   next;
+    bool            terminate;
+
+    void            (*func)(void *, int);
+    void            *arg;
+    int             count;
+
+    // errors raised by func are caught here and rethrown by caller
+    DWORD           caller;
+    volatile LONG   running;
+    volatile LONG   failed_lock;
+    jmp_buf         abort[MAX_LOOP_THREADS + 1];
+    bool            failed;
+    error_type_t    error_code;
+    char            error_msg[MAXERRORMSG];
+} loop;
+
+// number of threads that couldn't be started, not retried until changed
+static int loop_failed;
+
+static void run_loop_items(int slot)
+{
+    int i;
+
+    if (setjmp(loop.abort[slot]))
+        return;
+
+    while ((i = InterlockedIncrement(&loop.next) - 1) < loop.count)
+        loop.func(loop.arg, i);
+}
+
+static DWORD WINAPI loop_thread_func(LPVOID arg)
+{
+    int slot = (INT_PTR)arg;
+
+    while (1) {
+        if (WaitForSingleObject(loop.start_sem, INFINITE))
+            return 1;
+        if (loop.terminate)
+            break;
+
+        run_loop_items(slot);
+
+        if (!InterlockedDecrement(&loop.active))
+            SetEvent(loop.done_event);
+    }
+
+    return 0;
+}
+
+static void shutdown_loop_threads(void)
+{
+    int i;
+
+    if (!loop.numthreads)
+        return;
+
+    loop.terminate = true;
+    ReleaseSemaphore(loop.start_sem, loop.numthreads, NULL);
+
+    WaitForMultipleObjects(loop.numthreads, loop.threads, TRUE, INFINITE);
+    for (i = 0; i < loop.numthreads; i++)
+        CloseHandle(loop.threads[i]);
+
+    CloseHandle(loop.start_sem);
+    CloseHandle(loop.done_event);
+    memset(&loop, 0, sizeof(loop));
+}
+
+static bool start_loop_threads(int numthreads)
+{
+    loop.start_sem = CreateSemaphore(NULL, 0, MAX_LOOP_THREADS, NULL);
+    loop.done_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!loop.start_sem || !loop.done_event) {
+        Com_EPrintf("Couldn't create worker thread events\n");
+        goto fail;
+    }
+
+    for (loop.numthreads = 0; loop.numthreads < numthreads; loop.numthreads++) {
+        loop.threads[loop.numthreads] = CreateThread(NULL, 0, loop_thread_func,
+            (LPVOID)(INT_PTR)loop.numthreads, 0, &loop.thread_ids[loop.numthreads]);
+        if (!loop.threads[loop.numthreads]) {
+            Com_EPrintf("Couldn't create worker thread\n");
+            goto fail;
+        }
+    }
+
+    return true;
+
+fail:
+    if (loop.numthreads) {
+        shutdown_loop_threads();
+    } else {
+        if (loop.start_sem)
+            CloseHandle(loop.start_sem);
+        if (loop.done_event)
+            CloseHandle(loop.done_event);
+        memset(&loop, 0, sizeof(loop));
+    }
+    return false;
+}
+
+/*
+=================
+Sys_AbortParallelFor
+
+Called by Com_Error. If the calling thread is running items of a parallel
+loop, saves the error, stops the loop and jumps back to the loop so that
+Sys_ParallelFor can raise the error on the calling thread once all threads
+are done. Returns otherwise.
+=================
+*/
+void Sys_AbortParallelFor(error_type_t code, const char *msg)
+{
+    DWORD self;
+    int slot;
+
+    if (!InterlockedCompareExchange(&loop.running, 0, 0))
+        return;
+
+    self = GetCurrentThreadId();
+    if (self == loop.caller) {
+        slot = loop.numthreads;
+    } else {
+        for (slot = 0; slot < loop.numthreads; slot++)
+            if (self == loop.thread_ids[slot])
+                break;
+        if (slot == loop.numthreads)
+            return;
+    }
+
+    if (!InterlockedExchange(&loop.failed_lock, 1)) {
+        loop.failed = true;
+        loop.error_code = code;
+        Q_strlcpy(loop.error_msg, msg, sizeof(loop.error_msg));
+    }
+
+    InterlockedExchange(&loop.next, loop.count);
+    longjmp(loop.abort[slot], 1);
+}
+
+/*
+=================
+Sys_ParallelFor
+
+Calls func(arg, i) for each i in [0, count) using up to numthreads threads,
+including the calling one, and waits for all calls to complete. Worker
+threads are created on first use and kept around until the number of
+threads changes. Errors raised by func on any thread are rethrown on the
+calling thread after the loop is stopped.
+=================
+*/
+void Sys_ParallelFor(int numthreads, int count, void (*func)(void *, int), void *arg)
+{
+    int i;
+
+    numthreads = min(numthreads, MAX_LOOP_THREADS + 1) - 1;
+    if (numthreads > 0 && numthreads != loop.numthreads && numthreads != loop_failed) {
+        shutdown_loop_threads();
+        loop_failed = start_loop_threads(numthreads) ? 0 : numthreads;
+    }
+
+    if (numthreads <= 0 || !loop.numthreads || count < 2) {
+        for (i = 0; i < count; i++)
+            func(arg, i);
+        return;
+    }
+
+    loop.func = func;
+    loop.arg = arg;
+    loop.count = count;
+    loop.next = 0;
+    loop.active = loop.numthreads;
+    loop.caller = GetCurrentThreadId();
+    loop.failed = false;
+    loop.failed_lock = 0;
+    InterlockedExchange(&loop.running, 1);
+    ReleaseSemaphore(loop.start_sem, loop.numthreads, NULL);
+
+    run_loop_items(loop.numthreads);
+
+    WaitForSingleObject(loop.done_event, INFINITE);
+    InterlockedExchange(&loop.running, 0);
+
+    if (loop.failed)
+        Com_Error(loop.error_code, "%s", loop.error_msg);
+}
 
 /*
 ===============================================================================
@@ -992,6 +1226,7 @@ This function never returns.
 void Sys_Quit(void)
 {
     shutdown_work();
+    shutdown_loop_threads();
 
 #if USE_WINSVC
     if (statusHandle)
@@ -1013,6 +1248,16 @@ unsigned Sys_Milliseconds(void)
     return tm.QuadPart * 1000ULL / timer_freq.QuadPart;
 }
 
+uint64_t Sys_Microseconds(void)
+{
+    LARGE_INTEGER tm;
+    uint64_t sec, rem;
+    QueryPerformanceCounter(&tm);
+    sec = tm.QuadPart / timer_freq.QuadPart;
+    rem = tm.QuadPart % timer_freq.QuadPart;
+    return sec * 1000000ULL + rem * 1000000ULL / timer_freq.QuadPart;
+}
+
 void Sys_AddDefaultConfig(void)
 {
 }
@@ -1154,6 +1399,22 @@ FILESYSTEM
 ========================================================================
 */
 
+/*
+=================
+Sys_ReplaceFile
+
+Atomically renames `from' to `to', replacing existing file. Unlike rename(),
+doesn't fail if destination exists and never leaves it missing.
+=================
+*/
+int Sys_ReplaceFile(const char *from, const char *to)
+{
+    if (!MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        return Q_ERR_FAILURE;
+
+    return Q_ERR_SUCCESS;
+}
+
 /*
 =================
 Sys_ListFiles_r